@@ -15,6 +15,9 @@
 #ifndef _ABSTRACTPOLYLIST_H_
 #include "collision/abstractPolyList.h"
 #endif
+#ifndef _POLYLISTARENA_H_
+#include "collision/polyListArena.h"
+#endif
 
 
 #define CLIPPEDPOLYLIST_FLAG_ALLOWCLIPPING		0x01
@@ -49,10 +52,10 @@ public:
 
     static bool allowClipping;
 
-    typedef Vector<PlaneF> PlaneList;
-    typedef Vector<Vertex> VertexList;
-    typedef Vector<Poly> PolyList;
-    typedef Vector<U32> IndexList;
+    typedef PolyListVector<PlaneF> PlaneList;
+    typedef PolyListVector<Vertex> VertexList;
+    typedef PolyListVector<Poly> PolyList;
+    typedef PolyListVector<U32> IndexList;
 
     // Internal data
     PolyList   mPolyList;
@@ -9,6 +9,9 @@
 #ifndef _ABSTRACTPOLYLIST_H_
 #include "collision/abstractPolyList.h"
 #endif
+#ifndef _POLYLISTARENA_H_
+#include "collision/polyListArena.h"
+#endif
 
 /// A concrete, renderable PolyList
 ///
@@ -30,10 +33,10 @@ public:
         U32 surfaceKey;
     };
 
-    typedef Vector<PlaneF> PlaneList;
-    typedef Vector<Point3F> VertexList;
-    typedef Vector<Poly>   PolyList;
-    typedef Vector<U32>    IndexList;
+    typedef PolyListVector<PlaneF>  PlaneList;
+    typedef PolyListVector<Point3F> VertexList;
+    typedef PolyListVector<Poly>    PolyList;
+    typedef PolyListVector<U32>     IndexList;
 
     PolyList   mPolyList;
     VertexList mVertexList;
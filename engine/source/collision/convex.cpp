@@ -9,14 +9,31 @@
 #include "sim/sceneObject.h"
 #include "collision/convex.h"
 #include "collision/gjk.h"
+#include "core/threadPool.h"
+#include "console/console.h"
 
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 
-static DataChunker sChunker;
+/// Free lists of one thread.  Lists freed on another thread than they were
+/// allocated on simply move to that thread's free list, so the chunkers are
+/// never released.
+struct ConvexFreeLists
+{
+    DataChunker chunker;
+    CollisionStateList stateList;
+    CollisionWorkingList workingList;
+};
+
+static thread_local ConvexFreeLists* sgFreeLists = NULL;
+
+static ConvexFreeLists* getFreeLists()
+{
+    if (sgFreeLists == NULL)
+        sgFreeLists = new ConvexFreeLists;
+    return sgFreeLists;
+}
 
-CollisionStateList CollisionStateList::sFreeList;
-CollisionWorkingList CollisionWorkingList::sFreeList;
 F32 sqrDistanceEdges(const Point3F& start0,
     const Point3F& end0,
     const Point3F& start1,
@@ -231,19 +248,20 @@ void CollisionStateList::unlink()
 
 CollisionStateList* CollisionStateList::alloc()
 {
-    if (!sFreeList.isEmpty()) {
-        CollisionStateList* nxt = sFreeList.mNext;
+    ConvexFreeLists* lists = getFreeLists();
+    if (!lists->stateList.isEmpty()) {
+        CollisionStateList* nxt = lists->stateList.mNext;
         nxt->unlink();
         nxt->mState = NULL;
         return nxt;
     }
-    return constructInPlace((CollisionStateList*)sChunker.alloc(sizeof(CollisionStateList)));
+    return constructInPlace((CollisionStateList*)lists->chunker.alloc(sizeof(CollisionStateList)));
 }
 
 void CollisionStateList::free()
 {
     unlink();
-    linkAfter(&sFreeList);
+    linkAfter(&getFreeLists()->stateList);
 }
 
 
@@ -284,18 +302,19 @@ void CollisionWorkingList::unlink()
 
 CollisionWorkingList* CollisionWorkingList::alloc()
 {
-    if (sFreeList.wLink.mNext != &sFreeList) {
-        CollisionWorkingList* nxt = sFreeList.wLink.mNext;
+    ConvexFreeLists* lists = getFreeLists();
+    if (lists->workingList.wLink.mNext != &lists->workingList) {
+        CollisionWorkingList* nxt = lists->workingList.wLink.mNext;
         nxt->unlink();
         return nxt;
     }
-    return constructInPlace((CollisionWorkingList*)sChunker.alloc(sizeof(CollisionWorkingList)));
+    return constructInPlace((CollisionWorkingList*)lists->chunker.alloc(sizeof(CollisionWorkingList)));
 }
 
 void CollisionWorkingList::free()
 {
     unlink();
-    wLinkAfter(&sFreeList);
+    wLinkAfter(&getFreeLists()->workingList);
 }
 
 
@@ -304,6 +323,7 @@ void CollisionWorkingList::free()
 //----------------------------------------------------------------------------
 
 U32 Convex::sTag = (U32)-1;
+S32 Convex::smParallelNarrowphase = 8;
 
 //----------------------------------------------------------------------------
 
@@ -504,41 +524,98 @@ void Convex::updateStateList(const MatrixF& mat, const Point3F& scale, const Poi
 
 //----------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------
+// Narrowphase
+//
+// The GJK distance and feature collision of a state only read the two
+// convexes and write the state itself, so the states of a query are
+// gathered on the calling thread and resolved on the thread pool.  The
+// results are reduced in state list order afterwards, which gives the same
+// answer as resolving them one after the other.
+
+/// Returns true if a query over @a count states should use the thread pool.
+static bool useParallelNarrowphase(const U32 count)
+{
+    if (ThreadPool::get() == NULL || Convex::smParallelNarrowphase <= 0)
+        return false;
+
+    return count >= U32(Convex::smParallelNarrowphase);
+}
+
+struct ClosestStateJob
+{
+    MatrixF axform;
+    MatrixF axforminv;
+    F32 dontCareDist;
+
+    struct Item
+    {
+        CollisionState* state;
+        MatrixF bxform;
+        MatrixF bxforminv;
+        F32 dist;
+    };
+    Vector<Item> items;
+
+    static void run(U32 index, void* data)
+    {
+        ClosestStateJob* job = static_cast<ClosestStateJob*>(data);
+        Item& item = job->items[index];
+        item.dist = item.state->distance(job->axform, item.bxform, job->dontCareDist, &job->axforminv, &item.bxforminv);
+    }
+};
+
 CollisionState* Convex::findClosestState(const MatrixF& mat, const Point3F& scale, const F32 dontCareDist)
 {
     updateStateList(mat, scale);
     F32 dist = +1E30;
     CollisionState* st = 0;
 
+    // Kept per thread so the item storage is reused between queries
+    static thread_local ClosestStateJob job;
+    job.items.clear();
+    job.dontCareDist = dontCareDist;
+
     // Prepare scaled version of transform
-    MatrixF axform = mat;
-    axform.scale(scale);
-    MatrixF axforminv(true);
+    job.axform = mat;
+    job.axform.scale(scale);
+    job.axforminv.identity();
     MatrixF temp(mat);
-    axforminv.scale(Point3F(1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z));
+    job.axforminv.scale(Point3F(1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z));
     temp.affineInverse();
-    axforminv.mul(temp);
+    job.axforminv.mul(temp);
 
     for (CollisionStateList* itr = mList.mNext; itr != &mList; itr = itr->mNext) {
         CollisionState* state = itr->mState;
         if (state->mLista != itr)
             state->swap();
 
+        job.items.increment();
+        ClosestStateJob::Item& item = job.items.last();
+        item.state = state;
+
         // Prepare scaled version of transform
-        MatrixF bxform = state->b->getTransform();
-        temp = bxform;
+        item.bxform = state->b->getTransform();
+        temp = item.bxform;
         Point3F bscale = state->b->getScale();
-        bxform.scale(bscale);
-        MatrixF bxforminv(true);
-        bxforminv.scale(Point3F(1.0f / bscale.x, 1.0f / bscale.y, 1.0f / bscale.z));
+        item.bxform.scale(bscale);
+        item.bxforminv.identity();
+        item.bxforminv.scale(Point3F(1.0f / bscale.x, 1.0f / bscale.y, 1.0f / bscale.z));
         temp.affineInverse();
-        bxforminv.mul(temp);
+        item.bxforminv.mul(temp);
+    }
 
-        //
-        F32 dd = state->distance(axform, bxform, dontCareDist, &axforminv, &bxforminv);
+    if (useParallelNarrowphase(job.items.size()))
+        ThreadPool::get()->parallelFor(job.items.size(), ClosestStateJob::run, &job);
+    else
+        for (U32 i = 0; i < job.items.size(); i++)
+            ClosestStateJob::run(i, &job);
+
+    for (U32 i = 0; i < job.items.size(); i++) {
+        F32 dd = job.items[i].dist;
         if (dd < dist) {
             dist = dd;
-            st = state;
+            st = job.items[i].state;
         }
     }
     if (dist < dontCareDist)
@@ -550,8 +627,53 @@ CollisionState* Convex::findClosestState(const MatrixF& mat, const Point3F& scal
 
 //----------------------------------------------------------------------------
 
+struct CollisionInfoJob
+{
+    Convex* convex;
+    MatrixF omat;
+    MatrixF imat;
+    F32 tol;
+
+    struct Item
+    {
+        CollisionState* state;
+        CollisionList list;
+    };
+    Vector<Item> items;
+
+    static void run(U32 index, void* data)
+    {
+        CollisionInfoJob* job = static_cast<CollisionInfoJob*>(data);
+        Item& item = job->items[index];
+        CollisionState* state = item.state;
+
+        ConvexFeature fa, fb;
+        VectorF v;
+
+        job->imat.mulV(-state->v, &v);
+        job->convex->getFeatures(job->omat, v, &fa);
+
+        MatrixF imat = state->b->getTransform();
+        imat.scale(state->b->getScale());
+
+        MatrixF bxform = imat;
+        imat.inverse();
+        imat.mulV(state->v, &v);
+
+        state->b->getFeatures(bxform, v, &fb);
+
+        item.list.count = 0;
+        fa.collide(fb, &item.list, job->tol);
+    }
+};
+
 bool Convex::getCollisionInfo(const MatrixF& mat, const Point3F& scale, CollisionList* cList, F32 tol)
 {
+    static thread_local CollisionInfoJob job;
+    job.items.clear();
+    job.convex = this;
+    job.tol = tol;
+
     for (CollisionStateList* itr = mList.mNext;
         itr != &mList;
         itr = itr->mNext)
@@ -564,33 +686,36 @@ bool Convex::getCollisionInfo(const MatrixF& mat, const Point3F& scale, Collisio
 
         if (state->dist <= tol)
         {
-            ConvexFeature fa, fb;
-            VectorF v;
-
-            // The idea is that we need to scale the matrix, so we need to
-            // make a copy of it, before we can pass it in to getFeatures.
-            // This is used to scale us for comparison against the other
-            // convex, which is correctly scaled.
-            MatrixF omat = mat;
-            omat.scale(scale);
-
-            MatrixF imat = omat;
-            imat.inverse();
-            imat.mulV(-state->v, &v);
+            job.items.increment();
+            job.items.last().state = state;
+        }
+    }
 
-            getFeatures(omat, v, &fa);
+    if (job.items.empty())
+        return (cList->count != 0);
 
-            imat = state->b->getTransform();
-            imat.scale(state->b->getScale());
+    // The idea is that we need to scale the matrix, so we need to
+    // make a copy of it, before we can pass it in to getFeatures.
+    // This is used to scale us for comparison against the other
+    // convex, which is correctly scaled.
+    job.omat = mat;
+    job.omat.scale(scale);
 
-            MatrixF bxform = imat;
-            imat.inverse();
-            imat.mulV(state->v, &v);
+    job.imat = job.omat;
+    job.imat.inverse();
 
-            state->b->getFeatures(bxform, v, &fb);
+    if (useParallelNarrowphase(job.items.size()))
+        ThreadPool::get()->parallelFor(job.items.size(), CollisionInfoJob::run, &job);
+    else
+        for (U32 i = 0; i < job.items.size(); i++)
+            CollisionInfoJob::run(i, &job);
 
-            fa.collide(fb, cList, tol);
-        }
+    // Merge in state order, up to what the list holds.
+    for (U32 i = 0; i < job.items.size(); i++)
+    {
+        const CollisionList& list = job.items[i].list;
+        for (S32 j = 0; j < list.count && cList->count < CollisionList::MaxCollisions; j++)
+            cList->collision[cList->count++] = list.collision[j];
     }
 
     return (cList->count != 0);
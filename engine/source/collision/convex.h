@@ -94,9 +94,10 @@ struct CollisionState
 
 //----------------------------------------------------------------------------
 
+/// Collision state lists and working lists are kept on per-thread free lists,
+/// so they can be allocated and freed from any thread without locking.
 struct CollisionStateList
 {
-    static CollisionStateList sFreeList;
     CollisionStateList* mNext;
     CollisionStateList* mPrev;
     CollisionState* mState;
@@ -116,7 +117,6 @@ struct CollisionStateList
 
 struct CollisionWorkingList
 {
-    static CollisionWorkingList sFreeList;
     struct WLink {
         CollisionWorkingList* mNext;
         CollisionWorkingList* mPrev;
@@ -170,6 +170,10 @@ protected:
 
 public:
 
+    /// Minimum number of collision states a query hands to the thread
+    /// pool, 0 keeps the narrowphase serial.  $pref::Physics::parallelNarrowphase
+    static S32 smParallelNarrowphase;
+
     /// Constructor
     Convex();
 
@@ -202,7 +206,9 @@ public:
     /// Returns the list of objects currently inside the bounds of this Convex
     CollisionWorkingList& getWorkingList() { return mWorking; }
 
-    /// Finds the closest
+    /// Finds the closest collision state.  The GJK distances of the states are
+    /// run on the thread pool when there are enough of them, see
+    /// $pref::Physics::parallelNarrowphase.
     CollisionState* findClosestState(const MatrixF& mat, const Point3F& scale, const F32 dontCareDist = 1);
 
     /// Returns the list of objects this object is testing against
@@ -248,7 +254,9 @@ public:
     /// @param   list   (Out) Poly list built
     virtual void getPolyList(AbstractPolyList* list);
 
-    ///
+    /// Collects the contacts with every state within @a tol.  The states are
+    /// resolved in parallel like in findClosestState(), and their contacts
+    /// are added to @a cList in state list order.
     bool getCollisionInfo(const MatrixF& mat, const Point3F& scale, CollisionList* cList, F32 tol);
 };
 
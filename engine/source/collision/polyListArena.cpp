@@ -0,0 +1,182 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "collision/polyListArena.h"
+#include "platform/platformMutex.h"
+#include "console/console.h"
+
+#include <atomic>
+
+PolyListArena*         PolyListArena::smArenaList = NULL;
+void*                  PolyListArena::smArenaListMutex = NULL;
+PolyListArena::Stats   PolyListArena::smLastTickStats = { 0, 0, 0, 0 };
+PolyListArena::Stats   PolyListArena::smTotalStats = { 0, 0, 0, 0 };
+
+static thread_local PolyListArena* sgThreadArena = NULL;
+
+struct PolyListArena::Counters
+{
+    std::atomic<U32> lists;
+    std::atomic<U32> reused;
+    std::atomic<U32> heapAllocs;
+    std::atomic<U32> retainedBytes;   ///< Not per tick, kept up to date by the owner.
+};
+
+PolyListArena::PolyListArena()
+{
+    mNumBuffers = 0;
+    mNextArena = NULL;
+
+    mTickCounters = new Counters;
+    mTickCounters->lists = 0;
+    mTickCounters->reused = 0;
+    mTickCounters->heapAllocs = 0;
+    mTickCounters->retainedBytes = 0;
+}
+
+PolyListArena::~PolyListArena()
+{
+    for (U32 i = 0; i < mNumBuffers; i++)
+        dFree(mBuffers[i].array);
+    mNumBuffers = 0;
+
+    delete mTickCounters;
+}
+
+PolyListArena* PolyListArena::get()
+{
+    // Not set up yet or already torn down, static lists end up here.
+    if (smArenaListMutex == NULL)
+        return NULL;
+
+    if (sgThreadArena == NULL)
+    {
+        sgThreadArena = new PolyListArena;
+
+        Mutex::lockMutex(smArenaListMutex);
+        sgThreadArena->mNextArena = smArenaList;
+        smArenaList = sgThreadArena;
+        Mutex::unlockMutex(smArenaListMutex);
+    }
+
+    return sgThreadArena;
+}
+
+void PolyListArena::init()
+{
+    AssertFatal(smArenaListMutex == NULL, "PolyListArena::init - already initialized.");
+    smArenaListMutex = Mutex::createMutex();
+}
+
+void PolyListArena::destroy()
+{
+    PolyListArena* walk = smArenaList;
+    while (walk)
+    {
+        PolyListArena* next = walk->mNextArena;
+        delete walk;
+        walk = next;
+    }
+    smArenaList = NULL;
+    sgThreadArena = NULL;
+
+    if (smArenaListMutex)
+    {
+        Mutex::destroyMutex(smArenaListMutex);
+        smArenaListMutex = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void* PolyListArena::acquire(U32& bytes)
+{
+    bytes = 0;
+
+    PolyListArena* arena = get();
+    if (arena == NULL)
+        return NULL;
+
+    arena->mTickCounters->lists.fetch_add(1, std::memory_order_relaxed);
+    if (arena->mNumBuffers == 0)
+        return NULL;
+
+    arena->mTickCounters->reused.fetch_add(1, std::memory_order_relaxed);
+    Buffer& buffer = arena->mBuffers[--arena->mNumBuffers];
+    bytes = buffer.bytes;
+    arena->mTickCounters->retainedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    return buffer.array;
+}
+
+void PolyListArena::release(void* array, const U32 bytes, const U32 acquiredBytes)
+{
+    PolyListArena* arena = get();
+    if (arena && bytes > acquiredBytes)
+        arena->mTickCounters->heapAllocs.fetch_add(1, std::memory_order_relaxed);
+
+    if (array == NULL)
+        return;
+
+    if (arena == NULL || arena->mNumBuffers == MaxRetained)
+    {
+        dFree(array);
+        return;
+    }
+
+    Buffer& buffer = arena->mBuffers[arena->mNumBuffers++];
+    buffer.array = array;
+    buffer.bytes = bytes;
+    arena->mTickCounters->retainedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void PolyListArena::noteHeapAlloc()
+{
+    PolyListArena* arena = get();
+    if (arena)
+        arena->mTickCounters->heapAllocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PolyListArena::endTick()
+{
+    Stats stats;
+    stats.clear();
+
+    if (smArenaListMutex == NULL)
+        return;
+
+    MutexHandle handle;
+    handle.lock(smArenaListMutex);
+    for (PolyListArena* walk = smArenaList; walk; walk = walk->mNextArena)
+    {
+        // Other threads may be counting right now, only their counters
+        // are safe to touch from here.
+        Counters* counters = walk->mTickCounters;
+        stats.lists += counters->lists.exchange(0, std::memory_order_relaxed);
+        stats.reused += counters->reused.exchange(0, std::memory_order_relaxed);
+        stats.heapAllocs += counters->heapAllocs.exchange(0, std::memory_order_relaxed);
+        stats.retainedBytes += counters->retainedBytes.load(std::memory_order_relaxed);
+    }
+
+    smLastTickStats = stats;
+    smTotalStats.lists += stats.lists;
+    smTotalStats.reused += stats.reused;
+    smTotalStats.heapAllocs += stats.heapAllocs;
+    smTotalStats.retainedBytes = stats.retainedBytes;
+}
+
+//-----------------------------------------------------------------------------
+
+ConsoleFunction(getPolyListArenaStats, const char*, 1, 2, "getPolyListArenaStats([bool total]);"
+    "Returns \"lists reused heapAllocs retainedBytes\" for the poly lists built during the last "
+    "server tick, or since startup if total is set. heapAllocs should be 0 once the collision "
+    "queries have reached a steady state.")
+{
+    const PolyListArena::Stats& stats = (argc > 1 && dAtob(argv[1])) ?
+        PolyListArena::getTotalStats() : PolyListArena::getLastTickStats();
+
+    char* ret = Con::getReturnBuffer(128);
+    dSprintf(ret, 128, "%d %d %d %d", stats.lists, stats.reused, stats.heapAllocs, stats.retainedBytes);
+    return ret;
+}
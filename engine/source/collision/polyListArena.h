@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _POLYLISTARENA_H_
+#define _POLYLISTARENA_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/tVector.h"
+#endif
+
+/// Per thread store for the buffers of the poly lists built by collision queries.
+///
+/// Most poly lists live on the stack of a collision query, so every query used
+/// to allocate its vertex, index, poly and plane arrays and grow them a block at
+/// a time.  A PolyListVector takes its buffer from the arena of the calling
+/// thread when it is constructed and hands it back, at whatever size it grew to,
+/// when it is destructed.  Buffers are kept at their high water mark, so once
+/// the queries of a scene have run a few times they do no heap work at all.
+///
+/// Buffers are handed out last in, first out.  Queries build their lists in the
+/// same order every time, so each list tends to get back the buffer it grew.
+class PolyListArena
+{
+public:
+    enum
+    {
+        MaxRetained = 64,   ///< Buffers kept per thread, any more are freed.
+    };
+
+    /// Counters, collected per server tick.
+    struct Stats
+    {
+        U32 lists;          ///< Poly list buffers taken from the arenas.
+        U32 reused;         ///< Ones that came with retained memory.
+        U32 heapAllocs;     ///< Buffers that had to be allocated or grown on the heap.
+        U32 retainedBytes;  ///< Memory held by the arenas.
+
+        void clear() { lists = reused = heapAllocs = retainedBytes = 0; }
+    };
+
+private:
+    struct Buffer
+    {
+        void* array;
+        U32   bytes;
+    };
+
+    Buffer mBuffers[MaxRetained];
+    U32    mNumBuffers;
+
+    /// Counters for the tick in progress.  The owning thread bumps them while
+    /// endTick() reads and clears them from the server thread.
+    struct Counters;
+    Counters* mTickCounters;
+
+    PolyListArena* mNextArena;
+
+    static PolyListArena* smArenaList;
+    static void*          smArenaListMutex;
+    static Stats          smLastTickStats;
+    static Stats          smTotalStats;
+
+    PolyListArena();
+    ~PolyListArena();
+
+    /// Returns the arena of the calling thread, or NULL outside of init() and
+    /// destroy().  Lists built outside of that just use the heap.
+    static PolyListArena* get();
+
+public:
+    /// Sets up the arena bookkeeping.
+    static void init();
+
+    /// Frees every per-thread arena and the buffers they retain.  Only valid
+    /// at shutdown.
+    static void destroy();
+
+    /// Hands out a retained buffer, or none.  @a bytes is its size.
+    static void* acquire(U32& bytes);
+
+    /// Takes a buffer back.  @a acquiredBytes is what it was handed out with,
+    /// the buffer grew on the heap if it is bigger now.
+    static void release(void* array, const U32 bytes, const U32 acquiredBytes);
+
+    /// Counts a buffer that was grown on the heap while still in use.
+    static void noteHeapAlloc();
+
+    /// Latches the counters of all threads as the stats of the tick that just
+    /// finished.  Called by the server process list after every tick.
+    static void endTick();
+
+    static const Stats& getLastTickStats() { return smLastTickStats; }
+    static const Stats& getTotalStats() { return smTotalStats; }
+};
+
+//-----------------------------------------------------------------------------
+
+/// Vector whose storage comes from, and goes back to, the PolyListArena of the
+/// calling thread.  Apart from that it is a plain Vector.
+template<class T>
+class PolyListVector : public Vector<T>
+{
+    U32 mAcquiredBytes;     ///< Buffer size when it was last accounted for.
+
+public:
+    PolyListVector()
+    {
+        this->mArray = static_cast<T*>(PolyListArena::acquire(mAcquiredBytes));
+        this->mArraySize = mAcquiredBytes / sizeof(T);
+    }
+
+    PolyListVector(const PolyListVector& p) : Vector<T>(p)
+    {
+        mAcquiredBytes = this->mArraySize * sizeof(T);
+    }
+
+    ~PolyListVector()
+    {
+        PolyListArena::release(this->mArray, this->mArraySize * sizeof(T), mAcquiredBytes);
+        this->mArray = NULL;
+        this->mArraySize = 0;
+        this->mElementCount = 0;
+    }
+
+    PolyListVector& operator=(const Vector<T>& p)
+    {
+        Vector<T>::operator=(p);
+        return *this;
+    }
+
+    PolyListVector& operator=(const PolyListVector& p)
+    {
+        Vector<T>::operator=(p);
+        return *this;
+    }
+
+    /// Same as Vector::clear(), lists that are kept around and cleared for
+    /// every query are accounted for here.
+    void clear()
+    {
+        U32 bytes = this->mArraySize * sizeof(T);
+        if (bytes > mAcquiredBytes)
+        {
+            PolyListArena::noteHeapAlloc();
+            mAcquiredBytes = bytes;
+        }
+        this->mElementCount = 0;
+    }
+};
+
+#endif // _POLYLISTARENA_H_
@@ -143,7 +143,7 @@ decl_list
    :
       { $$ = nil; }
    | decl_list decl
-      { if(!statementList) { statementList = $2; } else { statementList->append($2); } }
+      { StmtNode*& list = Compiler::getContext().statementList; if(!list) { list = $2; } else { list->append($2); } }
    ;
    
 decl
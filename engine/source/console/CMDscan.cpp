@@ -2071,7 +2071,9 @@ int CMDGetCurrentLine()
 
 void CMDerror(char *, ...)
 {
-   gSyntaxError = true;
+   getContext().syntaxError = true;
+   if(!canReport())
+      return;
    if(fileName)
       Con::errorf(ConsoleLogEntry::Script, "%s Line: %d - Syntax error.",
          fileName, lineIndex);
@@ -450,7 +450,6 @@ struct FunctionDeclStmtNode : StmtNode
     void setPackage(StringTableEntry packageName);
 };
 
-extern StmtNode* statementList;
 extern void createFunction(const char* fnName, VarNode* args, StmtNode* statements);
 extern ExprEvalState gEvalState;
 extern bool lookupFunction(const char* fnName, VarNode** args, StmtNode** statements);
@@ -52,20 +52,22 @@ using namespace Compiler;
 void StmtNode::addBreakCount()
 {
 #ifndef TORQUE_EXTRA_BREAKLINES      
-    if (CodeBlock::smInFunction)
+    if (getContext().inFunction)
 #endif
-        CodeBlock::smBreakLineCount++;
+        getContext().breakLineCount++;
 }
 
 void StmtNode::addBreakLine(U32 ip)
 {
+    CompilerContext& context = getContext();
+
 #ifndef TORQUE_EXTRA_BREAKLINES      
-    if (CodeBlock::smInFunction)
+    if (context.inFunction)
     {
 #endif
 
-        U32 line = CodeBlock::smBreakLineCount * 2;
-        CodeBlock::smBreakLineCount++;
+        U32 line = context.breakLineCount * 2;
+        context.breakLineCount++;
 
         if (getBreakCodeBlock()->lineBreakPairs)
         {
@@ -83,8 +85,8 @@ void StmtNode::addBreakLine(U32 ip)
 StmtNode::StmtNode()
 {
     next = NULL;
-    dbgFileName = CodeBlock::smCurrentParser->getCurrentFile();
-    dbgLineNumber = CodeBlock::smCurrentParser->getCurrentLine();
+    dbgFileName = getContext().parser->getCurrentFile();
+    dbgLineNumber = getContext().parser->getCurrentLine();
 }
 
 void StmtNode::setPackage(StringTableEntry)
@@ -161,7 +163,8 @@ U32 BreakStmtNode::precompileStmt(U32 loopCount)
         addBreakCount();
         return 2;
     }
-    Con::warnf(ConsoleLogEntry::General, "%s (%d): break outside of loop... ignoring.", dbgFileName, dbgLineNumber);
+    if (canReport())
+        Con::warnf(ConsoleLogEntry::General, "%s (%d): break outside of loop... ignoring.", dbgFileName, dbgLineNumber);
     return 0;
 }
 
@@ -185,7 +188,8 @@ U32 ContinueStmtNode::precompileStmt(U32 loopCount)
         addBreakCount();
         return 2;
     }
-    Con::warnf(ConsoleLogEntry::General, "%s (%d): continue outside of loop... ignoring.", dbgFileName, dbgLineNumber);
+    if (canReport())
+        Con::warnf(ConsoleLogEntry::General, "%s (%d): continue outside of loop... ignoring.", dbgFileName, dbgLineNumber);
     return 0;
 }
 
@@ -682,7 +686,7 @@ U32 CommaCatExprNode::compile(dsize_t* codeStream, U32 ip, TypeReq type)
     // At this point the stack has the concatenated string.
 
     // But we're paranoid, so accept (but whine) if we get an oddity...
-    if (type == TypeReqUInt || type == TypeReqFloat)
+    if ((type == TypeReqUInt || type == TypeReqFloat) && canReport())
         Con::warnf(ConsoleLogEntry::General, "%s (%d): converting comma string to a number... probably wrong.", dbgFileName, dbgLineNumber);
     if (type == TypeReqUInt)
         codeStream[ip++] = OP_STR_TO_UINT;
@@ -1628,7 +1632,7 @@ U32 FunctionDeclStmtNode::precompileStmt(U32)
     for (VarNode* walk = args; walk; walk = (VarNode*)((StmtNode*)walk)->getNext())
         argc++;
 
-    CodeBlock::smInFunction = true;
+    getContext().inFunction = true;
 
     precompileIdent(fnName);
     precompileIdent(nameSpace);
@@ -1640,7 +1644,7 @@ U32 FunctionDeclStmtNode::precompileStmt(U32)
     addBreakCount();
 #endif
 
-    CodeBlock::smInFunction = false;
+    getContext().inFunction = false;
 
     setCurrentStringTable(&getGlobalStringTable());
     setCurrentFloatTable(&getGlobalFloatTable());
@@ -1667,14 +1671,14 @@ U32 FunctionDeclStmtNode::compileStmt(dsize_t* codeStream, U32 ip, U32, U32)
         codeStream[ip] = STEtoU32(walk->varName, ip);
         ip++;
     }
-    CodeBlock::smInFunction = true;
+    getContext().inFunction = true;
     ip = compileBlock(stmts, codeStream, ip, 0, 0);
 
 #ifdef TORQUE_EXTRA_BREAKLINES      
     addBreakLine(ip);
 #endif
 
-    CodeBlock::smInFunction = false;
+    getContext().inFunction = false;
     codeStream[ip++] = OP_RETURN;
     return ip;
 }
\ No newline at end of file
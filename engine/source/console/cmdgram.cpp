@@ -1395,7 +1395,7 @@ case 2:
     break;}
 case 3:
 #line 146 "cmdgram.y"
-{ if(!statementList) { statementList = yyvsp[0].stmt; } else { statementList->append(yyvsp[0].stmt); } ;
+{ StmtNode*& list = Compiler::getContext().statementList; if(!list) { list = yyvsp[0].stmt; } else { list->append(yyvsp[0].stmt); } ;
     break;}
 case 4:
 #line 151 "cmdgram.y"
@@ -8,14 +8,18 @@
 #include "console/telnetDebugger.h"
 #include "core/resManager.h"
 #include "core/unicode.h"
+#include "core/bitStream.h"
+#include "core/memstream.h"
+#include "core/crc.h"
+#include "core/tDictionary.h"
+#include "core/fileStream.h"
+#include "core/threadPool.h"
+#include "platform/platformMutex.h"
 
 using namespace Compiler;
 
-bool           CodeBlock::smInFunction = false;
-U32            CodeBlock::smBreakLineCount = 0;
 CodeBlock* CodeBlock::smCodeBlockList = NULL;
 CodeBlock* CodeBlock::smCurrentCodeBlock = NULL;
-ConsoleParser* CodeBlock::smCurrentParser = NULL;
 
 //-------------------------------------------------------------------------
 
@@ -404,110 +408,440 @@ bool CodeBlock::compile(const char* codeFileName, StringTableEntry fileName, con
     return false;
 #endif
 
+    // Compile first so a syntax error doesn't leave an empty DSO behind.
+    InfiniteBitStream image;
+    if (!compileToStream(image, fileName, inScript))
+        return false;
+
+    Stream* st;
+    if (!ResourceManager->openFileForWrite(st, codeFileName))
+        return false;
+    st->write(image.getPosition(), image.getBuffer());
+    delete st;
+
+    return true;
+}
+
+namespace
+{
+    /// Held around the parser while CodeBlock::precompileScripts() compiles on
+    /// several threads.  The scanner and parser are generated with global state,
+    /// so only one thread parses at a time and the rest of the compile runs in
+    /// each thread's own compiler context.  NULL the rest of the time.
+    void* gParseMutex = NULL;
+
+    /// Parses a script into the statement list of @a context.
+    void parseScript(CompilerContext& context, const char* script, StringTableEntry fileName)
+    {
+        MutexHandle handle;
+        if (gParseMutex)
+            handle.lock(gParseMutex);
+
+        // Set up the parser.
+        context.parser = getParserForFile(fileName);
+        AssertISV(context.parser, avar("CodeBlock::compile - no parser available for '%s'!", fileName));
+
+        // Now do some parsing.
+        context.parser->setScanBuffer(script, fileName);
+        context.parser->restart(NULL);
+        context.parser->parse();
+    }
+}
+
+bool CodeBlock::compileToStream(Stream& st, StringTableEntry fileName, const char* inScript)
+{
     // This will return true, but return value is ignored
     char* script;
     chompUTF8BOM(inScript, &script);
 
-    gSyntaxError = false;
+    CompilerContext& context = getContext();
+    context.syntaxError = false;
 
     consoleAllocReset();
 
-    STEtoU32 = compileSTEtoU32;
+    context.steToU32 = compileSTEtoU32;
 
-    statementList = NULL;
+    context.statementList = NULL;
 
-    // Set up the parser.
-    smCurrentParser = getParserForFile(fileName);
-    AssertISV(smCurrentParser, avar("CodeBlock::compile - no parser available for '%s'!", fileName));
+    parseScript(context, script, fileName);
 
-    // Now do some parsing.
-    smCurrentParser->setScanBuffer(script, fileName);
-    smCurrentParser->restart(NULL);
-    smCurrentParser->parse();
-
-    if (gSyntaxError)
+    if (context.syntaxError)
     {
         consoleAllocReset();
         return false;
     }
 
-    Stream* st;
-    if (!ResourceManager->openFileForWrite(st, codeFileName))
-        return false;
-    st->write(U32(Con::DSOVersion));
+    st.write(U32(Con::DSOVersion));
 
     // Reset all our value tables...
     resetTables();
 
-    smInFunction = false;
-    smBreakLineCount = 0;
+    context.inFunction = false;
+    context.breakLineCount = 0;
     setBreakCodeBlock(this);
 
+    StmtNode* statementList = context.statementList;
     if (statementList)
         codeSize = precompileBlock(statementList, 0) + 1;
     else
         codeSize = 1;
 
-    lineBreakPairCount = smBreakLineCount;
-    code = new dsize_t[codeSize + smBreakLineCount * 2];
+    lineBreakPairCount = context.breakLineCount;
+    code = new dsize_t[codeSize + lineBreakPairCount * 2];
 
     lineBreakPairs = code + codeSize;
 
     // Write string table data...
-    getGlobalStringTable().write(*st);
-    getFunctionStringTable().write(*st);
+    getGlobalStringTable().write(st);
+    getFunctionStringTable().write(st);
 
     // Write float table data...
-    getGlobalFloatTable().write(*st);
-    getFunctionFloatTable().write(*st);
+    getGlobalFloatTable().write(st);
+    getFunctionFloatTable().write(st);
 
-    smBreakLineCount = 0;
+    context.breakLineCount = 0;
     U32 lastIp;
     if (statementList)
         lastIp = compileBlock(statementList, code, 0, 0, 0);
     else
         lastIp = 0;
 
-    if (lastIp != codeSize - 1)
+    if (lastIp != codeSize - 1 && canReport())
         Con::errorf(ConsoleLogEntry::General, "CodeBlock::compile - precompile size mismatch, a precompile/compile function pair is probably mismatched.");
 
     code[lastIp++] = OP_RETURN;
-    U32 totSize = codeSize + smBreakLineCount * 2;
-    st->write(codeSize);
-    st->write(lineBreakPairCount);
+    U32 totSize = codeSize + context.breakLineCount * 2;
+    st.write(codeSize);
+    st.write(lineBreakPairCount);
 
     // Write out our bytecode, doing a bit of compression for low numbers.
     U32 i;
     for (i = 0; i < codeSize; i++)
     {
         if (code[i] < 0xFF)
-            st->write(U8(code[i]));
+            st.write(U8(code[i]));
         else
         {
-            st->write(U8(0xFF));
-            st->write((U32)code[i]);
+            st.write(U8(0xFF));
+            st.write((U32)code[i]);
         }
     }
 
     // Write the break info...
     for (i = codeSize; i < totSize; i++)
-        st->write((U32)code[i]);
+        st.write((U32)code[i]);
 
-    getIdentTable().write(*st);
+    getIdentTable().write(st);
 
     consoleAllocReset();
-    delete st;
 
     return true;
 }
 
-const char* CodeBlock::compileExec(StringTableEntry fileName, const char* inString, bool noCalls, int setFrame)
+//-------------------------------------------------------------------------
+
+namespace
+{
+    /// Compiled code of a script exec() ran, see CodeBlock::openCompiledScript().
+    struct CompiledScript
+    {
+        U32 scriptCRC;
+        U32 size;
+        U8* data;
+    };
+
+    HashTable<StringTableEntry, CompiledScript> gCompiledScripts;
+    U32 gCompiledScriptBytes = 0;
+    U32 gCompiledScriptHits = 0;
+    U32 gCompiledScriptCompiles = 0;
+
+    /// Keeps @a data, allocated with dMalloc(), as the code of a script.
+    void storeCompiledScript(StringTableEntry fileName, U32 scriptCRC, U32 size, U8* data)
+    {
+        HashTable<StringTableEntry, CompiledScript>::Iterator itr = gCompiledScripts.find(fileName);
+        if (itr == gCompiledScripts.end())
+            itr = gCompiledScripts.insertUnique(fileName, CompiledScript());
+        else
+        {
+            gCompiledScriptBytes -= itr->value.size;
+            dFree(itr->value.data);
+        }
+
+        CompiledScript& compiledScript = itr->value;
+        compiledScript.scriptCRC = scriptCRC;
+        compiledScript.size = size;
+        compiledScript.data = data;
+
+        gCompiledScriptBytes += size;
+    }
+
+    /// Compiles a script into memory allocated with dMalloc().
+    U8* compileScript(StringTableEntry fileName, const char* script, U32& size)
+    {
+        InfiniteBitStream image;
+        CodeBlock* code = new CodeBlock();
+        bool compiled = code->compileToStream(image, fileName, script);
+        delete code;
+        if (!compiled)
+            return NULL;
+
+        size = image.getPosition();
+        U8* data = (U8*)dMalloc(size);
+        dMemcpy(data, image.getBuffer(), size);
+        return data;
+    }
+
+    /// A script CodeBlock::precompileScripts() compiles on the thread pool.
+    struct ScriptJob
+    {
+        StringTableEntry fileName;
+        char* script;
+        U32   scriptCRC;
+        U32   size;
+        U8* data;
+    };
+
+    void compileScriptJob(U32 index, void* data)
+    {
+        ScriptJob& job = static_cast<ScriptJob*>(data)[index];
+
+        // The console isn't thread safe, so only count the warnings and
+        // errors, and leave scripts that have any to exec().
+        CompilerContext& context = getContext();
+        context.quiet = true;
+        context.messageCount = 0;
+
+        job.data = compileScript(job.fileName, job.script, job.size);
+        if (job.data && context.messageCount)
+        {
+            dFree(job.data);
+            job.data = NULL;
+        }
+
+        context.quiet = false;
+    }
+
+    /// Identifies an index file written by CodeBlock::saveCompiledScripts().
+    const U32 CompiledScriptIndexTag = 0x49435354;   // 'TSCI'
+}
+
+Stream* CodeBlock::openCompiledScript(StringTableEntry fileName, const char* script, U32 scriptSize)
+{
+    U32 crc = calculateCRC(script, scriptSize);
+
+    HashTable<StringTableEntry, CompiledScript>::Iterator itr = gCompiledScripts.find(fileName);
+    if (itr != gCompiledScripts.end() && itr->value.scriptCRC == crc)
+    {
+        gCompiledScriptHits++;
+    }
+    else
+    {
+        Con::printf("Compiling %s...", fileName);
+
+        U32 size;
+        U8* data = compileScript(fileName, script, size);
+        if (!data)
+            return NULL;
+
+        storeCompiledScript(fileName, crc, size, data);
+        gCompiledScriptCompiles++;
+        itr = gCompiledScripts.find(fileName);
+    }
+
+    return new MemStream(itr->value.size, itr->value.data, true, false);
+}
+
+void CodeBlock::clearCompiledScripts()
+{
+    for (HashTable<StringTableEntry, CompiledScript>::Iterator itr = gCompiledScripts.begin(); itr != gCompiledScripts.end(); ++itr)
+        dFree(itr->value.data);
+    gCompiledScripts.clear();
+    gCompiledScriptBytes = 0;
+}
+
+bool CodeBlock::hasCompiledScript(StringTableEntry fileName)
+{
+    return gCompiledScripts.find(fileName) != gCompiledScripts.end();
+}
+
+U32 CodeBlock::precompileScripts(const char* pattern)
+{
+    // Read the scripts here, the resource manager isn't thread safe.
+    Vector<ScriptJob> jobs;
+    const char* fn;
+    for (ResourceObject* obj = ResourceManager->findMatch(pattern, &fn, NULL); obj; obj = ResourceManager->findMatch(pattern, &fn, obj))
+    {
+        StringTableEntry fileName = StringTable->insert(fn);
+        Stream* s = ResourceManager->openStream(obj);
+        if (!s)
+            continue;
+
+        U32 scriptSize = ResourceManager->getSize(fileName);
+        char* script = new char[scriptSize + 1];
+        s->read(scriptSize, script);
+        ResourceManager->closeStream(s);
+        script[scriptSize] = 0;
+
+        U32 crc = calculateCRC(script, scriptSize);
+        HashTable<StringTableEntry, CompiledScript>::Iterator itr = gCompiledScripts.find(fileName);
+        if (itr != gCompiledScripts.end() && itr->value.scriptCRC == crc)
+        {
+            delete[] script;
+            continue;
+        }
+
+        ScriptJob job;
+        job.fileName = fileName;
+        job.script = script;
+        job.scriptCRC = crc;
+        job.size = 0;
+        job.data = NULL;
+        jobs.push_back(job);
+    }
+
+    StringTable->setThreadSafe(true);
+    gParseMutex = Mutex::createMutex();
+    if (ThreadPool::get())
+        ThreadPool::get()->parallelFor(jobs.size(), compileScriptJob, jobs.address());
+    else
+        for (U32 i = 0; i < jobs.size(); i++)
+            compileScriptJob(i, jobs.address());
+    Mutex::destroyMutex(gParseMutex);
+    gParseMutex = NULL;
+    StringTable->setThreadSafe(false);
+
+    U32 compiled = 0;
+    for (U32 i = 0; i < jobs.size(); i++)
+    {
+        ScriptJob& job = jobs[i];
+        if (job.data)
+        {
+            storeCompiledScript(job.fileName, job.scriptCRC, job.size, job.data);
+            gCompiledScriptCompiles++;
+            compiled++;
+        }
+        delete[] job.script;
+    }
+
+    Con::printf("Precompiled %d of %d changed scripts matching %s.", compiled, jobs.size(), pattern);
+    return compiled;
+}
+
+bool CodeBlock::loadCompiledScripts(const char* indexFileName)
+{
+    FileStream st;
+    if (!st.open(indexFileName, FileStream::Read))
+        return false;
+
+    U32 tag, version, count;
+    st.read(&tag);
+    st.read(&version);
+    st.read(&count);
+    if (tag != CompiledScriptIndexTag || version != Con::DSOVersion)
+        return false;
+
+    char fileName[256];
+    while (count-- && st.getStatus() == Stream::Ok)
+    {
+        U32 scriptCRC, size;
+        st.readString(fileName);
+        st.read(&scriptCRC);
+        if (!st.read(&size) || size == 0 || size > st.getStreamSize() - st.getPosition())
+            return false;
+
+        U8* data = (U8*)dMalloc(size);
+        if (!st.read(size, data))
+        {
+            dFree(data);
+            return false;
+        }
+        storeCompiledScript(StringTable->insert(fileName), scriptCRC, size, data);
+    }
+    return true;
+}
+
+bool CodeBlock::saveCompiledScripts(const char* indexFileName)
+{
+    Stream* st;
+    if (!ResourceManager->openFileForWrite(st, indexFileName))
+        return false;
+
+    st->write(CompiledScriptIndexTag);
+    st->write(U32(Con::DSOVersion));
+    st->write(U32(gCompiledScripts.size()));
+    for (HashTable<StringTableEntry, CompiledScript>::Iterator itr = gCompiledScripts.begin(); itr != gCompiledScripts.end(); ++itr)
+    {
+        st->writeString(itr->key);
+        st->write(itr->value.scriptCRC);
+        st->write(itr->value.size);
+        st->write(itr->value.size, itr->value.data);
+    }
+
+    bool ok = st->getStatus() == Stream::Ok;
+    delete st;
+    return ok;
+}
+
+ConsoleFunction(getCompiledScriptStats, const char*, 1, 1, "getCompiledScriptStats();"
+    "Returns \"scripts bytes hits compiles\" for the compiled code exec() keeps of the scripts "
+    "it ran, so running an unchanged script again skips compiling it.")
+{
+    char* ret = Con::getReturnBuffer(128);
+    dSprintf(ret, 128, "%d %d %d %d", gCompiledScripts.size(), gCompiledScriptBytes, gCompiledScriptHits, gCompiledScriptCompiles);
+    return ret;
+}
+
+ConsoleFunction(clearCompiledScripts, void, 1, 1, "clearCompiledScripts();"
+    "Drops the compiled code exec() keeps of the scripts it ran.")
+{
+    CodeBlock::clearCompiledScripts();
+}
+
+ConsoleFunction(precompileScripts, S32, 2, 2, "precompileScripts(pattern);"
+    "Compiles the scripts matching the pattern on all cores, so exec() finds their code "
+    "instead of compiling them one by one.  Returns the number of scripts compiled.")
+{
+    argc;
+    char pattern[1024];
+    Con::expandScriptFilename(pattern, sizeof(pattern), argv[1]);
+    return CodeBlock::precompileScripts(pattern);
+}
+
+ConsoleFunction(loadCompiledScripts, bool, 2, 2, "loadCompiledScripts(relativeFileName);"
+    "Reads the script CRC index saveCompiledScripts() wrote to the prefs folder.")
+{
+    argc;
+    const char* fileName = Platform::getPrefsPath(argv[1]);
+    if (fileName == NULL || *fileName == 0)
+        return false;
+    return CodeBlock::loadCompiledScripts(fileName);
+}
+
+ConsoleFunction(saveCompiledScripts, bool, 2, 2, "saveCompiledScripts(relativeFileName);"
+    "Writes the CRC and compiled code of every script exec() keeps to a single index file "
+    "in the prefs folder, so the next run only compiles the scripts that changed.")
+{
+    argc;
+    const char* fileName = Platform::getPrefsPath(argv[1]);
+    if (fileName == NULL || *fileName == 0)
+        return false;
+
+    gAllowExternalWrite = true;
+    bool ok = CodeBlock::saveCompiledScripts(fileName);
+    gAllowExternalWrite = false;
+    return ok;
+}
+
+bool CodeBlock::compileCode(StringTableEntry fileName, const char* inString)
 {
     // Check for a UTF8 script file
     char* string;
     chompUTF8BOM(inString, &string);
 
-    STEtoU32 = evalSTEtoU32;
+    CompilerContext& context = getContext();
+    context.syntaxError = false;
+
+    context.steToU32 = evalSTEtoU32;
     consoleAllocReset();
 
     name = fileName;
@@ -515,32 +849,23 @@ const char* CodeBlock::compileExec(StringTableEntry fileName, const char* inStri
     if (name)
         addToCodeList();
 
-    statementList = NULL;
-
-    // Set up the parser.
-    smCurrentParser = getParserForFile(fileName);
-    AssertISV(smCurrentParser, avar("CodeBlock::compile - no parser available for '%s'!", fileName));
+    context.statementList = NULL;
 
-    // Now do some parsing.
-    smCurrentParser->setScanBuffer(string, fileName);
-    smCurrentParser->restart(NULL);
-    smCurrentParser->parse();
+    parseScript(context, string, fileName);
 
+    StmtNode* statementList = context.statementList;
     if (!statementList)
-    {
-        delete this;
-        return "";
-    }
+        return false;
 
     resetTables();
 
-    smInFunction = false;
-    smBreakLineCount = 0;
+    context.inFunction = false;
+    context.breakLineCount = 0;
     setBreakCodeBlock(this);
 
     codeSize = precompileBlock(statementList, 0) + 1;
 
-    lineBreakPairCount = smBreakLineCount;
+    lineBreakPairCount = context.breakLineCount;
 
     globalStrings = getGlobalStringTable().build();
     functionStrings = getFunctionStringTable().build();
@@ -551,7 +876,7 @@ const char* CodeBlock::compileExec(StringTableEntry fileName, const char* inStri
 
     lineBreakPairs = code + codeSize;
 
-    smBreakLineCount = 0;
+    context.breakLineCount = 0;
     U32 lastIp = compileBlock(statementList, code, 0, 0, 0);
     code[lastIp++] = OP_RETURN;
 
@@ -563,6 +888,17 @@ const char* CodeBlock::compileExec(StringTableEntry fileName, const char* inStri
     if (lastIp != codeSize)
         Con::warnf(ConsoleLogEntry::General, "precompile size mismatch");
 
+    return true;
+}
+
+const char* CodeBlock::compileExec(StringTableEntry fileName, const char* inString, bool noCalls, int setFrame)
+{
+    if (!compileCode(fileName, inString))
+    {
+        delete this;
+        return "";
+    }
+
     return exec(0, fileName, NULL, 0, 0, noCalls, NULL, setFrame);
 }
 
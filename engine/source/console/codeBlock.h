@@ -21,10 +21,6 @@ private:
     static CodeBlock* smCurrentCodeBlock;
 
 public:
-    static U32                       smBreakLineCount;
-    static bool                      smInFunction;
-    static Compiler::ConsoleParser* smCurrentParser;
-
     static CodeBlock* getCurrentBlock()
     {
         return smCurrentCodeBlock;
@@ -85,6 +81,36 @@ public:
     bool read(StringTableEntry fileName, Stream& st);
     bool compile(const char* dsoName, StringTableEntry fileName, const char* script);
 
+    /// Compiles a script into the DSO format, returns false on a syntax error.
+    bool compileToStream(Stream& st, StringTableEntry fileName, const char* script);
+
+    /// Returns a stream over the compiled code of a script, like a DSO opened
+    /// with the resource manager.  The code is kept in memory and the script is
+    /// only compiled again once it changed.  Returns NULL on a syntax error.
+    static Stream* openCompiledScript(StringTableEntry fileName, const char* script, U32 scriptSize);
+
+    /// Drops the code openCompiledScript() kept.
+    static void clearCompiledScripts();
+
+    /// Returns true if openCompiledScript() kept code for the script, current
+    /// or not.  exec() checks the CRC of such scripts instead of file times.
+    static bool hasCompiledScript(StringTableEntry fileName);
+
+    /// Compiles every script matching @a pattern that openCompiledScript()
+    /// has no current code for, spread over the thread pool, so the exec()s
+    /// that follow don't compile them one by one.  Scripts with warnings or
+    /// errors are left for exec() to compile, which reports them as usual.
+    /// Returns the number of scripts compiled.
+    static U32 precompileScripts(const char* pattern);
+
+    /// Reads the CRC and code of every script in an index file written by
+    /// saveCompiledScripts() into openCompiledScript()'s cache.
+    static bool loadCompiledScripts(const char* indexFileName);
+
+    /// Writes openCompiledScript()'s cache to a single index file, so a later
+    /// run only compiles the scripts whose CRC changed.
+    static bool saveCompiledScripts(const char* indexFileName);
+
     void incRefCount();
     void decRefCount();
 
@@ -106,6 +132,11 @@ public:
     const char* compileExec(StringTableEntry fileName, const char* script,
         bool noCalls, int setFrame = -1);
 
+    /// Compiles a block of script into this CodeBlock, like compileExec()
+    /// without running it.  Returns false if it has no executable statements,
+    /// and leaves the compiler context's syntaxError set if it had errors.
+    bool compileCode(StringTableEntry fileName, const char* script);
+
     /// Executes the existing code in the CodeBlock. The return string is any 
     /// result of the code executed, if any, or an empty string.
     ///
@@ -33,7 +33,8 @@ namespace Compiler
             return 0;
         else if (file)
         {
-            Con::warnf(ConsoleLogEntry::General, "%s (%d): string always evaluates to 0.", file, line);
+            if (canReport())
+                Con::warnf(ConsoleLogEntry::General, "%s (%d): string always evaluates to 0.", file, line);
             return 0;
         }
         return 0;
@@ -41,17 +42,43 @@ namespace Compiler
 
     //------------------------------------------------------------
 
-    CompilerStringTable* gCurrentStringTable, gGlobalStringTable, gFunctionStringTable;
-    CompilerFloatTable* gCurrentFloatTable, gGlobalFloatTable, gFunctionFloatTable;
-    DataChunker          gConsoleAllocator;
-    CompilerIdentTable   gIdentTable;
-    CodeBlock* gCurBreakBlock;
+    CompilerContext::CompilerContext()
+    {
+        globalStringTable.reset();
+        functionStringTable.reset();
+        globalFloatTable.reset();
+        functionFloatTable.reset();
+        identTable.reset();
+        currentStringTable = &globalStringTable;
+        currentFloatTable = &globalFloatTable;
+
+        statementList = NULL;
+        parser = NULL;
+        breakBlock = NULL;
+        breakLineCount = 0;
+        inFunction = false;
+        syntaxError = false;
+        steToU32 = evalSTEtoU32;
+        quiet = false;
+        messageCount = 0;
+    }
 
-    //------------------------------------------------------------
+    static thread_local CompilerContext gContext;
 
+    CompilerContext& getContext() { return gContext; }
 
-    CodeBlock* getBreakCodeBlock() { return gCurBreakBlock; }
-    void setBreakCodeBlock(CodeBlock* cb) { gCurBreakBlock = cb; }
+    bool canReport()
+    {
+        if (!gContext.quiet)
+            return true;
+        gContext.messageCount++;
+        return false;
+    }
+
+    //------------------------------------------------------------
+
+    CodeBlock* getBreakCodeBlock() { return gContext.breakBlock; }
+    void setBreakCodeBlock(CodeBlock* cb) { gContext.breakBlock = cb; }
 
     //------------------------------------------------------------
 
@@ -67,38 +94,34 @@ namespace Compiler
         return 0;
     }
 
-    dsize_t(*STEtoU32)(StringTableEntry ste, U32 ip) = evalSTEtoU32;
-
-    //------------------------------------------------------------
-
-    bool gSyntaxError = false;
+    dsize_t STEtoU32(StringTableEntry ste, U32 ip) { return gContext.steToU32(ste, ip); }
 
     //------------------------------------------------------------
 
-    CompilerStringTable* getCurrentStringTable() { return gCurrentStringTable; }
-    CompilerStringTable& getGlobalStringTable() { return gGlobalStringTable; }
-    CompilerStringTable& getFunctionStringTable() { return gFunctionStringTable; }
+    CompilerStringTable* getCurrentStringTable() { return gContext.currentStringTable; }
+    CompilerStringTable& getGlobalStringTable() { return gContext.globalStringTable; }
+    CompilerStringTable& getFunctionStringTable() { return gContext.functionStringTable; }
 
-    void setCurrentStringTable(CompilerStringTable* cst) { gCurrentStringTable = cst; }
+    void setCurrentStringTable(CompilerStringTable* cst) { gContext.currentStringTable = cst; }
 
-    CompilerFloatTable* getCurrentFloatTable() { return gCurrentFloatTable; }
-    CompilerFloatTable& getGlobalFloatTable() { return gGlobalFloatTable; }
-    CompilerFloatTable& getFunctionFloatTable() { return gFunctionFloatTable; }
+    CompilerFloatTable* getCurrentFloatTable() { return gContext.currentFloatTable; }
+    CompilerFloatTable& getGlobalFloatTable() { return gContext.globalFloatTable; }
+    CompilerFloatTable& getFunctionFloatTable() { return gContext.functionFloatTable; }
 
-    void setCurrentFloatTable(CompilerFloatTable* cst) { gCurrentFloatTable = cst; }
+    void setCurrentFloatTable(CompilerFloatTable* cst) { gContext.currentFloatTable = cst; }
 
-    CompilerIdentTable& getIdentTable() { return gIdentTable; }
+    CompilerIdentTable& getIdentTable() { return gContext.identTable; }
 
     void precompileIdent(StringTableEntry ident)
     {
         if (ident)
-            gGlobalStringTable.add(ident);
+            getGlobalStringTable().add(ident);
     }
 
     void resetTables()
     {
-        setCurrentStringTable(&gGlobalStringTable);
-        setCurrentFloatTable(&gGlobalFloatTable);
+        setCurrentStringTable(&getGlobalStringTable());
+        setCurrentFloatTable(&getGlobalFloatTable());
         getGlobalFloatTable().reset();
         getGlobalStringTable().reset();
         getFunctionFloatTable().reset();
@@ -106,8 +129,12 @@ namespace Compiler
         getIdentTable().reset();
     }
 
-    void* consoleAlloc(U32 size) { return gConsoleAllocator.alloc(size); }
-    void consoleAllocReset() { gConsoleAllocator.freeBlocks(); }
+    /// Blocks of AST and table memory kept between compiles, 1MB.  Scripts
+    /// and evals smaller than that don't go to the heap once warmed up.
+    static const S32 MaxKeptAllocatorBlocks = 64;
+
+    void* consoleAlloc(U32 size) { return gContext.allocator.alloc(size); }
+    void consoleAllocReset() { gContext.allocator.reset(MaxKeptAllocatorBlocks); }
 
 }
 
@@ -151,6 +178,11 @@ U32 CompilerStringTable::add(const char* str, bool caseSens, bool tag)
     newStr->string = (char*)consoleAlloc(len);
     newStr->len = len;
     newStr->tag = tag;
+
+    // Clear the room left for the tag, so the compiled code doesn't depend
+    // on what the allocator had there before.
+    if (tag)
+        dMemset(newStr->string, 0, len);
     dStrcpy(newStr->string, str);
     return newStr->start;
 }
@@ -232,7 +264,7 @@ void CompilerIdentTable::reset()
 
 void CompilerIdentTable::add(StringTableEntry ste, U32 ip)
 {
-    U32 index = gGlobalStringTable.add(ste, false);
+    U32 index = getGlobalStringTable().add(ste, false);
     Entry* newEntry = (Entry*)consoleAlloc(sizeof(Entry));
     newEntry->offset = index;
     newEntry->ip = ip;
@@ -8,9 +8,9 @@
 #define _COMPILER_H_
 
 class Stream;
-class DataChunker;
 
 #include "platform/platform.h"
+#include "core/dataChunker.h"
 #include "console/ast.h"
 #include "console/codeBlock.h"
 
@@ -198,11 +198,65 @@ namespace Compiler
         return *((StringTableEntry*)&u);
     }
 
-    extern dsize_t(*STEtoU32)(StringTableEntry ste, U32 ip);
-
     dsize_t evalSTEtoU32(StringTableEntry ste, U32);
     dsize_t compileSTEtoU32(StringTableEntry ste, U32 ip);
 
+    /// Calls evalSTEtoU32() or compileSTEtoU32(), whichever the current
+    /// compile set in CompilerContext::steToU32.
+    dsize_t STEtoU32(StringTableEntry ste, U32 ip);
+
+    //------------------------------------------------------------
+
+    struct ConsoleParser;
+
+    /// Everything a single compile works on: the parsed script, the value
+    /// tables and the memory they live in.  Each thread has its own context,
+    /// so scripts can be compiled on several threads at once as long as the
+    /// StringTable is thread safe and only one of them parses at a time, see
+    /// CodeBlock::precompileScripts().
+    struct CompilerContext
+    {
+        CompilerStringTable* currentStringTable;
+        CompilerStringTable  globalStringTable;
+        CompilerStringTable  functionStringTable;
+
+        CompilerFloatTable* currentFloatTable;
+        CompilerFloatTable  globalFloatTable;
+        CompilerFloatTable  functionFloatTable;
+
+        CompilerIdentTable   identTable;
+
+        /// Holds the AST and the table entries, reset after every compile.
+        DataChunker          allocator;
+
+        /// Root of the parsed script, appended to by the parser.
+        StmtNode* statementList;
+
+        ConsoleParser* parser;
+        CodeBlock* breakBlock;
+        U32        breakLineCount;
+        bool       inFunction;
+        bool       syntaxError;
+
+        dsize_t(*steToU32)(StringTableEntry ste, U32 ip);
+
+        /// While set, warnings and errors are counted in messageCount instead
+        /// of printed, see canReport().
+        bool quiet;
+        U32  messageCount;
+
+        CompilerContext();
+    };
+
+    /// Returns the calling thread's compiler context.
+    CompilerContext& getContext();
+
+    /// Returns true if a warning or error should be printed to the console.
+    /// Quiet contexts count it instead, since they don't run on the main thread.
+    bool canReport();
+
+    //------------------------------------------------------------
+
     CompilerStringTable* getCurrentStringTable();
     CompilerStringTable& getGlobalStringTable();
     CompilerStringTable& getFunctionStringTable();
@@ -228,8 +282,6 @@ namespace Compiler
 
     void* consoleAlloc(U32 size);
     void consoleAllocReset();
-
-    extern bool gSyntaxError;
 };
 
 #endif
\ No newline at end of file
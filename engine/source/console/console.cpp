@@ -16,6 +16,7 @@
 #include "console/simBase.h"
 #include "console/compiler.h"
 #include "console/stringStack.h"
+#include "core/crc.h"
 #include <stdarg.h>
 #include "platform/platformMutex.h"
 
@@ -23,7 +24,6 @@
 extern StringStack STR;
 
 ExprEvalState gEvalState;
-StmtNode* statementList;
 ConsoleConstructor* ConsoleConstructor::first = NULL;
 bool gWarnUndefinedScriptVariables;
 
@@ -275,13 +275,17 @@ namespace Con
 
     //--------------------------------------
 
+    static void clearEvalCache();
+
     void shutdown()
     {
         AssertFatal(active == true, "Con::shutdown should only be called once.");
         active = false;
 
         consoleLogFile.close();
+        clearEvalCache();
         Namespace::shutdown();
+        CodeBlock::clearCompiledScripts();
 
 #ifdef TORQUE_MULTITHREAD
         Mutex::unlockMutex(mainThreadMutex);
@@ -916,16 +920,122 @@ namespace Con
     }
 
 
+    //------------------------------------------------------------------------------
+    // CodeBlocks of recently evaluated strings, so evaluating the same string
+    // again runs its code without parsing it.  Only strings without a file
+    // name are kept, those don't get breakpoints or a place in the code list.
+    // The code binds the functions it calls the first time it runs, so it is
+    // only reused while no functions or packages have changed since.
+
+    enum
+    {
+        EvalCacheSize = 64,
+        MaxCachedEvalLength = 1024,
+    };
+
+    struct CachedEval
+    {
+        U32 hash;
+        U32 length;
+        char* string;
+        CodeBlock* code;
+        U32 lastUse;
+        U32 namespaceSequence;
+    };
+
+    static CachedEval sgEvalCache[EvalCacheSize];
+    static U32 sgEvalSequence = 0;
+    static U32 sgEvalHits = 0;
+    static U32 sgEvalCompiles = 0;
+
+    static const char* evaluateCached(const char* string)
+    {
+        U32 length = dStrlen(string);
+        if (length > MaxCachedEvalLength)
+        {
+            CodeBlock* newCodeBlock = new CodeBlock();
+            return newCodeBlock->compileExec(NULL, string, false, 0);
+        }
+
+        U32 hash = calculateCRC(string, length);
+        CachedEval* victim = &sgEvalCache[0];
+        for (U32 i = 0; i < EvalCacheSize; i++)
+        {
+            CachedEval& entry = sgEvalCache[i];
+            if (entry.code && entry.hash == hash && entry.length == length && !dStrcmp(entry.string, string))
+            {
+                if (entry.namespaceSequence == Namespace::mCacheSequence)
+                {
+                    sgEvalHits++;
+                    entry.lastUse = ++sgEvalSequence;
+                    return entry.code->exec(0, NULL, NULL, 0, 0, false, NULL, 0);
+                }
+
+                // Stale, replace it
+                victim = &entry;
+                break;
+            }
+            if (entry.lastUse < victim->lastUse)
+                victim = &entry;
+        }
+
+        sgEvalCompiles++;
+        CodeBlock* newCodeBlock = new CodeBlock();
+        if (!newCodeBlock->compileCode(NULL, string))
+        {
+            delete newCodeBlock;
+            return "";
+        }
+
+        // Keep it unless it has errors to report again next time
+        if (!Compiler::getContext().syntaxError)
+        {
+            if (victim->code)
+            {
+                victim->code->decRefCount();
+                dFree(victim->string);
+            }
+            victim->hash = hash;
+            victim->length = length;
+            victim->string = (char*)dMalloc(length + 1);
+            dStrcpy(victim->string, string);
+            victim->code = newCodeBlock;
+            victim->lastUse = ++sgEvalSequence;
+            victim->namespaceSequence = Namespace::mCacheSequence;
+            newCodeBlock->incRefCount();
+        }
+
+        return newCodeBlock->exec(0, NULL, NULL, 0, 0, false, NULL, 0);
+    }
+
+    static void clearEvalCache()
+    {
+        for (U32 i = 0; i < EvalCacheSize; i++)
+        {
+            CachedEval& entry = sgEvalCache[i];
+            if (entry.code)
+            {
+                entry.code->decRefCount();
+                dFree(entry.string);
+            }
+            entry.code = NULL;
+            entry.string = NULL;
+            entry.lastUse = 0;
+        }
+    }
+
     const char* evaluate(const char* string, bool echo, const char* fileName)
     {
         if (echo)
             Con::printf("%s%s", getVariable("$Con::Prompt"), string);
 
-        if (fileName)
-            fileName = StringTable->insert(fileName);
+        if (!fileName)
+            return evaluateCached(string);
+
+        fileName = StringTable->insert(fileName);
 
         CodeBlock* newCodeBlock = new CodeBlock();
-        return newCodeBlock->compileExec(fileName, string, false, fileName ? -1 : 0);
+        return newCodeBlock->compileExec(fileName, string, false, -1);
     }
 
     //------------------------------------------------------------------------------
@@ -935,8 +1045,16 @@ namespace Con
         va_list args;
         va_start(args, string);
         dVsprintf(buffer, sizeof(buffer), string, args);
-        CodeBlock* newCodeBlock = new CodeBlock();
-        return newCodeBlock->compileExec(NULL, buffer, false, 0);
+        return evaluateCached(buffer);
+    }
+
+    ConsoleFunction(getEvalCacheStats, const char*, 1, 1, "getEvalCacheStats();"
+        "Returns \"hits compiles\" for the strings evaluated without a file name. Strings "
+        "evaluated again while among the last 64 run their code without being parsed.")
+    {
+        char* ret = Con::getReturnBuffer(64);
+        dSprintf(ret, 64, "%d %d", sgEvalHits, sgEvalCompiles);
+        return ret;
     }
 
     const char* execute(S32 argc, const char* argv[])
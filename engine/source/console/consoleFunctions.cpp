@@ -878,8 +878,13 @@ ConsoleFunction(exec, bool, 2, 4, "exec(fileName [, nocalls [,journalScript]])")
         dStrcpy(nameBuffer, scriptFileName);
     }
 
+    // Scripts that have code in memory, from precompileScripts() or an earlier
+    // exec(), are checked against their CRC once read, so they skip the DSO
+    // lookup and the file time checks.
+    bool inMemory = compiled && !edso && CodeBlock::hasCompiledScript(scriptFileName);
+
     // If we're supposed to be compiling this file, check to see if there's a DSO
-    if (compiled && !edso)
+    if (compiled && !edso && !inMemory)
     {
         if (isEditorScript)
         {
@@ -893,9 +898,11 @@ ConsoleFunction(exec, bool, 2, 4, "exec(fileName [, nocalls [,journalScript]])")
         }
 
         if (rCom)
+        {
             rCom->getFileTimes(NULL, &comModifyTime);
-        if (rScr)
-            rScr->getFileTimes(NULL, &scrModifyTime);
+            if (rScr)
+                rScr->getFileTimes(NULL, &scrModifyTime);
+        }
     }
 
     // Let's do a sanity check to complain about DSOs in the future.
@@ -960,7 +967,7 @@ ConsoleFunction(exec, bool, 2, 4, "exec(fileName [, nocalls [,journalScript]])")
         }
 
 #ifndef TORQUE_NO_DSO_GENERATION
-        if (compiled)
+        if (compiled && !inMemory)
         {
             // compile this baddie.
             Con::printf("Compiling %s...", scriptFileName);
@@ -982,7 +989,25 @@ ConsoleFunction(exec, bool, 2, 4, "exec(fileName [, nocalls [,journalScript]])")
                 return false;
             }
         }
+        else
 #endif
+        if (compiled)
+        {
+            // Keep the compiled code so running this script again doesn't
+            // compile it again.
+            compiledStream = CodeBlock::openCompiledScript(scriptFileName, script, scriptSize);
+            if (compiledStream)
+            {
+                compiledStream->read(&version);
+            }
+            else
+            {
+                // Syntax errors were reported while compiling it.
+                delete[] script;
+                execDepth--;
+                return false;
+            }
+        }
     }
     else
     {
@@ -22,13 +22,58 @@ U32                                AbstractClassRep::classCRC[NetClassGroupsCoun
 bool                               AbstractClassRep::initialized = false;
 
 //--------------------------------------
+static inline U32 hashFieldName(StringTableEntry name)
+{
+    // Field names are StringTableEntries, mix the pointer bits a little.
+    return U32(dsize_t(name) >> 2) * 2654435761U;
+}
+
 const AbstractClassRep::Field* AbstractClassRep::findField(StringTableEntry name) const
 {
+    if (mFieldIndex.empty())
+    {
+        for (U32 i = 0; i < mFieldList.size(); i++)
+            if (mFieldList[i].pFieldname == name)
+                return &mFieldList[i];
+
+        return NULL;
+    }
+
+    const U32 mask = mFieldIndex.size() - 1;
+    for (U32 slot = hashFieldName(name) & mask; ; slot = (slot + 1) & mask)
+    {
+        U32 entry = mFieldIndex[slot];
+        if (entry == 0)
+            return NULL;
+        if (mFieldList[entry - 1].pFieldname == name)
+            return &mFieldList[entry - 1];
+    }
+}
+
+void AbstractClassRep::buildFieldIndex()
+{
+    mFieldIndex.clear();
+    if (mFieldList.empty())
+        return;
+
+    AssertFatal(mFieldList.size() < U16_MAX, "AbstractClassRep::buildFieldIndex - too many fields.");
+
+    // At most half full, so misses stop at an empty slot quickly.
+    U32 size = getNextPow2(mFieldList.size() * 2);
+    mFieldIndex.setSize(size);
+    dMemset(mFieldIndex.address(), 0, size * sizeof(U16));
+
+    const U32 mask = size - 1;
     for (U32 i = 0; i < mFieldList.size(); i++)
-        if (mFieldList[i].pFieldname == name)
-            return &mFieldList[i];
+    {
+        // Same as the scan, the first field with a name wins.
+        U32 slot = hashFieldName(mFieldList[i].pFieldname) & mask;
+        while (mFieldIndex[slot] && mFieldList[mFieldIndex[slot] - 1].pFieldname != mFieldList[i].pFieldname)
+            slot = (slot + 1) & mask;
 
-    return NULL;
+        if (!mFieldIndex[slot])
+            mFieldIndex[slot] = i + 1;
+    }
 }
 
 //--------------------------------------
@@ -118,6 +163,7 @@ void AbstractClassRep::initialize()
         // So if we have things in it, copy it over...
         if (sg_tempFieldList.size() != 0)
             walk->mFieldList = sg_tempFieldList;
+        walk->buildFieldIndex();
 
         // And of course delete it every round.
         sg_tempFieldList.clear();
@@ -160,6 +160,7 @@ public:
     AbstractClassRep()
     {
         VECTOR_SET_ASSOCIATION(mFieldList);
+        VECTOR_SET_ASSOCIATION(mFieldIndex);
         parentClass = NULL;
     }
     virtual ~AbstractClassRep() { }
@@ -324,6 +325,14 @@ public:
 
     const Field* findField(StringTableEntry fieldName) const;
 
+    /// Open addressed hash of the field names, by StringTableEntry.  Each slot
+    /// holds a field index + 1, or 0 if empty.  Built by initialize() once the
+    /// field list is final, findField() scans the list until then.
+    Vector<U16> mFieldIndex;
+
+    /// (Re)builds mFieldIndex from mFieldList.
+    void buildFieldIndex();
+
     /// @}
 
     /// @name Abstract Class Database
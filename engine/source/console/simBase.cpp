@@ -10,6 +10,7 @@
 #include "core/fileObject.h"
 #include "console/consoleInternal.h"
 #include "console/typeValidators.h"
+#include "core/tDictionary.h"
 
 namespace Sim
 {
@@ -761,12 +762,7 @@ void SimObject::setDataField(StringTableEntry slotName, const char* array, const
         if (!array)
             mFieldDictionary->setFieldValue(slotName, value);
         else
-        {
-            char buf[256];
-            dStrcpy(buf, slotName);
-            dStrcat(buf, array);
-            mFieldDictionary->setFieldValue(StringTable->insert(buf), value);
-        }
+            mFieldDictionary->setFieldValue(StringTable->insertConcat(slotName, array), value);
     }
 }
 
@@ -797,11 +793,11 @@ const char* SimObject::getDataField(StringTableEntry slotName, const char* array
         }
         else
         {
-            static char buf[256];
-            dStrcpy(buf, slotName);
-            dStrcat(buf, array);
-            if (const char* val = mFieldDictionary->getFieldValue(StringTable->insert(buf)))
-                return val;
+            // A name that isn't in the string table can't be a field.
+            StringTableEntry name = StringTable->lookupConcat(slotName, array);
+            if (name)
+                if (const char* val = mFieldDictionary->getFieldValue(name))
+                    return val;
         }
     }
     return "";
@@ -963,6 +959,24 @@ void SimObject::deleteNotify(SimObject* obj)
     //clearNotifyList.pushBack(obj);
 }
 
+void SimObject::memberNotify(SimObject* obj)
+{
+    AssertFatal(!obj->isDeleted(),
+        "SimManager::memberNotify: Object is being deleted");
+    Notify* note = allocNotify();
+    note->ptr = (void*)this;
+    note->next = obj->mNotifyList;
+    note->type = Notify::DeleteNotify;
+    obj->mNotifyList = note;
+}
+
+void SimObject::clearMemberNotify(SimObject* obj)
+{
+    Notify* note = obj->removeNotify((void*)this, Notify::DeleteNotify);
+    if (note)
+        freeNotify(note);
+}
+
 void SimObject::registerReference(SimObject** ptr)
 {
     Notify* note = allocNotify();
@@ -1006,7 +1020,10 @@ void SimObject::processDeleteNotifies()
             SimObject* obj = (SimObject*)note->ptr;
             Notify* cnote = obj->removeNotify((void*)this, Notify::ClearNotify);
             obj->onDeleteNotify(this);
-            freeNotify(cnote);
+
+            // Sets don't keep a clear note for their members.
+            if (cnote)
+                freeNotify(cnote);
         }
         else
         {
@@ -1158,7 +1175,7 @@ void SimDataBlock::assignId()
 
 void SimDataBlock::onStaticModified(const char*)
 {
-    modifiedKey = sNextModifiedKey++;
+    modifiedKey = ++sNextModifiedKey;
 
 }
 
@@ -1213,27 +1230,159 @@ ConsoleFunction(deleteDataBlocks, void, 1, 1, "Delete all the datablocks we've d
 
 //---------------------------------------------------------------------------
 
+SimSet::SimSet()
+{
+    VECTOR_SET_ASSOCIATION(objectList);
+
+    mMutex = Mutex::createMutex();
+    mObjectIndex = NULL;
+    mNextSeq = 0;
+}
+
+SimSet::~SimSet()
+{
+    lock();
+    delete mObjectIndex;
+    mObjectIndex = NULL;
+    unlock();
+    Mutex::destroyMutex(mMutex);
+    mMutex = NULL;
+}
+
+void SimSet::buildIndex()
+{
+    if (!mObjectIndex)
+        mObjectIndex = new HashTable<SimObject*, U32>;
+    else
+        mObjectIndex->clear();
+
+    mObjectIndex->resize(objectList.size() * 2);
+    mObjectSeqs.setSize(objectList.size());
+    for (U32 i = 0; i < objectList.size(); i++)
+    {
+        mObjectIndex->insertUnique(objectList[i], i);
+        mObjectSeqs[i] = i;
+    }
+    mNextSeq = objectList.size();
+}
+
+S32 SimSet::findIndex(SimObject* obj)
+{
+    // Also catches code that changed objectList behind our back
+    if (mObjectIndex ? mObjectSeqs.size() != objectList.size() : objectList.size() >= IndexThreshold)
+        buildIndex();
+
+    if (mObjectIndex)
+    {
+        HashTable<SimObject*, U32>::Iterator itr = mObjectIndex->find(obj);
+        if (itr == mObjectIndex->end())
+            return -1;
+
+        // The sequence numbers grow along the list
+        U32 seq = itr->value;
+        S32 lo = 0, hi = mObjectSeqs.size() - 1;
+        while (lo < hi)
+        {
+            S32 mid = (lo + hi) >> 1;
+            if (mObjectSeqs[mid] < seq)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        AssertFatal(mObjectSeqs[lo] == seq && objectList[lo] == obj, "SimSet::findIndex - index is out of date.");
+        return lo;
+    }
+
+    for (S32 i = 0; i < objectList.size(); i++)
+        if (objectList[i] == obj)
+            return i;
+    return -1;
+}
+
+void SimSet::appendObject(SimObject* obj)
+{
+    objectList.push_back(obj);
+    if (!mObjectIndex)
+        return;
+
+    // Renumber before the sequence numbers wrap
+    if (mNextSeq == U32(-1))
+    {
+        buildIndex();
+        return;
+    }
+
+    mObjectSeqs.push_back(mNextSeq);
+    mObjectIndex->insertUnique(obj, mNextSeq++);
+}
+
+void SimSet::removeSlot(U32 slot)
+{
+    SimObject* obj = objectList[slot];
+    objectList.erase(objectList.begin() + slot);
+
+    if (!mObjectIndex)
+        return;
+
+    // Small again, not worth keeping.
+    if (objectList.size() < IndexThreshold / 2)
+    {
+        invalidateIndex();
+        return;
+    }
+
+    mObjectIndex->erase(obj);
+    mObjectSeqs.erase(slot);
+}
+
+void SimSet::invalidateIndex()
+{
+    delete mObjectIndex;
+    mObjectIndex = NULL;
+    mObjectSeqs.clear();
+}
+
+bool SimSet::isMember(SimObject* obj)
+{
+    lock();
+    bool member = findIndex(obj) != -1;
+    unlock();
+    return member;
+}
+
 void SimSet::addObject(SimObject* obj)
 {
     lock();
-    objectList.pushBack(obj);
-    deleteNotify(obj);
+    if (findIndex(obj) == -1)
+    {
+        appendObject(obj);
+        memberNotify(obj);
+    }
     unlock();
 }
 
 void SimSet::removeObject(SimObject* obj)
 {
     lock();
-    objectList.remove(obj);
-    clearNotify(obj);
+    S32 slot = findIndex(obj);
+    if (slot != -1)
+    {
+        removeSlot(slot);
+        clearMemberNotify(obj);
+    }
     unlock();
 }
 
 void SimSet::pushObject(SimObject* pObj)
 {
     lock();
-    objectList.pushBackForce(pObj);
-    deleteNotify(pObj);
+    S32 slot = findIndex(pObj);
+    if (slot == -1)
+        memberNotify(pObj);
+    else
+        removeSlot(slot);
+    appendObject(pObj);
     unlock();
 }
 
@@ -1250,8 +1399,8 @@ void SimSet::popObject()
 
     SimObject* pObject = objectList[objectList.size() - 1];
 
-    objectList.removeStable(pObject);
-    clearNotify(pObject);
+    removeSlot(objectList.size() - 1);
+    clearMemberNotify(pObject);
 }
 
 bool SimSet::reOrder(SimObject* obj, SimObject* target)
@@ -1259,8 +1408,8 @@ bool SimSet::reOrder(SimObject* obj, SimObject* target)
     MutexHandle handle;
     handle.lock(mMutex);
 
-    iterator itrS, itrD;
-    if ((itrS = find(begin(), end(), obj)) == end())
+    S32 slotS, slotD;
+    if ((slotS = findIndex(obj)) == -1)
     {
         return false;  // object must be in list
     }
@@ -1272,21 +1421,22 @@ bool SimSet::reOrder(SimObject* obj, SimObject* target)
 
     if (!target)    // if no target, then put to back of list
     {
-        if (itrS != (end() - 1))      // don't move if already last object
+        if (slotS != (objectList.size() - 1))  // don't move if already last object
         {
-            objectList.erase(itrS);    // remove object from its current location
-            objectList.push_back(obj); // push it to the back of the list
+            removeSlot(slotS);  // remove object from its current location
+            appendObject(obj);  // push it to the back of the list
         }
     }
     else              // if target, insert object in front of target
     {
-        if ((itrD = find(begin(), end(), target)) == end())
+        if (findIndex(target) == -1)
             return false;              // target must be in list
-        objectList.erase(itrS);
+        removeSlot(slotS);
 
-        //Tinman - once itrS has been erased, itrD won't be pointing at the same place anymore - re-find...
-        itrD = find(begin(), end(), target);
-        objectList.insert(itrD, obj);
+        //Tinman - once slotS has been erased, the target won't be in the same place anymore - re-find...
+        slotD = findIndex(target);
+        objectList.insert(objectList.begin() + slotD, obj);
+        invalidateIndex();
     }
     return true;
 }
@@ -1303,6 +1453,7 @@ void SimSet::onRemove()
     handle.lock(mMutex);
 
     objectList.sortId();
+    invalidateIndex();
     if (objectList.size())
     {
         // This backwards iterator loop doesn't work if the
@@ -1310,7 +1461,7 @@ void SimSet::onRemove()
         for (SimObjectList::iterator ptr = objectList.end() - 1;
             ptr >= objectList.begin(); ptr--)
         {
-            clearNotify(*ptr);
+            clearMemberNotify(*ptr);
         }
     }
 
@@ -1388,7 +1539,7 @@ ConsoleMethod(SimSet, remove, void, 3, 0, "set.remove(obj1,...)")
     {
         SimObject* obj = Sim::findObject(argv[i]);
         object->lock();
-        if (obj && object->find(object->begin(), object->end(), obj) != object->end())
+        if (obj && object->isMember(obj))
             object->removeObject(obj);
         else
             Con::printf("Set::remove: Object \"%s\" does not exist in set", argv[i]);
@@ -1432,18 +1583,7 @@ ConsoleMethod(SimSet, isMember, bool, 3, 3, "set.isMember(object)")
         Con::printf("SimSet::isMember: %s is not an object.", argv[2]);
         return false;
     }
-    object->lock();
-    for (SimSet::iterator i = object->begin(); i != object->end(); i++)
-    {
-        if (*i == testObject)
-        {
-            object->unlock();
-            return true;
-        }
-    }
-    object->unlock();
-
-    return false;
+    return object->isMember(testObject);
 }
 
 ConsoleMethod(SimSet, bringToFront, void, 3, 3, "set.bringToFront(object)")
@@ -1499,6 +1639,7 @@ SimGroup::~SimGroup()
     // already have been removed from the manager, so we
     // can just delete them directly.
     objectList.sortId();
+    invalidateIndex();
     while (!objectList.empty())
     {
         delete objectList.last();
@@ -1530,8 +1671,8 @@ void SimGroup::addObject(SimObject* obj)
             obj->mGroup->removeObject(obj);
         nameDictionary.insert(obj);
         obj->mGroup = this;
-        objectList.push_back(obj); // force it into the object list
-                                   // doesn't get a delete notify
+        appendObject(obj); // force it into the object list
+                           // doesn't get a delete notify
         obj->onGroupAdd();
     }
     unlock();
@@ -1544,7 +1685,9 @@ void SimGroup::removeObject(SimObject* obj)
     {
         obj->onGroupRemove();
         nameDictionary.remove(obj);
-        objectList.remove(obj);
+        S32 slot = findIndex(obj);
+        if (slot != -1)
+            removeSlot(slot);
         obj->mGroup = 0;
     }
     unlock();
@@ -1556,6 +1699,7 @@ void SimGroup::onRemove()
 {
     lock();
     objectList.sortId();
+    invalidateIndex();
     if (objectList.size())
     {
         // This backwards iterator loop doesn't work if the
@@ -1641,6 +1785,62 @@ IMPLEMENT_CONOBJECT(SimGroup);
 
 //------------------------------------------------------------------------------
 
+ConsoleFunction(simSetBenchmark, void, 1, 2, "simSetBenchmark( [count] );"
+    "Loads and deletes a mission of count (default 20000) plain objects.  The objects go into a "
+    "group like MissionGroup and into a set like MissionCleanup, half of them are taken out of "
+    "the set again, then the group is deleted.  Prints the time each step took.")
+{
+    U32 count = argc > 1 ? getMax(dAtoi(argv[1]), 1) : 20000;
+
+    SimGroup* group = new SimGroup;
+    group->registerObject();
+    SimSet* set = new SimSet;
+    set->registerObject();
+
+    U32 start = Platform::getRealMilliseconds();
+    for (U32 i = 0; i < count; i++)
+    {
+        SimObject* obj = new SimObject;
+        obj->registerObject();
+        group->addObject(obj);
+    }
+    U32 loadTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    for (U32 i = 0; i < count; i++)
+        set->addObject((*group)[i]);
+    U32 addTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    U32 members = 0;
+    for (U32 i = 0; i < count; i++)
+        if (set->isMember((*group)[i]))
+            members++;
+    U32 findTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    for (U32 i = 0; i < count; i += 2)
+        set->removeObject((*group)[i]);
+    U32 removeTime = Platform::getRealMilliseconds() - start;
+    U32 remaining = set->size();
+
+    // Every object left in the set gets removed by its delete notification.
+    start = Platform::getRealMilliseconds();
+    group->deleteObject();
+    U32 deleteTime = Platform::getRealMilliseconds() - start;
+
+    Con::printf("SimSet benchmark: %d objects", count);
+    Con::printf("   load into group  %6d ms", loadTime);
+    Con::printf("   add to set       %6d ms", addTime);
+    Con::printf("   isMember         %6d ms   (%d members)", findTime, members);
+    Con::printf("   remove half      %6d ms   (%d left)", removeTime, remaining);
+    Con::printf("   delete group     %6d ms   (%d left in set)", deleteTime, set->size());
+
+    set->deleteObject();
+}
+
+//------------------------------------------------------------------------------
+
 SimConsoleEvent::SimConsoleEvent(S32 argc, const char** argv, bool onObject)
 {
     mOnObject = onObject;
@@ -65,6 +65,7 @@ class Namespace;
 class BitStream;
 class Stream;
 class LightManager;
+template<typename Key, typename Value> class HashTable;
 
 typedef U32 SimTime;
 typedef U32 SimObjectId;
@@ -110,14 +111,15 @@ public:
 class SimEvent
 {
 public:
-    SimEvent* nextEvent;     ///< Linked list details - pointer to next item in the list.
+    SimEvent* nextEvent;     ///< Next event in the same id bucket of the event queue.
+    U32 queueIndex;          ///< Position in the event queue heap.
     SimTime startTime;       ///< When the event was posted.
     SimTime time;            ///< When the event is scheduled to occur.
     U32 sequenceCount;       ///< Unique ID. These are assigned sequentially based on order
                              ///  of addition to the list.
     SimObject* destObject;   ///< Object on which this event will be applied.
 
-    SimEvent() { destObject = NULL; }
+    SimEvent() { destObject = NULL; nextEvent = NULL; queueIndex = 0; }
     virtual ~SimEvent() {}   ///< Destructor
                              ///
                              /// A dummy virtual destructor is required
@@ -138,6 +140,64 @@ public:
     virtual void process(SimObject* object) = 0;
 };
 
+/// Pending SimEvents, in the order they are to be processed.
+///
+/// Events are processed by time, and events with the same time in the order
+/// they were posted, by sequenceCount.  The queue is a binary heap with that
+/// ordering plus a hash of the events by sequenceCount, so posting and
+/// processing an event are O(log n) and looking one up by id, for
+/// cancelEvent() and isEventPending(), is O(1).
+///
+/// Not locked, Sim keeps it behind the event queue mutex.
+class SimEventQueue
+{
+    enum
+    {
+        MinBuckets = 1024   ///< Power of two, grown as the queue grows.
+    };
+
+    Vector<SimEvent*> mHeap;
+    Vector<SimEvent*> mBuckets; ///< Chained through SimEvent::nextEvent.
+
+    /// True if @a a is processed before @a b.  Sequence numbers are compared
+    /// modulo 2^32 so the order holds across the wrap.
+    static bool before(const SimEvent* a, const SimEvent* b)
+    {
+        if (a->time != b->time)
+            return a->time < b->time;
+        return S32(a->sequenceCount - b->sequenceCount) < 0;
+    }
+
+    void siftUp(U32 index);
+    void siftDown(U32 index);
+    void unlinkId(SimEvent* event);
+    void rehash(U32 numBuckets);
+
+public:
+    SimEventQueue();
+    ~SimEventQueue();
+
+    /// Deletes every pending event.
+    void clear();
+
+    /// Adds an event.  Its time and sequenceCount must be set.
+    void insert(SimEvent* event);
+
+    /// Takes an event out of the queue, without deleting it.
+    void remove(SimEvent* event);
+
+    /// Returns the pending event with the given id, or NULL.
+    SimEvent* find(U32 sequenceCount) const;
+
+    /// Deletes all pending events for @a obj.
+    void removeObjectEvents(SimObject* obj);
+
+    /// The next event to process, or NULL.
+    SimEvent* first() const { return mHeap.empty() ? NULL : mHeap.first(); }
+
+    U32 size() const { return mHeap.size(); }
+};
+
 /// Implementation of schedule() function.
 ///
 /// This allows you to set a console function to be
@@ -612,6 +672,12 @@ public:
     Notify* removeNotify(void* ptr, Notify::Type);   ///< Remove a notification from the list.
     void deleteNotify(SimObject* obj);               ///< Notify an object when we are deleted.
     void clearNotify(SimObject* obj);                ///< Notify an object when we are cleared.
+
+    /// Like deleteNotify(), but only the note on @a obj is kept.  For sets
+    /// that track their members themselves, so a set with thousands of
+    /// members does not walk a notify list as long as itself to remove one.
+    void memberNotify(SimObject* obj);
+    void clearMemberNotify(SimObject* obj);          ///< Undo memberNotify().
     void clearAllNotifications();                    ///< Remove all notifications for this object.
     void processDeleteNotifies();                    ///< Send out deletion notifications.
 
@@ -1074,20 +1140,47 @@ protected:
     SimObjectList objectList;
     void* mMutex;
 
-public:
-    SimSet() {
-        VECTOR_SET_ASSOCIATION(objectList);
-
-        mMutex = Mutex::createMutex();
-    }
+    /// @name Member Index
+    ///
+    /// Sets with more than a few members give every member a sequence number
+    /// that only grows along objectList, and hash member to sequence number.
+    /// Finding a member is a hash lookup and a binary search of the sequence
+    /// numbers, so removing a member doesn't have to renumber the ones after
+    /// it.  The order of the list is unchanged, removing a member still
+    /// shifts the ones after it down a slot.
+    ///
+    /// Code that reorders objectList directly has to call invalidateIndex().
+    /// @{
 
-    ~SimSet()
+    enum
     {
-        lock();
-        unlock();
-        Mutex::destroyMutex(mMutex);
-        mMutex = NULL;
-    }
+        IndexThreshold = 32     ///< Members before the index is built.
+    };
+
+    HashTable<SimObject*, U32>* mObjectIndex;
+    Vector<U32> mObjectSeqs;    ///< Sequence number of each slot of objectList.
+    U32 mNextSeq;
+
+    /// Builds the index from objectList.
+    void buildIndex();
+
+    /// Slot of @a obj in objectList, or -1 if it's not a member.
+    S32 findIndex(SimObject* obj);
+
+    /// Adds @a obj to the end of objectList.
+    void appendObject(SimObject* obj);
+
+    /// Erases a slot of objectList.
+    void removeSlot(U32 slot);
+
+    /// Drops the index, it's rebuilt when next needed.
+    void invalidateIndex();
+
+    /// @}
+
+public:
+    SimSet();
+    ~SimSet();
 
     /// @name STL Interface
     /// @{
@@ -1111,6 +1204,9 @@ public:
 
     bool reOrder(SimObject* obj, SimObject* target = 0);
 
+    /// Returns true if @a obj is in the set.
+    bool isMember(SimObject* obj);
+
     /// @}
 
     virtual void onRemove();
@@ -13,10 +13,250 @@
 #include "core/fileObject.h"
 #include "console/consoleInternal.h"
 #include "core/idGenerator.h"
+#include "math/mRandom.h"
 
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+// SimEventQueue
+//---------------------------------------------------------------------------
+
+SimEventQueue::SimEventQueue()
+{
+    mBuckets.setSize(MinBuckets);
+    for (U32 i = 0; i < mBuckets.size(); i++)
+        mBuckets[i] = NULL;
+}
+
+SimEventQueue::~SimEventQueue()
+{
+    clear();
+}
+
+void SimEventQueue::clear()
+{
+    for (U32 i = 0; i < mHeap.size(); i++)
+        delete mHeap[i];
+    mHeap.clear();
+
+    for (U32 i = 0; i < mBuckets.size(); i++)
+        mBuckets[i] = NULL;
+}
+
+void SimEventQueue::insert(SimEvent* event)
+{
+    if (mHeap.size() >= mBuckets.size())
+        rehash(mBuckets.size() * 2);
+
+    SimEvent*& bucket = mBuckets[event->sequenceCount & (mBuckets.size() - 1)];
+    event->nextEvent = bucket;
+    bucket = event;
+
+    event->queueIndex = mHeap.size();
+    mHeap.push_back(event);
+    siftUp(event->queueIndex);
+}
+
+void SimEventQueue::remove(SimEvent* event)
+{
+    AssertFatal(event->queueIndex < mHeap.size() && mHeap[event->queueIndex] == event,
+        "SimEventQueue::remove - event is not in the queue.");
+
+    unlinkId(event);
+
+    // Move the last event into the hole and let it find its place.
+    U32 index = event->queueIndex;
+    SimEvent* last = mHeap.last();
+    mHeap.decrement();
+    if (last != event)
+    {
+        mHeap[index] = last;
+        last->queueIndex = index;
+        siftUp(index);
+        siftDown(last->queueIndex);
+    }
+}
+
+SimEvent* SimEventQueue::find(U32 sequenceCount) const
+{
+    SimEvent* walk = mBuckets[sequenceCount & (mBuckets.size() - 1)];
+    while (walk && walk->sequenceCount != sequenceCount)
+        walk = walk->nextEvent;
+    return walk;
+}
+
+void SimEventQueue::removeObjectEvents(SimObject* obj)
+{
+    // Compact the heap and rebuild it, cheaper than removing events one by
+    // one when an object goes away with many of them.
+    U32 kept = 0;
+    for (U32 i = 0; i < mHeap.size(); i++)
+    {
+        SimEvent* event = mHeap[i];
+        if (event->destObject == obj)
+        {
+            unlinkId(event);
+            delete event;
+        }
+        else
+        {
+            event->queueIndex = kept;
+            mHeap[kept++] = event;
+        }
+    }
+
+    if (kept == mHeap.size())
+        return;
+
+    mHeap.setSize(kept);
+    for (U32 i = kept / 2; i-- > 0; )
+        siftDown(i);
+}
+
+void SimEventQueue::unlinkId(SimEvent* event)
+{
+    SimEvent** walk = &mBuckets[event->sequenceCount & (mBuckets.size() - 1)];
+    while (*walk != event)
+        walk = &(*walk)->nextEvent;
+    *walk = event->nextEvent;
+    event->nextEvent = NULL;
+}
+
+void SimEventQueue::siftUp(U32 index)
+{
+    SimEvent* event = mHeap[index];
+    while (index > 0)
+    {
+        U32 parent = (index - 1) / 2;
+        if (!before(event, mHeap[parent]))
+            break;
+
+        mHeap[index] = mHeap[parent];
+        mHeap[index]->queueIndex = index;
+        index = parent;
+    }
+    mHeap[index] = event;
+    event->queueIndex = index;
+}
+
+void SimEventQueue::siftDown(U32 index)
+{
+    SimEvent* event = mHeap[index];
+    const U32 count = mHeap.size();
+    for (;;)
+    {
+        U32 child = index * 2 + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && before(mHeap[child + 1], mHeap[child]))
+            child++;
+        if (!before(mHeap[child], event))
+            break;
+
+        mHeap[index] = mHeap[child];
+        mHeap[index]->queueIndex = index;
+        index = child;
+    }
+    mHeap[index] = event;
+    event->queueIndex = index;
+}
+
+void SimEventQueue::rehash(U32 numBuckets)
+{
+    mBuckets.setSize(numBuckets);
+    for (U32 i = 0; i < numBuckets; i++)
+        mBuckets[i] = NULL;
+
+    for (U32 i = 0; i < mHeap.size(); i++)
+    {
+        SimEvent*& bucket = mBuckets[mHeap[i]->sequenceCount & (numBuckets - 1)];
+        mHeap[i]->nextEvent = bucket;
+        bucket = mHeap[i];
+    }
+}
+
+//---------------------------------------------------------------------------
+
+namespace
+{
+    /// Does nothing, only there to fill the queue.
+    class BenchmarkEvent : public SimEvent
+    {
+    public:
+        void process(SimObject*) {}
+    };
+}
+
+ConsoleFunction(simEventQueueBenchmark, void, 1, 2, "simEventQueueBenchmark( [count] );"
+    "Posts count (default 100000) events with random times to a private event queue, looks them "
+    "all up, cancels a third of them and processes the rest, then prints the time each step took "
+    "and checks the processing order.  Does not touch the sim clock.")
+{
+    U32 count = argc > 1 ? getMax(dAtoi(argv[1]), 1) : 100000;
+
+    SimEventQueue queue;
+    Vector<U32> ids;
+    ids.reserve(count);
+
+    MRandomLCG rand(1376312589);
+
+    // Post, a lot of them at the same time to exercise the FIFO ordering.
+    U32 start = Platform::getRealMilliseconds();
+    for (U32 i = 0; i < count; i++)
+    {
+        SimEvent* event = new BenchmarkEvent;
+        event->startTime = 0;
+        event->time = rand.randI(0, 600) * 100;
+        event->sequenceCount = i + 1;
+        queue.insert(event);
+        ids.push_back(event->sequenceCount);
+    }
+    U32 postTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    U32 found = 0;
+    for (U32 i = 0; i < count; i++)
+        if (queue.find(ids[i]))
+            found++;
+    U32 findTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    for (U32 i = 0; i < count; i += 3)
+    {
+        SimEvent* event = queue.find(ids[i]);
+        queue.remove(event);
+        delete event;
+    }
+    U32 cancelTime = Platform::getRealMilliseconds() - start;
+
+    start = Platform::getRealMilliseconds();
+    U32 processed = 0;
+    U32 misordered = 0;
+    SimTime lastTime = 0;
+    U32 lastSequence = 0;
+    SimEvent* event;
+    while ((event = queue.first()) != NULL)
+    {
+        queue.remove(event);
+        if (event->time < lastTime || (event->time == lastTime && event->sequenceCount < lastSequence))
+            misordered++;
+        lastTime = event->time;
+        lastSequence = event->sequenceCount;
+        processed++;
+        delete event;
+    }
+    U32 processTime = Platform::getRealMilliseconds() - start;
+
+    Con::printf("SimEventQueue benchmark: %d events", count);
+    Con::printf("   post     %6d ms", postTime);
+    Con::printf("   find     %6d ms   (%d found)", findTime, found);
+    Con::printf("   cancel   %6d ms   (%d cancelled)", cancelTime, count - processed);
+    Con::printf("   process  %6d ms   (%d processed, %d out of order)", processTime, processed, misordered);
+}
+
+//---------------------------------------------------------------------------
+
 // We comment out the implementation of the Con namespace when doxygenizing because
 // otherwise Doxygen decides to ignore our docs in console.h
 #ifndef DOXYGENIZING
@@ -34,7 +274,7 @@ namespace Sim
     SimTime gTargetTime;
 
     void* gEventQueueMutex;
-    SimEvent* gEventQueue;
+    SimEventQueue gEventQueue;
     U32 gEventSequence;
 
     //---------------------------------------------------------------------------
@@ -45,7 +285,6 @@ namespace Sim
         gCurrentTime = 0;
         gTargetTime = 0;
         gEventSequence = 1;
-        gEventQueue = NULL;
         gEventQueueMutex = Mutex::createMutex();
     }
 
@@ -53,13 +292,7 @@ namespace Sim
     {
         // Delete all pending events
         Mutex::lockMutex(gEventQueueMutex);
-        SimEvent* walk = gEventQueue;
-        while (walk)
-        {
-            SimEvent* temp = walk->nextEvent;
-            delete walk;
-            walk = temp;
-        }
+        gEventQueue.clear();
         Mutex::unlockMutex(gEventQueueMutex);
         Mutex::destroyMutex(gEventQueueMutex);
     }
@@ -87,19 +320,11 @@ namespace Sim
             return InvalidEventId;
         }
         event->sequenceCount = gEventSequence++;
-        SimEvent** walk = &gEventQueue;
-        SimEvent* current;
-
-        while ((current = *walk) != NULL && (current->time < event->time))
-            walk = &(current->nextEvent);
 
-        // [tom, 6/24/2005] This ensures that SimEvents are dispatched in the same order that they are posted.
+        // [tom, 6/24/2005] SimEvents must be dispatched in the same order that they are posted.
         // This is needed to ensure Con::threadSafeExecute() executes script code in the correct order.
-        while ((current = *walk) != NULL && (current->time == event->time))
-            walk = &(current->nextEvent);
-
-        event->nextEvent = current;
-        *walk = event;
+        // The queue orders events with the same time by sequenceCount.
+        gEventQueue.insert(event);
 
         U32 seqCount = event->sequenceCount;
 
@@ -115,20 +340,11 @@ namespace Sim
     {
         Mutex::lockMutex(gEventQueueMutex);
 
-        SimEvent** walk = &gEventQueue;
-        SimEvent* current;
-
-        while ((current = *walk) != NULL)
+        SimEvent* event = gEventQueue.find(eventSequence);
+        if (event)
         {
-            if (current->sequenceCount == eventSequence)
-            {
-                *walk = current->nextEvent;
-                delete current;
-                Mutex::unlockMutex(gEventQueueMutex);
-                return;
-            }
-            else
-                walk = &(current->nextEvent);
+            gEventQueue.remove(event);
+            delete event;
         }
 
         Mutex::unlockMutex(gEventQueueMutex);
@@ -137,20 +353,7 @@ namespace Sim
     void cancelPendingEvents(SimObject* obj)
     {
         Mutex::lockMutex(gEventQueueMutex);
-
-        SimEvent** walk = &gEventQueue;
-        SimEvent* current;
-
-        while ((current = *walk) != NULL)
-        {
-            if (current->destObject == obj)
-            {
-                *walk = current->nextEvent;
-                delete current;
-            }
-            else
-                walk = &(current->nextEvent);
-        }
+        gEventQueue.removeObjectEvents(obj);
         Mutex::unlockMutex(gEventQueueMutex);
     }
 
@@ -160,48 +363,33 @@ namespace Sim
     bool isEventPending(U32 eventSequence)
     {
         Mutex::lockMutex(gEventQueueMutex);
-
-        for (SimEvent* walk = gEventQueue; walk; walk = walk->nextEvent)
-            if (walk->sequenceCount == eventSequence)
-            {
-                Mutex::unlockMutex(gEventQueueMutex);
-                return true;
-            }
+        bool pending = gEventQueue.find(eventSequence) != NULL;
         Mutex::unlockMutex(gEventQueueMutex);
-        return false;
+        return pending;
     }
 
     U32 getEventTimeLeft(U32 eventSequence)
     {
         Mutex::lockMutex(gEventQueueMutex);
 
-        for (SimEvent* walk = gEventQueue; walk; walk = walk->nextEvent)
-            if (walk->sequenceCount == eventSequence)
-            {
-                SimTime t = walk->time - getCurrentTime();
-                Mutex::unlockMutex(gEventQueueMutex);
-                return t;
-            }
+        SimEvent* event = gEventQueue.find(eventSequence);
+        SimTime t = event ? event->time - getCurrentTime() : 0;
 
         Mutex::unlockMutex(gEventQueueMutex);
 
-        return 0;
+        return t;
     }
 
     U32 getScheduleDuration(U32 eventSequence)
     {
-        for (SimEvent* walk = gEventQueue; walk; walk = walk->nextEvent)
-            if (walk->sequenceCount == eventSequence)
-                return (walk->time - walk->startTime);
-        return 0;
+        SimEvent* event = gEventQueue.find(eventSequence);
+        return event ? (event->time - event->startTime) : 0;
     }
 
     U32 getTimeSinceStart(U32 eventSequence)
     {
-        for (SimEvent* walk = gEventQueue; walk; walk = walk->nextEvent)
-            if (walk->sequenceCount == eventSequence)
-                return (getCurrentTime() - walk->startTime);
-        return 0;
+        SimEvent* event = gEventQueue.find(eventSequence);
+        return event ? (getCurrentTime() - event->startTime) : 0;
     }
 
     //---------------------------------------------------------------------------
@@ -213,10 +401,11 @@ namespace Sim
 
         Mutex::lockMutex(gEventQueueMutex);
         gTargetTime = targetTime;
-        while (gEventQueue && gEventQueue->time <= targetTime)
+
+        SimEvent* event;
+        while ((event = gEventQueue.first()) != NULL && event->time <= targetTime)
         {
-            SimEvent* event = gEventQueue;
-            gEventQueue = gEventQueue->nextEvent;
+            gEventQueue.remove(event);
             AssertFatal(event->time >= gCurrentTime,
                 "SimEventQueue::pop: Cannot go back in time (flux capacitor not installed - BJG).");
             gCurrentTime = event->time;
@@ -400,6 +589,7 @@ void SimDataBlockGroup::sort()
     {
         mLastModifiedKey = SimDataBlock::getNextModifiedKey();
         dQsort(objectList.address(), objectList.size(), sizeof(SimObject*), compareModifiedKey);
+        invalidateIndex();
     }
 }
 
@@ -11,6 +11,10 @@
 #include "math/mathIO.h"
 #include "platform/event.h"
 #include "console/consoleObject.h"
+#include "console/console.h"
+
+#include <atomic>
+#include <string.h>
 
 static BitStream gPacketStream(NULL, 0);
 static U8 gPacketBuffer[MaxPacketDataSize];
@@ -38,6 +42,193 @@ void BitStream::sendPacketStream(const NetAddress* addr)
     Net::sendto(addr, gPacketStream.getBuffer(), gPacketStream.getPosition());
 }
 
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    enum
+    {
+        PoolCapacity = PacketBufferPool::BuffersPerBlock * PacketBufferPool::MaxBlocks,
+        SlabHeaderSize = 16,    // Holds the buffer index, keeps the buffer aligned.
+        SlabSize = SlabHeaderSize + MaxPacketDataSize,
+        HeapBufferIndex = 0xFFFFFFFF,
+    };
+
+    /// Lock free stack of free buffer indices.  The head packs a change count
+    /// above index + 1 so a pop racing with a pop and push of the same buffer
+    /// fails its exchange, 0 in the low half means empty.
+    struct PacketBufferFreeList
+    {
+        std::atomic<U64> head;
+        std::atomic<U32> next[PoolCapacity];
+        std::atomic<U8*> blocks[PacketBufferPool::MaxBlocks];
+        std::atomic<U32> numBlocks;
+
+        std::atomic<U32> inUse;
+        std::atomic<U32> peakInUse;
+        std::atomic<U32> acquires;
+        std::atomic<U32> heapBuffers;
+
+        PacketBufferFreeList()
+        {
+            head = 0;
+            numBlocks = 0;
+            inUse = peakInUse = acquires = heapBuffers = 0;
+            for (U32 i = 0; i < PacketBufferPool::MaxBlocks; i++)
+                blocks[i] = NULL;
+        }
+
+        ~PacketBufferFreeList()
+        {
+            for (U32 i = 0; i < PacketBufferPool::MaxBlocks; i++)
+                dFree(blocks[i].load());
+        }
+
+        U8* getSlab(U32 index)
+        {
+            U8* block = blocks[index / PacketBufferPool::BuffersPerBlock].load(std::memory_order_acquire);
+            return block + (index % PacketBufferPool::BuffersPerBlock) * SlabSize;
+        }
+
+        void push(U32 index)
+        {
+            U64 oldHead = head.load(std::memory_order_relaxed);
+            U64 newHead;
+            do
+            {
+                next[index].store(U32(oldHead), std::memory_order_relaxed);
+                newHead = (((oldHead >> 32) + 1) << 32) | (index + 1);
+            } while (!head.compare_exchange_weak(oldHead, newHead, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        bool pop(U32& index)
+        {
+            U64 oldHead = head.load(std::memory_order_acquire);
+            for (;;)
+            {
+                U32 top = U32(oldHead);
+                if (!top)
+                    return false;
+
+                U64 newHead = (((oldHead >> 32) + 1) << 32) | next[top - 1].load(std::memory_order_relaxed);
+                if (head.compare_exchange_weak(oldHead, newHead, std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    index = top - 1;
+                    return true;
+                }
+            }
+        }
+
+        /// Adds a block of buffers, keeps the first one for the caller.
+        bool grow(U32& index)
+        {
+            U32 block = numBlocks.fetch_add(1);
+            if (block >= PacketBufferPool::MaxBlocks)
+            {
+                numBlocks.fetch_sub(1);
+                return false;
+            }
+
+            U8* memory = (U8*)dMalloc(PacketBufferPool::BuffersPerBlock * SlabSize);
+            blocks[block].store(memory, std::memory_order_release);
+
+            U32 first = block * PacketBufferPool::BuffersPerBlock;
+            for (U32 i = 0; i < PacketBufferPool::BuffersPerBlock; i++)
+                *(U32*)(memory + i * SlabSize) = first + i;
+            for (U32 i = PacketBufferPool::BuffersPerBlock - 1; i > 0; i--)
+                push(first + i);
+
+            index = first;
+            return true;
+        }
+    };
+
+    PacketBufferFreeList sgPacketBuffers;
+}
+
+U8* PacketBufferPool::acquire()
+{
+    U8* slab;
+    U32 index;
+    if (sgPacketBuffers.pop(index) || sgPacketBuffers.grow(index))
+    {
+        slab = sgPacketBuffers.getSlab(index);
+    }
+    else
+    {
+        slab = (U8*)dMalloc(SlabSize);
+        *(U32*)slab = HeapBufferIndex;
+        sgPacketBuffers.heapBuffers++;
+    }
+
+    sgPacketBuffers.acquires++;
+    U32 inUse = ++sgPacketBuffers.inUse;
+    U32 peak = sgPacketBuffers.peakInUse.load(std::memory_order_relaxed);
+    while (inUse > peak && !sgPacketBuffers.peakInUse.compare_exchange_weak(peak, inUse))
+        ;
+
+    return slab + SlabHeaderSize;
+}
+
+void PacketBufferPool::release(U8* buffer)
+{
+    if (buffer == NULL)
+        return;
+
+    U8* slab = buffer - SlabHeaderSize;
+    U32 index = *(U32*)slab;
+    sgPacketBuffers.inUse--;
+
+    if (index == HeapBufferIndex)
+    {
+        dFree(slab);
+        return;
+    }
+
+    AssertFatal(index < PoolCapacity && sgPacketBuffers.getSlab(index) == slab,
+        "PacketBufferPool::release - not a pool buffer.");
+    sgPacketBuffers.push(index);
+}
+
+PacketBufferPool::Stats PacketBufferPool::getStats()
+{
+    Stats stats;
+    stats.buffers = getMin(sgPacketBuffers.numBlocks.load(), U32(MaxBlocks)) * BuffersPerBlock;
+    stats.inUse = sgPacketBuffers.inUse;
+    stats.peakInUse = sgPacketBuffers.peakInUse;
+    stats.acquires = sgPacketBuffers.acquires;
+    stats.heapBuffers = sgPacketBuffers.heapBuffers;
+    return stats;
+}
+
+PacketStream::PacketStream(U32 writeSize) : BitStream(NULL, 0)
+{
+    if (!writeSize)
+        writeSize = MaxPacketDataSize;
+
+    setBuffer(PacketBufferPool::acquire(), writeSize, MaxPacketDataSize);
+}
+
+PacketStream::~PacketStream()
+{
+    PacketBufferPool::release(dataPtr);
+}
+
+void PacketStream::sendTo(const NetAddress* addr)
+{
+    Net::sendto(addr, getBuffer(), getPosition());
+}
+
+ConsoleFunction(getPacketPoolStats, const char*, 1, 1, "getPacketPoolStats();"
+    "Returns \"buffers inUse peakInUse acquires heapBuffers\" of the pool outgoing packets "
+    "are built in. heapBuffers should stay 0, it counts packets built while the pool was full.")
+{
+    PacketBufferPool::Stats stats = PacketBufferPool::getStats();
+    char* ret = Con::getReturnBuffer(128);
+    dSprintf(ret, 128, "%d %d %d %d %d", stats.buffers, stats.inUse, stats.peakInUse, stats.acquires, stats.heapBuffers);
+    return ret;
+}
+
 // FIXMEFIXMEFIXME MATH
 
 inline bool IsEqual(F32 a, F32 b) { return a == b; }
@@ -60,7 +251,8 @@ void ResizeBitStream::validate()
 {
     if (getPosition() + mMinSpace > bufSize)
     {
-        bufSize = getPosition() + mMinSpace * 2;
+        // Grow by half at least, start blocks and demos write a lot of these
+        bufSize = getMax(getPosition() + mMinSpace * 2, U32(bufSize + bufSize / 2));
         dataPtr = (U8*)dRealloc(dataPtr, bufSize);
 
         maxReadBitNum = bufSize << 3;
@@ -87,7 +279,7 @@ class HuffmanProcessor
 
         U8  numBits;
         U8  symbol;
-        U32 code;   // no code should be longer than 32 bits.
+        U32 code;   // no code should be longer than 32 bits.  First bit is bit 0.
     };
     // We have to be a bit careful with these, mSince they are pointers...
     struct HuffWrap {
@@ -106,9 +298,25 @@ class HuffmanProcessor
     Vector<HuffNode> m_huffNodes;
     Vector<HuffLeaf> m_huffLeaves;
 
+    enum {
+        LookupBits = 10,
+        LookupSize = 1 << LookupBits,
+        MaxHuffChars = 255,
+    };
+
+    /// Decodes the next LookupBits of the stream in one step.  Codes up to that
+    /// long resolve to their symbol, longer ones to the node the tree walk
+    /// continues from.
+    struct HuffLookup {
+        S16 index;      ///< Symbol if numBits is set, node otherwise.
+        U8  numBits;    ///< Length of the code, 0 if it is longer than LookupBits.
+    };
+    HuffLookup m_lookup[LookupSize];
+
     S16 determineIndex(HuffWrap&);
 
     void generateCodes(BitStream&, S32, S32);
+    void buildLookup();
 
 public:
     HuffmanProcessor() : m_tablesBuilt(false) { }
@@ -183,6 +391,54 @@ S32 BitStream::readClassId(U32 classType, U32 classGroup)
     return ret;
 }
 
+//-----------------------------------------------------------------------------
+// Word at a time bit access.  A run of up to 32 bits at any bit position lies
+// within the 8 bytes starting at its first byte, so it is read, or merged in,
+// with one unaligned 64 bit load (and store).  That is only done while those
+// 8 bytes are inside the buffer, the byte loops handle the end of it.  The
+// bytes written and read are the same as the byte loops', see
+// bitStreamBenchmark().
+
+#ifdef TORQUE_LITTLE_ENDIAN
+#define TORQUE_BITSTREAM_WORD_ACCESS
+#endif
+
+#ifdef TORQUE_BITSTREAM_WORD_ACCESS
+
+static inline U64 loadWord(const U8* ptr)
+{
+    U64 word;
+    memcpy(&word, ptr, sizeof(word));
+    return word;
+}
+
+static inline void storeWord(U8* ptr, U64 word)
+{
+    memcpy(ptr, &word, sizeof(word));
+}
+
+/// Writes the low @a bitCount (1-32) bits of @a value at @a bitNum.  Like the
+/// byte loop it keeps the bits before bitNum and clears the rest of the last
+/// byte it writes to.
+static inline void writeWordBits(U8* dataPtr, S32 bitNum, U32 value, S32 bitCount)
+{
+    U8* ptr = dataPtr + (bitNum >> 3);
+    S32 shift = bitNum & 0x7;
+    S32 endBit = (shift + bitCount + 7) & ~7;
+
+    U64 keep = ((U64(1) << shift) - 1) | ~((U64(1) << endBit) - 1);
+    U64 bits = (U64(value) & ((U64(1) << bitCount) - 1)) << shift;
+    storeWord(ptr, (loadWord(ptr) & keep) | bits);
+}
+
+/// Returns the stream bits starting at @a bitNum, at least 32 valid ones.
+static inline U64 readWordBits(const U8* dataPtr, S32 bitNum)
+{
+    return loadWord(dataPtr + (bitNum >> 3)) >> (bitNum & 0x7);
+}
+
+#endif // TORQUE_BITSTREAM_WORD_ACCESS
+
 void BitStream::writeBits(S32 bitCount, const void* bitPtr)
 {
     if (!bitCount)
@@ -195,6 +451,25 @@ void BitStream::writeBits(S32 bitCount, const void* bitPtr)
         return;
     }
     const U8* ptr = (U8*)bitPtr;
+
+#ifdef TORQUE_BITSTREAM_WORD_ACCESS
+    // Packet streams may be written past bufSize, up to maxWriteBitNum
+    S32 writableBytes = getMax(bufSize, maxWriteBitNum >> 3);
+    while ((bitNum >> 3) + 8 <= writableBytes)
+    {
+        S32 count = getMin(bitCount, 32);
+        U32 value = 0;
+        memcpy(&value, ptr, (count + 7) >> 3);
+        writeWordBits(dataPtr, bitNum, value, count);
+
+        ptr += 4;
+        bitNum += count;
+        bitCount -= count;
+        if (!bitCount)
+            return;
+    }
+#endif
+
     U8* stPtr = dataPtr + (bitNum >> 3);
     U8* endPtr = dataPtr + ((bitCount + bitNum - 1) >> 3);
 
@@ -258,11 +533,27 @@ void BitStream::readBits(S32 bitCount, void* bitPtr)
         AssertWarn(false, "Out of range read");
         return;
     }
+    U8* ptr = (U8*)bitPtr;
+
+#ifdef TORQUE_BITSTREAM_WORD_ACCESS
+    while ((bitNum >> 3) + 8 <= bufSize)
+    {
+        // The last byte gets the stream bits that follow, like the byte loop
+        S32 count = getMin(bitCount, 32);
+        U32 value = U32(readWordBits(dataPtr, bitNum));
+        memcpy(ptr, &value, (count + 7) >> 3);
+
+        ptr += 4;
+        bitNum += count;
+        bitCount -= count;
+        if (!bitCount)
+            return;
+    }
+#endif
+
     U8* stPtr = dataPtr + (bitNum >> 3);
     S32 byteCount = (bitCount + 7) >> 3;
 
-    U8* ptr = (U8*)bitPtr;
-
     S32 downShift = bitNum & 0x7;
     S32 upShift = 8 - downShift;
 
@@ -293,6 +584,15 @@ bool BitStream::_write(U32 size, const void* dataPtr)
 
 S32 BitStream::readInt(S32 bitCount)
 {
+#ifdef TORQUE_BITSTREAM_WORD_ACCESS
+    if (bitCount + bitNum <= maxReadBitNum && (bitNum >> 3) + 8 <= bufSize)
+    {
+        U32 bits = U32(readWordBits(dataPtr, bitNum));
+        bitNum += bitCount;
+        return bitCount == 32 ? S32(bits) : S32(bits & ((1 << bitCount) - 1));
+    }
+#endif
+
     S32 ret = 0;
     readBits(bitCount, &ret);
     ret = convertLEndianToHost(ret);
@@ -305,6 +605,17 @@ S32 BitStream::readInt(S32 bitCount)
 
 void BitStream::writeInt(S32 val, S32 bitCount)
 {
+#ifdef TORQUE_BITSTREAM_WORD_ACCESS
+    // Skips the virtual writeBits, which only has to be called to grow the
+    // buffer of an InfiniteBitStream if the bits don't fit
+    if (bitCount > 0 && bitCount + bitNum <= maxWriteBitNum && (bitNum >> 3) + 8 <= getMax(bufSize, maxWriteBitNum >> 3))
+    {
+        writeWordBits(dataPtr, bitNum, U32(val), bitCount);
+        bitNum += bitCount;
+        return;
+    }
+#endif
+
     val = convertHostToLEndian(val);
     writeBits(bitCount, &val);
 }
@@ -668,7 +979,7 @@ void InfiniteBitStream::validate(U32 upcomingBytes)
 {
     if (getPosition() + upcomingBytes + mMinSpace > bufSize)
     {
-        bufSize = getPosition() + upcomingBytes + mMinSpace;
+        bufSize = getMax(getPosition() + upcomingBytes + mMinSpace, U32(bufSize + bufSize / 2));
         dataPtr = (U8*)dRealloc(dataPtr, bufSize);
 
         maxReadBitNum = bufSize << 3;
@@ -815,6 +1126,30 @@ void HuffmanProcessor::buildTables()
     BitStream bs(&code, 4);
 
     generateCodes(bs, 0, 0);
+    buildLookup();
+}
+
+void HuffmanProcessor::buildLookup()
+{
+    for (S32 bits = 0; bits < LookupSize; bits++) {
+        S32 index = 0;
+        S32 depth = 0;
+        while (index >= 0 && depth < LookupBits) {
+            HuffNode& rNode = m_huffNodes[index];
+            index = (bits >> depth) & 1 ? rNode.index1 : rNode.index0;
+            depth++;
+        }
+
+        HuffLookup& rLookup = m_lookup[bits];
+        if (index < 0) {
+            rLookup.index = m_huffLeaves[-(index + 1)].symbol;
+            rLookup.numBits = U8(depth);
+        }
+        else {
+            rLookup.index = S16(index);
+            rLookup.numBits = 0;
+        }
+    }
 }
 
 void HuffmanProcessor::generateCodes(BitStream& rBS, S32 index, S32 depth)
@@ -825,6 +1160,11 @@ void HuffmanProcessor::generateCodes(BitStream& rBS, S32 index, S32 depth)
 
         dMemcpy(&rLeaf.code, rBS.dataPtr, sizeof(rLeaf.code));
         rLeaf.numBits = depth;
+
+        // The bits past depth are left over from deeper branches.
+        rLeaf.code = convertLEndianToHost(rLeaf.code);
+        if (depth < 32)
+            rLeaf.code &= (1 << depth) - 1;
     }
     else {
         HuffNode& rNode = m_huffNodes[index];
@@ -865,6 +1205,24 @@ bool HuffmanProcessor::readHuffBuffer(BitStream* pStream, char* out_pBuffer)
         S32 len = pStream->readInt(8);
         for (S32 i = 0; i < len; i++) {
             S32 index = 0;
+
+            // Look up the next LookupBits at once while they are in the stream,
+            //  the end of it is left to the bit by bit walk.
+            S32 bitNum = pStream->bitNum;
+            if (bitNum + LookupBits <= pStream->maxReadBitNum && (bitNum >> 3) + 3 <= pStream->bufSize) {
+                const U8* pBytes = pStream->dataPtr + (bitNum >> 3);
+                U32 bits = (pBytes[0] | (pBytes[1] << 8) | (pBytes[2] << 16)) >> (bitNum & 0x7);
+
+                const HuffLookup& rLookup = m_lookup[bits & (LookupSize - 1)];
+                if (rLookup.numBits) {
+                    out_pBuffer[i] = char(rLookup.index);
+                    pStream->bitNum = bitNum + rLookup.numBits;
+                    continue;
+                }
+                index = rLookup.index;
+                pStream->bitNum = bitNum + LookupBits;
+            }
+
             while (true) {
                 if (index >= 0) {
                     if (pStream->readFlag() == true) {
@@ -909,23 +1267,40 @@ bool HuffmanProcessor::writeHuffBuffer(BitStream* pStream, const char* out_pBuff
     if (len > maxLen)
         len = maxLen;
 
-    S32 numBits = 0;
-    S32 i;
-    for (i = 0; i < len; i++)
-        numBits += m_huffLeaves[(unsigned char)out_pBuffer[i]].numBits;
+    // Code the string as we go, and give up on it as soon as it is no shorter
+    //  than the raw bytes.
+    U32 codeWords[(MaxHuffChars * 8) / 32 + 1];
+    S32 numWords = 0;
+    U64 accum = 0;
+    S32 accumBits = 0;
+
+    S32 rawBits = len * 8;
+    S32 numBits = len <= MaxHuffChars ? 0 : rawBits;
+    for (S32 i = 0; i < len && numBits < rawBits; i++) {
+        HuffLeaf& rLeaf = m_huffLeaves[((unsigned char)out_pBuffer[i])];
+        accum |= U64(rLeaf.code) << accumBits;
+        accumBits += rLeaf.numBits;
+        numBits += rLeaf.numBits;
+
+        if (accumBits >= 32) {
+            codeWords[numWords++] = convertHostToLEndian(U32(accum));
+            accum >>= 32;
+            accumBits -= 32;
+        }
+    }
 
-    if (numBits >= (len * 8)) {
+    if (numBits >= rawBits) {
         pStream->writeFlag(false);
         pStream->writeInt(len, 8);
         pStream->write(len, out_pBuffer);
     }
     else {
+        if (accumBits)
+            codeWords[numWords] = convertHostToLEndian(U32(accum));
+
         pStream->writeFlag(true);
         pStream->writeInt(len, 8);
-        for (i = 0; i < len; i++) {
-            HuffLeaf& rLeaf = m_huffLeaves[((unsigned char)out_pBuffer[i])];
-            pStream->writeBits(rLeaf.numBits, &rLeaf.code);
-        }
+        pStream->writeBits(numBits, codeWords);
     }
 
     return true;
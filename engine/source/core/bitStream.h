@@ -230,6 +230,55 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+/// Pool of MaxPacketDataSize buffers for building outgoing packets.
+///
+/// Buffers come off a lock free free list, so any thread can build a packet in
+/// a buffer of its own without touching the heap.  The pool grows a block of
+/// buffers at a time when it runs dry, up to MaxBlocks, and never shrinks.
+/// Past that buffers are allocated on the heap and freed on release.
+class PacketBufferPool
+{
+public:
+    enum
+    {
+        BuffersPerBlock = 32,
+        MaxBlocks = 64,
+    };
+
+    struct Stats
+    {
+        U32 buffers;        ///< Buffers owned by the pool.
+        U32 inUse;          ///< Buffers handed out right now.
+        U32 peakInUse;
+        U32 acquires;       ///< Buffers handed out since startup.
+        U32 heapBuffers;    ///< Ones that had to come from the heap.
+    };
+
+    /// Hands out a buffer of MaxPacketDataSize bytes.
+    static U8* acquire();
+
+    /// Takes back a buffer from acquire().
+    static void release(U8* buffer);
+
+    static Stats getStats();
+};
+
+/// BitStream bound to a PacketBufferPool buffer, for building one outgoing
+/// packet.  Unlike getPacketStream() every PacketStream has its own buffer, so
+/// packets can be built concurrently or while another one is being sent.
+class PacketStream : public BitStream
+{
+public:
+    /// @a writeSize limits the packet, 0 allows MaxPacketDataSize.
+    PacketStream(U32 writeSize = 0);
+    ~PacketStream();
+
+    /// Sends what was written so far.
+    void sendTo(const NetAddress* addr);
+};
+
 //------------------------------------------------------------------------------
 //-------------------------------------- INLINES
 //
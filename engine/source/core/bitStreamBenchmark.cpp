@@ -0,0 +1,303 @@
+//-----------------------------------------------------------------------------
+// Torque Game Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "core/bitStream.h"
+#include "console/console.h"
+#include "math/mRandom.h"
+
+//-----------------------------------------------------------------------------
+// Reference bit access, the byte loops BitStream used before it read and wrote
+// a word at a time.  The fuzz pass checks the stream encoding against these.
+// Note refWriteBits() may read one source byte past the bits it writes.
+
+static void refWriteBits(U8* dataPtr, S32 bitNum, S32 bitCount, const void* bitPtr)
+{
+    if (!bitCount)
+        return;
+
+    const U8* ptr = (U8*)bitPtr;
+    U8* stPtr = dataPtr + (bitNum >> 3);
+    U8* endPtr = dataPtr + ((bitCount + bitNum - 1) >> 3);
+
+    S32 upShift = bitNum & 0x7;
+    S32 downShift = 8 - upShift;
+    U8 lastMask = 0xFF >> (7 - ((bitNum + bitCount - 1) & 0x7));
+    U8 startMask = 0xFF >> downShift;
+
+    U8 curB = *ptr++;
+    *stPtr = (curB << upShift) | (*stPtr & startMask);
+
+    stPtr++;
+    while (stPtr <= endPtr)
+    {
+        U8 nextB = *ptr++;
+        *stPtr++ = (curB >> downShift) | (nextB << upShift);
+        curB = nextB;
+    }
+    *endPtr &= lastMask;
+}
+
+static void refReadBits(const U8* dataPtr, S32 bufSize, S32 bitNum, S32 bitCount, void* bitPtr)
+{
+    if (!bitCount)
+        return;
+
+    const U8* stPtr = dataPtr + (bitNum >> 3);
+    S32 byteCount = (bitCount + 7) >> 3;
+
+    U8* ptr = (U8*)bitPtr;
+
+    S32 downShift = bitNum & 0x7;
+    S32 upShift = 8 - downShift;
+
+    U8 curB = *stPtr;
+    const U8* stEnd = dataPtr + bufSize;
+    while (byteCount--)
+    {
+        stPtr++;
+        U8 nextB = stPtr < stEnd ? *stPtr : 0;
+        *ptr++ = (curB >> downShift) | (nextB << upShift);
+        curB = nextB;
+    }
+}
+
+/// Just enough of a BitStream on top of the reference functions to run the
+/// benchmark pattern through them.
+struct RefBitStream
+{
+    U8* dataPtr;
+    S32 bufSize;
+    S32 bitNum;
+
+    RefBitStream(U8* data, S32 size) : dataPtr(data), bufSize(size), bitNum(0) {}
+
+    bool writeFlag(bool val)
+    {
+        if (val)
+            dataPtr[bitNum >> 3] |= (1 << (bitNum & 0x7));
+        else
+            dataPtr[bitNum >> 3] &= ~(1 << (bitNum & 0x7));
+        bitNum++;
+        return val;
+    }
+
+    bool readFlag()
+    {
+        bool ret = (dataPtr[bitNum >> 3] & (1 << (bitNum & 0x7))) != 0;
+        bitNum++;
+        return ret;
+    }
+
+    void writeInt(S32 val, S32 bitCount)
+    {
+        U32 bits[2] = { U32(val), 0 };
+        refWriteBits(dataPtr, bitNum, bitCount, bits);
+        bitNum += bitCount;
+    }
+
+    S32 readInt(S32 bitCount)
+    {
+        S32 ret = 0;
+        refReadBits(dataPtr, bufSize, bitNum, bitCount, &ret);
+        bitNum += bitCount;
+        return bitCount == 32 ? ret : ret & ((1 << bitCount) - 1);
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+    enum
+    {
+        FuzzBufferSize = 256,
+        FuzzRounds = 20000,
+        BenchBufferSize = 1 << 20,
+        UpdateBits = 1 + 10 + 32 + 1 + 3 * 20 + 1 + 9 + 7,
+    };
+}
+
+/// A typical ghost update: ghost index, mask, a position and a few small
+/// fields, about 15 bytes.
+template<class Stream>
+static void writeGhostUpdate(Stream& stream, U32 i)
+{
+    stream.writeFlag(true);
+    stream.writeInt(i & 1023, 10);
+    stream.writeInt(i * 2654435761u, 32);
+    if (stream.writeFlag((i & 3) != 0))
+    {
+        stream.writeInt(i & 0xFFFFF, 20);
+        stream.writeInt((i >> 3) & 0xFFFFF, 20);
+        stream.writeInt((i >> 6) & 0xFFFFF, 20);
+    }
+    if (stream.writeFlag((i & 1) != 0))
+        stream.writeInt(i & 511, 9);
+    stream.writeInt(i % 100, 7);
+}
+
+template<class Stream>
+static U32 readGhostUpdate(Stream& stream)
+{
+    U32 sum = stream.readFlag();
+    sum += stream.readInt(10);
+    sum += stream.readInt(32);
+    if (stream.readFlag())
+    {
+        sum += stream.readInt(20);
+        sum += stream.readInt(20);
+        sum += stream.readInt(20);
+    }
+    if (stream.readFlag())
+        sum += stream.readInt(9);
+    sum += stream.readInt(7);
+    return sum;
+}
+
+/// Runs random writes and reads of random sizes at random places, near the
+/// end of the buffer as well, through a BitStream and the reference functions
+/// and returns the number of times their bytes differed.
+static U32 fuzzBitStream(MRandomLCG& rand, U32& opCount)
+{
+    U8 streamData[FuzzBufferSize];
+    U8 refData[FuzzBufferSize];
+    U8 source[12];
+    U8 streamOut[8];
+    U8 refOut[8];
+    U32 mismatches = 0;
+
+    for (U32 round = 0; round < FuzzRounds; round++)
+    {
+        // Random garbage, both sides have to leave the same bits alone
+        for (U32 i = 0; i < FuzzBufferSize; i++)
+            streamData[i] = refData[i] = U8(rand.randI(0, 255));
+
+        S32 size = rand.randI(1, FuzzBufferSize);
+        BitStream stream(streamData, size, size);
+
+        S32 bitNum = rand.randI(0, size * 8 - 1);
+        S32 bitCount = rand.randI(0, getMin(size * 8 - bitNum, 64));
+        for (U32 i = 0; i < sizeof(source); i++)
+            source[i] = U8(rand.randI(0, 255));
+
+        U32 op = rand.randI(0, 3);
+        opCount++;
+
+        if (op == 0)
+        {
+            stream.setCurPos(bitNum);
+            stream.writeBits(bitCount, source);
+            refWriteBits(refData, bitNum, bitCount, source);
+        }
+        else if (op == 1)
+        {
+            bitCount = getMin(bitCount, 32);
+            U32 val[2] = { 0, 0 };
+            dMemcpy(val, source, sizeof(U32));
+            stream.setCurPos(bitNum);
+            stream.writeInt(S32(val[0]), bitCount);
+            refWriteBits(refData, bitNum, bitCount, val);
+        }
+        else if (op == 2)
+        {
+            dMemset(streamOut, 0, sizeof(streamOut));
+            dMemset(refOut, 0, sizeof(refOut));
+            stream.setCurPos(bitNum);
+            stream.readBits(bitCount, streamOut);
+            refReadBits(refData, size, bitNum, bitCount, refOut);
+            if (dMemcmp(streamOut, refOut, sizeof(streamOut)))
+                mismatches++;
+        }
+        else
+        {
+            bitCount = getMin(bitCount, 32);
+            S32 ref = 0;
+            refReadBits(refData, size, bitNum, bitCount, &ref);
+            if (bitCount != 32)
+                ref &= (1 << bitCount) - 1;
+            stream.setCurPos(bitNum);
+            if (stream.readInt(bitCount) != ref)
+                mismatches++;
+        }
+
+        if (stream.getCurPos() != bitNum + bitCount || dMemcmp(streamData, refData, sizeof(streamData)))
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+template<class Stream>
+static U32 timeGhostWrites(U8* data, U32 count)
+{
+    U32 start = Platform::getRealMilliseconds();
+    Stream stream(data, BenchBufferSize);
+    for (U32 i = 0; i < count; i++)
+        writeGhostUpdate(stream, i);
+    return Platform::getRealMilliseconds() - start;
+}
+
+template<class Stream>
+static U32 timeGhostReads(U8* data, U32 count, U32& sum)
+{
+    U32 start = Platform::getRealMilliseconds();
+    Stream stream(data, BenchBufferSize);
+    for (U32 i = 0; i < count; i++)
+        sum += readGhostUpdate(stream);
+    return Platform::getRealMilliseconds() - start;
+}
+
+/// BitStream with the writable size of the benchmark buffer.
+struct BenchBitStream : public BitStream
+{
+    BenchBitStream(U8* data, S32 size) : BitStream(data, size, size) {}
+};
+
+static F32 getMBPerSec(U32 bytes, U32 ms)
+{
+    return F32(bytes) / (1024.0f * 1024.0f) / (getMax(ms, U32(1)) / 1000.0f);
+}
+
+ConsoleFunction(bitStreamBenchmark, void, 1, 2, "bitStreamBenchmark( [passes] );"
+    "Checks the BitStream encoding against the byte at a time reference bit for bit on random "
+    "reads and writes, then writes and reads typical ghost updates through both and prints MB/s.")
+{
+    U32 passes = argc > 1 ? getMax(dAtoi(argv[1]), 1) : 20;
+
+    MRandomLCG rand(1376312589);
+    U32 opCount = 0;
+    U32 mismatches = fuzzBitStream(rand, opCount);
+
+    Con::printf("BitStream benchmark: %d passes", passes);
+    Con::printf("   fuzz: %d random ops, %d mismatches%s", opCount, mismatches, mismatches ? " - ENCODING CHANGED" : "");
+
+    // Leave room for the last update
+    U32 count = (BenchBufferSize * 8 - 2 * UpdateBits) / UpdateBits;
+    U8* refData = new U8[BenchBufferSize];
+    U8* streamData = new U8[BenchBufferSize];
+    dMemset(refData, 0, BenchBufferSize);
+    dMemset(streamData, 0, BenchBufferSize);
+
+    U32 refWrite = 0, streamWrite = 0, refRead = 0, streamRead = 0;
+    U32 refSum = 0, streamSum = 0;
+    for (U32 pass = 0; pass < passes; pass++)
+    {
+        refWrite += timeGhostWrites<RefBitStream>(refData, count);
+        streamWrite += timeGhostWrites<BenchBitStream>(streamData, count);
+        refRead += timeGhostReads<RefBitStream>(refData, count, refSum);
+        streamRead += timeGhostReads<BenchBitStream>(streamData, count, streamSum);
+    }
+
+    U32 bytes = passes * ((count * UpdateBits) >> 3);
+    bool same = refSum == streamSum && !dMemcmp(refData, streamData, BenchBufferSize);
+    Con::printf("   %d ghost updates per pass, %s", count, same ? "same bytes" : "BYTES DIFFER");
+    Con::printf("   %-8s %12s  %12s", "", "byte loops", "BitStream");
+    Con::printf("   %-8s %7.1f MB/s  %7.1f MB/s", "write", getMBPerSec(bytes, refWrite), getMBPerSec(bytes, streamWrite));
+    Con::printf("   %-8s %7.1f MB/s  %7.1f MB/s", "read", getMBPerSec(bytes, refRead), getMBPerSec(bytes, streamRead));
+
+    delete[] refData;
+    delete[] streamData;
+}
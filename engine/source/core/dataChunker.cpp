@@ -15,6 +15,7 @@ DataChunker::DataChunker(S32 size)
     curBlock = new DataBlock(size);
     curBlock->next = NULL;
     curBlock->curIndex = 0;
+    freeBlock = NULL;
 }
 
 DataChunker::~DataChunker()
@@ -27,7 +28,11 @@ void* DataChunker::alloc(S32 size)
     AssertFatal(size <= chunkSize, "Data chunk too large.");
     if (!curBlock || size + curBlock->curIndex > chunkSize)
     {
-        DataBlock* temp = new DataBlock(chunkSize);
+        DataBlock* temp = freeBlock;
+        if (temp)
+            freeBlock = temp->next;
+        else
+            temp = new DataBlock(chunkSize);
         temp->next = curBlock;
         temp->curIndex = 0;
         curBlock = temp;
@@ -55,5 +60,32 @@ void DataChunker::freeBlocks()
         delete curBlock;
         curBlock = temp;
     }
+    while (freeBlock)
+    {
+        DataBlock* temp = freeBlock->next;
+        delete freeBlock;
+        freeBlock = temp;
+    }
+}
+
+void DataChunker::reset(S32 maxKeptBlocks)
+{
+    S32 keptBlocks = 0;
+    for (DataBlock* walk = freeBlock; walk; walk = walk->next)
+        keptBlocks++;
+
+    while (curBlock)
+    {
+        DataBlock* temp = curBlock->next;
+        if (keptBlocks < maxKeptBlocks)
+        {
+            curBlock->next = freeBlock;
+            freeBlock = curBlock;
+            keptBlocks++;
+        }
+        else
+            delete curBlock;
+        curBlock = temp;
+    }
 }
 
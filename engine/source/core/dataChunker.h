@@ -43,6 +43,7 @@ private:
         ~DataBlock();
     };
     DataBlock* curBlock;
+    DataBlock* freeBlock;   ///< Blocks kept by reset() for reuse.
     S32 chunkSize;
 
 public:
@@ -61,6 +62,12 @@ public:
     /// This invalidates all pointers returned from alloc().
     void freeBlocks();
 
+    /// Make all the memory available again, keeping up to @a maxKeptBlocks
+    /// of the blocks to hand out before new ones get allocated.
+    ///
+    /// This invalidates all pointers returned from alloc().
+    void reset(S32 maxKeptBlocks);
+
     /// Initialize using blocks of a given size.
     ///
     /// One new block is allocated at constructor-time.
@@ -0,0 +1,161 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "core/frameArena.h"
+#include "platform/platformMutex.h"
+#include "console/console.h"
+
+FrameArena*        FrameArena::smArenaList = NULL;
+void*              FrameArena::smArenaListMutex = NULL;
+FrameArena::Stats  FrameArena::smLastFrameStats = { 0, 0, 0, 0 };
+U32                FrameArena::smPeakBytes = 0;
+
+static thread_local FrameArena* sgThreadArena = NULL;
+
+FrameArena::FrameArena(const U32 pageSize)
+{
+    mFirstPage = NULL;
+    mCurPage = NULL;
+    mPageSize = pageSize;
+    mNextArena = NULL;
+    mFrameStats.clear();
+}
+
+FrameArena::~FrameArena()
+{
+    Page* walk = mFirstPage;
+    while (walk)
+    {
+        Page* next = walk->next;
+        dFree(walk);
+        walk = next;
+    }
+    mFirstPage = mCurPage = NULL;
+}
+
+void* FrameArena::allocSlow(const U32 size, const U32 align)
+{
+    // Move on to the next retained page that is big enough.  Pages we skip
+    // are simply left partially used until the next reset.
+    Page* page = mCurPage ? mCurPage->next : mFirstPage;
+    Page* prev = mCurPage;
+    while (page && page->size < size + align)
+    {
+        prev = page;
+        page = page->next;
+    }
+
+    if (page == NULL)
+    {
+        U32 pageSize = getMax(mPageSize, size + align);
+        page = static_cast<Page*>(dMalloc(sizeof(Page) + pageSize));
+        page->size = pageSize;
+        page->next = NULL;
+
+        if (prev)
+            prev->next = page;
+        else
+            mFirstPage = page;
+
+        mFrameStats.heapAllocs++;
+    }
+
+    page->used = 0;
+    mCurPage = page;
+
+    void* ret = alloc(size, align);
+    AssertFatal(mCurPage == page, "FrameArena::allocSlow - fresh page did not satisfy the request.");
+    return ret;
+}
+
+void FrameArena::reset(Stats& stats)
+{
+    stats.bytes += mFrameStats.bytes;
+    stats.allocs += mFrameStats.allocs;
+    stats.heapAllocs += mFrameStats.heapAllocs;
+
+    for (Page* walk = mFirstPage; walk; walk = walk->next)
+    {
+        walk->used = 0;
+        stats.reservedBytes += walk->size;
+    }
+
+    mCurPage = mFirstPage;
+    mFrameStats.clear();
+}
+
+FrameArena* FrameArena::get()
+{
+    if (sgThreadArena == NULL)
+    {
+        AssertFatal(smArenaListMutex != NULL, "FrameArena::get - FrameArena::init() has not been called.");
+
+        sgThreadArena = new FrameArena;
+
+        Mutex::lockMutex(smArenaListMutex);
+        sgThreadArena->mNextArena = smArenaList;
+        smArenaList = sgThreadArena;
+        Mutex::unlockMutex(smArenaListMutex);
+    }
+
+    return sgThreadArena;
+}
+
+void FrameArena::init()
+{
+    AssertFatal(smArenaListMutex == NULL, "FrameArena::init - already initialized.");
+    smArenaListMutex = Mutex::createMutex();
+
+    // Create the main thread's arena up front.
+    get();
+}
+
+void FrameArena::endFrame()
+{
+    Stats stats;
+    stats.clear();
+
+    for (FrameArena* walk = smArenaList; walk; walk = walk->mNextArena)
+        walk->reset(stats);
+
+    smLastFrameStats = stats;
+    if (stats.bytes > smPeakBytes)
+        smPeakBytes = stats.bytes;
+}
+
+void FrameArena::destroy()
+{
+    FrameArena* walk = smArenaList;
+    while (walk)
+    {
+        FrameArena* next = walk->mNextArena;
+        delete walk;
+        walk = next;
+    }
+    smArenaList = NULL;
+    sgThreadArena = NULL;
+
+    if (smArenaListMutex)
+    {
+        Mutex::destroyMutex(smArenaListMutex);
+        smArenaListMutex = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+ConsoleFunction(getFrameArenaStats, const char*, 1, 1, "getFrameArenaStats();"
+    "Returns \"bytes allocs heapAllocs reservedBytes peakBytes\" for the last rendered frame. "
+    "heapAllocs should be 0 once the scene has reached a steady state.")
+{
+    argc; argv;
+
+    const FrameArena::Stats& stats = FrameArena::getLastFrameStats();
+
+    char* ret = Con::getReturnBuffer(128);
+    dSprintf(ret, 128, "%d %d %d %d %d", stats.bytes, stats.allocs, stats.heapAllocs,
+        stats.reservedBytes, FrameArena::getPeakBytes());
+    return ret;
+}
@@ -0,0 +1,219 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _FRAMEARENA_H_
+#define _FRAMEARENA_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+/// Growable linear allocator for records that only live for one rendered frame.
+///
+/// This is the big brother of the FrameAllocator.  Where the FrameAllocator is a
+/// single fixed block with a manually managed watermark, a FrameArena is a chain
+/// of pages that grows on demand and is rewound in one step by FrameArena::endFrame()
+/// once the frame has been presented.  Pages are never handed back to the heap
+/// while the arena is alive, so once a scene has been rendered a few times the
+/// arena has reached its high water mark and further frames do no heap work at all.
+///
+/// Each thread gets its own arena through FrameArena::get(), so no locking is
+/// needed on the allocation path.
+///
+/// @code
+///   RenderInst* inst = FrameArena::get()->alloc<RenderInst>();
+///   ZoneState* zones = FrameArena::get()->allocArray<ZoneState>(numZones);
+/// @endcode
+///
+/// @note Destructors are never run on arena memory.  Only place records in here
+///       whose lifetime ends with the frame, or destruct them yourself with
+///       destructInPlace() before the frame ends.
+class FrameArena
+{
+public:
+    enum
+    {
+        DefaultPageSize = 256 << 10,  ///< Size of a freshly allocated page, larger requests get their own page.
+        DefaultAlignment = 16,        ///< Alignment of allocations, suitable for matrices and SIMD data.
+    };
+
+    /// Allocation counters, collected per frame.
+    struct Stats
+    {
+        U32 bytes;          ///< Bytes handed out by alloc() (excluding padding).
+        U32 allocs;         ///< Number of alloc() calls.
+        U32 heapAllocs;     ///< Number of pages that had to come from the heap.
+        U32 reservedBytes;  ///< Total size of the pages held by the arena(s).
+
+        void clear() { bytes = allocs = heapAllocs = reservedBytes = 0; }
+    };
+
+private:
+    struct Page
+    {
+        Page* next;
+        U32   size;
+        U32   used;
+
+        U8* data() { return reinterpret_cast<U8*>(this + 1); }
+    };
+
+    Page* mFirstPage;     ///< Head of the retained page chain.
+    Page* mCurPage;       ///< Page allocations are currently served from.
+    U32   mPageSize;
+
+    Stats mFrameStats;    ///< Counters for the frame in progress.
+
+    FrameArena* mNextArena;   ///< Link in the list of all per-thread arenas.
+
+    static FrameArena* smArenaList;
+    static void*       smArenaListMutex;
+    static Stats       smLastFrameStats;
+    static U32         smPeakBytes;
+
+    void* allocSlow(const U32 size, const U32 align);
+
+    /// Rewinds every page and folds this arena's counters into @a stats.
+    void reset(Stats& stats);
+
+public:
+    FrameArena(const U32 pageSize = DefaultPageSize);
+    ~FrameArena();
+
+    /// Returns a chunk of memory that stays valid until the end of the frame.
+    inline void* alloc(const U32 size, const U32 align = DefaultAlignment);
+
+    template<class T>
+    T* alloc() { return reinterpret_cast<T*>(alloc(sizeof(T), getMax(U32(DefaultAlignment), U32(alignof(T))))); }
+
+    template<class T>
+    T* allocArray(const U32 count) { return reinterpret_cast<T*>(alloc(sizeof(T) * count, getMax(U32(DefaultAlignment), U32(alignof(T))))); }
+
+    /// Returns the arena belonging to the calling thread, creating it on first use.
+    static FrameArena* get();
+
+    /// Sets up the arena bookkeeping and the main thread's arena.
+    static void init();
+
+    /// Rewinds the arenas of all threads and latches their counters as the
+    /// stats of the frame that just finished.
+    ///
+    /// Must be called from the main thread while no other thread is allocating
+    /// from its arena; GuiCanvas::renderFrame() does this after presenting.
+    static void endFrame();
+
+    /// Releases every per-thread arena.  Only valid at shutdown.
+    static void destroy();
+
+    /// Counters for the last completed frame, summed over all threads.
+    static const Stats& getLastFrameStats() { return smLastFrameStats; }
+
+    /// Largest number of bytes handed out in any one frame so far.
+    static U32 getPeakBytes() { return smPeakBytes; }
+};
+
+inline void* FrameArena::alloc(const U32 size, const U32 align)
+{
+    AssertFatal(align != 0 && (align & (align - 1)) == 0, "FrameArena::alloc - alignment must be a power of two.");
+
+    if (mCurPage)
+    {
+        dsize_t base = dsize_t(mCurPage->data());
+        dsize_t offset = ((base + mCurPage->used + align - 1) & ~dsize_t(align - 1)) - base;
+        if (offset + size <= mCurPage->size)
+        {
+            mCurPage->used = U32(offset + size);
+            mFrameStats.bytes += size;
+            mFrameStats.allocs++;
+            return reinterpret_cast<void*>(base + offset);
+        }
+    }
+
+    return allocSlow(size, align);
+}
+
+//-----------------------------------------------------------------------------
+
+/// Minimal Vector replacement whose storage comes from a FrameArena.
+///
+/// Growing abandons the old storage in the arena rather than freeing it, which
+/// is fine since it all goes away at the end of the frame.  Only use this for
+/// plain data; elements are copied with dMemcpy and never destructed.
+template<class T>
+class FrameVector
+{
+    FrameArena* mArena;
+    T* mArray;
+    U32 mElementCount;
+    U32 mArraySize;
+
+    void grow(const U32 count)
+    {
+        U32 newSize = getMax(mArraySize ? mArraySize * 2 : 8, count);
+        T* newArray = mArena->allocArray<T>(newSize);
+        if (mElementCount)
+            dMemcpy(newArray, mArray, mElementCount * sizeof(T));
+        mArray = newArray;
+        mArraySize = newSize;
+    }
+
+public:
+    FrameVector(FrameArena* arena = FrameArena::get())
+        : mArena(arena), mArray(NULL), mElementCount(0), mArraySize(0)
+    {
+    }
+
+    U32  size() const { return mElementCount; }
+    bool empty() const { return mElementCount == 0; }
+    T* address() { return mArray; }
+    const T* address() const { return mArray; }
+
+    void clear() { mElementCount = 0; }
+
+    void reserve(const U32 count)
+    {
+        if (count > mArraySize)
+            grow(count);
+    }
+
+    void setSize(const U32 count)
+    {
+        reserve(count);
+        mElementCount = count;
+    }
+
+    void increment()
+    {
+        if (mElementCount == mArraySize)
+            grow(mElementCount + 1);
+        mElementCount++;
+    }
+
+    void push_back(const T& x)
+    {
+        increment();
+        mArray[mElementCount - 1] = x;
+    }
+
+    T& last()
+    {
+        AssertFatal(mElementCount != 0, "FrameVector::last - empty vector");
+        return mArray[mElementCount - 1];
+    }
+
+    T& operator[](const U32 index)
+    {
+        AssertFatal(index < mElementCount, "FrameVector index out of range");
+        return mArray[index];
+    }
+
+    const T& operator[](const U32 index) const
+    {
+        AssertFatal(index < mElementCount, "FrameVector index out of range");
+        return mArray[index];
+    }
+};
+
+#endif  // _FRAMEARENA_H_
@@ -5,6 +5,7 @@
 
 #include "platform/platform.h"
 #include "core/stringTable.h"
+#include "platform/platformMutex.h"
 
 _StringTable* StringTable = NULL;
 const U32 _StringTable::csm_stInitSize = 29;
@@ -47,6 +48,25 @@ U32 _StringTable::hashString(const char* str)
     return ret;
 }
 
+/// Continues hashString() over more characters.
+static inline U32 hashContinue(U32 ret, const char* str)
+{
+    char c;
+    while ((c = *str++) != 0) {
+        ret <<= 1;
+        ret ^= sgHashTable[static_cast<U8>(c)];
+    }
+    return ret;
+}
+
+/// True if @a val is @a prefix followed by @a suffix.
+static inline bool matchConcat(const char* val, const char* prefix, const U32 prefixLen, const char* suffix, const bool caseSens)
+{
+    if (caseSens)
+        return !dStrncmp(val, prefix, prefixLen) && !dStrcmp(val + prefixLen, suffix);
+    return !dStrnicmp(val, prefix, prefixLen) && !dStricmp(val + prefixLen, suffix);
+}
+
 U32 _StringTable::hashStringn(const char* str, S32 len)
 {
     if (sgInitTable)
@@ -71,12 +91,16 @@ _StringTable::_StringTable()
 
     numBuckets = csm_stInitSize;
     itemCount = 0;
+
+    mMutex = Mutex::createMutex();
+    mThreadSafe = false;
 }
 
 //--------------------------------------
 _StringTable::~_StringTable()
 {
     dFree(buckets);
+    Mutex::destroyMutex(mMutex);
 }
 
 
@@ -100,6 +124,10 @@ void _StringTable::destroy()
 //--------------------------------------
 StringTableEntry _StringTable::insert(const char* val, const bool  caseSens)
 {
+    MutexHandle handle;
+    if (mThreadSafe)
+        handle.lock(mMutex);
+
     Node** walk, * temp;
     U32 key = hashString(val);
     walk = &buckets[key % numBuckets];
@@ -135,9 +163,62 @@ StringTableEntry _StringTable::insertn(const char* src, S32 len, const bool  cas
     return insert(val, caseSens);
 }
 
+//--------------------------------------
+StringTableEntry _StringTable::insertConcat(const char* prefix, const char* suffix, const bool caseSens)
+{
+    MutexHandle handle;
+    if (mThreadSafe)
+        handle.lock(mMutex);
+
+    Node** walk, * temp;
+    U32 key = hashContinue(hashString(prefix), suffix);
+    U32 prefixLen = dStrlen(prefix);
+    walk = &buckets[key % numBuckets];
+    while ((temp = *walk) != NULL) {
+        if (matchConcat(temp->val, prefix, prefixLen, suffix, caseSens))
+            return temp->val;
+        walk = &(temp->next);
+    }
+
+    U32 suffixLen = dStrlen(suffix);
+    *walk = (Node*)mempool.alloc(sizeof(Node));
+    (*walk)->next = 0;
+    (*walk)->val = (char*)mempool.alloc(prefixLen + suffixLen + 1);
+    dMemcpy((*walk)->val, prefix, prefixLen);
+    dMemcpy((*walk)->val + prefixLen, suffix, suffixLen + 1);
+    StringTableEntry ret = (*walk)->val;
+    itemCount++;
+
+    if (itemCount > 2 * numBuckets) {
+        resize(4 * numBuckets - 1);
+    }
+    return ret;
+}
+
+//--------------------------------------
+StringTableEntry _StringTable::lookupConcat(const char* prefix, const char* suffix, const bool caseSens)
+{
+    MutexHandle handle;
+    if (mThreadSafe)
+        handle.lock(mMutex);
+
+    Node* walk;
+    U32 key = hashContinue(hashString(prefix), suffix);
+    U32 prefixLen = dStrlen(prefix);
+    for (walk = buckets[key % numBuckets]; walk; walk = walk->next) {
+        if (matchConcat(walk->val, prefix, prefixLen, suffix, caseSens))
+            return walk->val;
+    }
+    return NULL;
+}
+
 //--------------------------------------
 StringTableEntry _StringTable::lookup(const char* val, const bool  caseSens)
 {
+    MutexHandle handle;
+    if (mThreadSafe)
+        handle.lock(mMutex);
+
     Node** walk, * temp;
     U32 key = hashString(val);
     walk = &buckets[key % numBuckets];
@@ -154,6 +235,10 @@ StringTableEntry _StringTable::lookup(const char* val, const bool  caseSens)
 //--------------------------------------
 StringTableEntry _StringTable::lookupn(const char* val, S32 len, const bool  caseSens)
 {
+    MutexHandle handle;
+    if (mThreadSafe)
+        handle.lock(mMutex);
+
     Node** walk, * temp;
     U32 key = hashStringn(val, len);
     walk = &buckets[key % numBuckets];
@@ -202,4 +287,10 @@ void _StringTable::resize(const U32 newSize)
         temp->next = buckets[key % newSize];
         buckets[key % newSize] = temp;
     }
-}
\ No newline at end of file
+}
+
+//--------------------------------------
+void _StringTable::setThreadSafe(bool threadSafe)
+{
+    mThreadSafe = threadSafe;
+}
@@ -74,6 +74,9 @@ private:
     U32         itemCount;
     DataChunker mempool;
 
+    void* mMutex;
+    bool  mThreadSafe;
+
 protected:
     static const U32 csm_stInitSize;
 
@@ -123,6 +126,13 @@ public:
     /// @param  caseSens Determines whether case matters.
     StringTableEntry lookupn(const char* string, S32 len, bool caseSens = false);
 
+    /// Same as insert() on @a prefix and @a suffix joined together, without
+    /// joining them.  Used for array fields, "name" plus "index".
+    StringTableEntry insertConcat(const char* prefix, const char* suffix, bool caseSens = false);
+
+    /// Same as lookup() on @a prefix and @a suffix joined together.
+    StringTableEntry lookupConcat(const char* prefix, const char* suffix, bool caseSens = false);
+
 
     /// Resize the StringTable to be able to hold newSize items. This
     /// is called automatically by the StringTable when the table is
@@ -131,6 +141,11 @@ public:
     /// @param newSize   Number of new items to allocate space for.
     void             resize(const U32 newSize);
 
+    /// Makes insert() and lookup() take a lock while several threads use the
+    /// table, such as during CodeBlock::precompileScripts().  The table is
+    /// otherwise only used from the main thread, so this is off by default.
+    void setThreadSafe(bool threadSafe);
+
     /// Hash a string into a U32.
     static U32 hashString(const char* in_pString);
 
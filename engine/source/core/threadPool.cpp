@@ -0,0 +1,151 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "core/threadPool.h"
+#include "platform/platformThread.h"
+#include "platform/platformMutex.h"
+#include "platform/platformSemaphore.h"
+#include "console/console.h"
+
+#include <atomic>
+#include <thread>
+
+ThreadPool* ThreadPool::smPool = NULL;
+
+static thread_local bool sgIsPoolWorker = false;
+
+/// Index dispenser and completion count for the job in flight.
+struct ThreadPool::Counters
+{
+    std::atomic<U32> nextIndex;
+    std::atomic<U32> busyWorkers;
+};
+
+ThreadPool::ThreadPool(const U32 numThreads)
+{
+    mNumThreads = getMin(numThreads, U32(MaxThreads));
+    mWakeSemaphore = Semaphore::createSemaphore(0);
+    mDoneSemaphore = Semaphore::createSemaphore(0);
+    mJobMutex = Mutex::createMutex();
+
+    mJobFunction = NULL;
+    mJobData = NULL;
+    mJobCount = 0;
+    mShutdown = false;
+
+    mCounters = new Counters;
+    mCounters->nextIndex = 0;
+    mCounters->busyWorkers = 0;
+
+    for (U32 i = 0; i < mNumThreads; i++)
+        mThreads[i] = new Thread(workerMain, this, true);
+}
+
+ThreadPool::~ThreadPool()
+{
+    mShutdown = true;
+    for (U32 i = 0; i < mNumThreads; i++)
+        Semaphore::releaseSemaphore(mWakeSemaphore);
+
+    for (U32 i = 0; i < mNumThreads; i++)
+        delete mThreads[i];
+
+    delete mCounters;
+    Mutex::destroyMutex(mJobMutex);
+    Semaphore::destroySemaphore(mDoneSemaphore);
+    Semaphore::destroySemaphore(mWakeSemaphore);
+}
+
+void ThreadPool::workerMain(void* arg)
+{
+    ThreadPool* pool = static_cast<ThreadPool*>(arg);
+    sgIsPoolWorker = true;
+
+    for (;;)
+    {
+        Semaphore::acquireSemaphore(pool->mWakeSemaphore);
+        if (pool->mShutdown)
+            break;
+
+        pool->runJob();
+
+        if (--pool->mCounters->busyWorkers == 0)
+            Semaphore::releaseSemaphore(pool->mDoneSemaphore);
+    }
+}
+
+void ThreadPool::runJob()
+{
+    for (;;)
+    {
+        U32 index = mCounters->nextIndex++;
+        if (index >= mJobCount)
+            break;
+        mJobFunction(index, mJobData);
+    }
+}
+
+void ThreadPool::parallelFor(const U32 count, JobFunction fn, void* data, const bool enabled)
+{
+    AssertFatal(fn != NULL, "ThreadPool::parallelFor - no job function.");
+
+    U32 wake = getMin(mNumThreads, count ? count - 1 : 0);
+    if (!enabled || wake == 0 || isWorkerThread())
+    {
+        for (U32 i = 0; i < count; i++)
+            fn(i, data);
+        return;
+    }
+
+    MutexHandle handle;
+    handle.lock(mJobMutex);
+
+    mJobFunction = fn;
+    mJobData = data;
+    mJobCount = count;
+    mCounters->nextIndex = 0;
+    mCounters->busyWorkers = wake;
+
+    for (U32 i = 0; i < wake; i++)
+        Semaphore::releaseSemaphore(mWakeSemaphore);
+
+    runJob();
+
+    // Every woken worker has to check in before the job description may be
+    // reused, even if the calling thread drained the index range itself.
+    Semaphore::acquireSemaphore(mDoneSemaphore);
+
+    mJobFunction = NULL;
+    mJobData = NULL;
+    mJobCount = 0;
+}
+
+bool ThreadPool::isWorkerThread()
+{
+    return sgIsPoolWorker;
+}
+
+void ThreadPool::init()
+{
+    AssertFatal(smPool == NULL, "ThreadPool::init - already initialized.");
+
+    U32 cores = std::thread::hardware_concurrency();
+    smPool = new ThreadPool(cores > 1 ? cores - 1 : 0);
+}
+
+void ThreadPool::destroy()
+{
+    delete smPool;
+    smPool = NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+ConsoleFunction(getThreadPoolSize, S32, 1, 1, "getThreadPoolSize();"
+    "Returns the number of worker threads available for parallel jobs such as lightmap baking.")
+{
+    argc; argv;
+    return ThreadPool::get() ? ThreadPool::get()->getNumThreads() : 0;
+}
@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+class Thread;
+
+/// Fixed set of worker threads for splitting CPU heavy loops.
+///
+/// The pool only knows how to do one thing: run a function over a range of
+/// indices using every worker plus the calling thread, and return once all of
+/// them have been processed.  Indices are handed out one at a time, so uneven
+/// work items balance themselves.
+///
+/// @code
+///   static void lightSurface(U32 index, void* data)
+///   {
+///      SurfaceJob* jobs = static_cast<SurfaceJob*>(data);
+///      jobs[index].lightmap->sgCalculateLighting(...);
+///   }
+///
+///   ThreadPool::get()->parallelFor(jobs.size(), lightSurface, jobs.address());
+/// @endcode
+///
+/// The job function must not touch the console, the GFX device or the sim; do
+/// that work on the calling thread before or after the parallelFor().
+class ThreadPool
+{
+public:
+    typedef void (*JobFunction)(U32 index, void* data);
+
+    enum
+    {
+        MaxThreads = 16,   ///< Upper limit on worker threads, regardless of core count.
+    };
+
+private:
+    Thread* mThreads[MaxThreads];
+    U32     mNumThreads;
+
+    void* mWakeSemaphore;   ///< Released once per worker that should pick up the current job.
+    void* mDoneSemaphore;   ///< Released by the last worker to finish the current job.
+    void* mJobMutex;        ///< Serializes parallelFor() callers.
+
+    JobFunction mJobFunction;
+    void*       mJobData;
+    U32         mJobCount;
+    bool        mShutdown;
+
+    struct Counters;
+    Counters* mCounters;
+
+    static ThreadPool* smPool;
+
+    static void workerMain(void* arg);
+    void runJob();
+
+public:
+    ThreadPool(const U32 numThreads);
+    ~ThreadPool();
+
+    /// Number of worker threads, not counting the thread calling parallelFor().
+    U32 getNumThreads() const { return mNumThreads; }
+
+    /// Calls @a fn for every index in [0, count) and returns when all calls
+    /// have completed.  The calling thread takes part in the work.
+    ///
+    /// Nested calls from inside a job, or calls while @a enabled is false,
+    /// simply run serially on the calling thread.
+    void parallelFor(const U32 count, JobFunction fn, void* data, const bool enabled = true);
+
+    /// Returns the shared pool, sized to the machine's core count.
+    static ThreadPool* get() { return smPool; }
+
+    /// True when called from one of the pool's worker threads.
+    static bool isWorkerThread();
+
+    static void init();
+    static void destroy();
+};
+
+#endif  // _THREADPOOL_H_
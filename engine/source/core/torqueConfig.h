@@ -21,7 +21,7 @@
 /// Version number is major * 1000 + minor * 100 + revision * 10.
 /// Different engines (TGE, T2D, etc.) will have different version numbers.
 #define TORQUE_VERSION              907 // version 0.9
-#define TORQUE_PROTOCOL_VERSION     14  // increment this when we change the protocol
+#define TORQUE_PROTOCOL_VERSION     15  // increment this when we change the protocol
 
 /// What engine are we running? The presence and value of this define are
 /// used to determine what engine (TGE, T2D, etc.) and version thereof we're
@@ -105,6 +105,12 @@
 // Define me to use MBG physics
 //#define MBG_PHYSICS
 
+// Define me to run the F64 Point3D math used by marble physics on SSE2. The SSE2
+// code keeps the operation order of the plain C++ code, so results are bit for bit
+// identical and recordings stay in sync (see mVerifyPoint3DSimd). Only takes effect
+// when the compiler targets SSE2, which is always the case on x64.
+#define TORQUE_SIMD_POINT3D
+
 // Define me to force marble to correct size
 #define MB_FORCE_MARBLE_SIZE
 
@@ -37,6 +37,8 @@
 #include "sceneGraph/sceneGraph.h"
 #include "fxFoliageReplicator.h"
 #include "renderInstance/renderInstMgr.h"
+#include "platform/platformMutex.h"
+#include "core/threadPool.h"
 
 #pragma warning( push, 4 )
 // I just could not get rid of this warning without flat out disabling it. ;/
@@ -276,33 +278,91 @@ bool fxFoliageRenderList::IsQuadrantVisible(const Box3F VisBox, const MatrixF& R
 
 
 //------------------------------------------------------------------------------
+// Parallel placement.
 //
-// Class: fxFoliageCulledList
-//
+// Placement is split into fixed size batches, each with its own random generator
+// seeded from the replicator seed and the batch number.  A batch always places
+// its items the same way no matter which thread runs it, so a given seed gives
+// the same foliage on every client whatever the number of cores.
 //------------------------------------------------------------------------------
-fxFoliageCulledList::fxFoliageCulledList(Box3F SearchBox, fxFoliageCulledList* InVec)
+
+// Where a single Foliage item ended up, filled in on the pool threads.
+struct fxFoliagePlacement
 {
-    // Find the Candidates.
-    FindCandidates(SearchBox, InVec);
-}
+    Point3F     Position;
+    F32         Width;
+    F32         Height;
+    bool        Flipped;
+    bool        Placed;
+};
+
+struct fxFoliagePlacementJob
+{
+    fxFoliageReplicator*        pReplicator;
+    VectorPtr<SceneObject*>     Objects;        // Objects Foliage may be placed on.
+    Vector<fxFoliagePlacement>  Placements;     // One per requested Foliage item.
+    void*                       CastRayMutex;   // Serializes rays against non-interior objects.
 
-//------------------------------------------------------------------------------
+    static void AddObject(SceneObject* pObject, void* key)
+    {
+        static_cast<fxFoliagePlacementJob*>(key)->Objects.push_back(pObject);
+    }
 
-void fxFoliageCulledList::FindCandidates(Box3F SearchBox, fxFoliageCulledList* InVec)
-{
-    // Search the Culled List.
-    for (U32 i = 0; i < InVec->GetListCount(); i++)
+    // Same as Container::castRay() but only against the gathered objects, so
+    // it is safe to call from the pool.  Interior rays only read the BSP, other
+    // shapes may animate their instance while casting so they go one at a time.
+    bool CastRay(const Point3F& Start, const Point3F& End, U32 Mask, RayInfo* pInfo)
     {
-        // Is this Box overlapping our search box?
-        if (SearchBox.isOverlapped(InVec->GetElement(i)->FoliageBox))
+        F32 CurrentT = 2.0f;
+        for (U32 i = 0; i < Objects.size(); i++)
         {
-            // Yes, so add it to our culled list.
-            mCulledObjectSet.push_back(InVec->GetElement(i));
+            SceneObject* pObject = Objects[i];
+            if (!(pObject->getTypeMask() & Mask) || !pObject->isCollisionEnabled())
+                continue;
+            if (!pObject->getWorldBox().collideLine(Start, End) && !pObject->isGlobalBounds())
+                continue;
+
+            Point3F XformedStart, XformedEnd;
+            pObject->getWorldTransform().mulP(Start, &XformedStart);
+            pObject->getWorldTransform().mulP(End, &XformedEnd);
+            XformedStart.convolveInverse(pObject->getScale());
+            XformedEnd.convolveInverse(pObject->getScale());
+
+            RayInfo Info;
+            bool Hit;
+            if (pObject->getTypeMask() & InteriorObjectType)
+                Hit = pObject->castRay(XformedStart, XformedEnd, &Info);
+            else
+            {
+                MutexHandle Handle;
+                Handle.lock(CastRayMutex);
+                Hit = pObject->castRay(XformedStart, XformedEnd, &Info);
+            }
+
+            if (Hit && Info.t < CurrentT)
+            {
+                *pInfo = Info;
+                pInfo->point.interpolate(Start, End, pInfo->t);
+                CurrentT = Info.t;
+            }
         }
+        return CurrentT < 2.0f;
     }
-}
+};
 
+struct fxFoliageLeafJob
+{
+    fxFoliageReplicator*    pReplicator;
+    Box3F                   RootBox;
+    Vector<U64>*            BatchKeys;      // Leaf path << 32 | item index, one vector per batch.
+};
 
+static S32 QSORT_CALLBACK cmpFoliageLeafKeys(const void* a, const void* b)
+{
+    U64 KeyA = *(const U64*)a;
+    U64 KeyB = *(const U64*)b;
+    return (KeyA < KeyB) ? -1 : ((KeyA > KeyB) ? 1 : 0);
+}
 
 //------------------------------------------------------------------------------
 //
@@ -598,6 +658,13 @@ void fxFoliageReplicator::CreateFoliage(void)
     // Calculate the quad-tree levels needed for selected 'mCullResolution'.
     mQuadTreeLevels = (U32)(mCeil(mLog(MaxDimension / mFieldData.mCullResolution) / mLog(2.0f)));
 
+    // Leaf paths only have room for so many levels, huge areas get coarser leaves.
+    if (mQuadTreeLevels > MaxQuadTreeLevels)
+    {
+        Con::warnf(ConsoleLogEntry::General, "fxFoliageReplicator - Culling Resolution too fine for the Foliage area, limited to %d Quad-tree levels.", U32(MaxQuadTreeLevels));
+        mQuadTreeLevels = MaxQuadTreeLevels;
+    }
+
     // Calculate the number of potential nodes required.
     mPotentialFoliageNodes = 0;
     for (U32 n = 0; n <= mQuadTreeLevels; n++)
@@ -607,89 +674,47 @@ void fxFoliageReplicator::CreateFoliage(void)
     // Step 2.
     // ----------------------------------------------------------------------------------------------------------------------
 
-    // Set Seed.
-    RandomGen.setSeed(mFieldData.mSeed);
+    // Gather everything foliage could land on, the rays are cast against this
+    // list on the pool threads rather than through the container.
+    fxFoliagePlacementJob Job;
+    Job.pReplicator = this;
+    Job.CastRayMutex = Mutex::createMutex();
+
+    Box3F PlacementBox;
+    PlacementBox.min = getPosition() - Point3F(mFieldData.mOuterRadiusX, mFieldData.mOuterRadiusY, 0);
+    PlacementBox.max = getPosition() + Point3F(mFieldData.mOuterRadiusX, mFieldData.mOuterRadiusY, 0);
+    PlacementBox.min.z = -2000.f;
+    PlacementBox.max.z = 2000.f;
+    getCurrentClientContainer()->findObjects(PlacementBox, FXFOLIAGEREPLICATOR_COLLISION_MASK, fxFoliagePlacementJob::AddObject, &Job);
+
+    // Place Foliage in independent batches.
+    U32 BatchCount = (mFieldData.mFoliageCount + FoliageBatchSize - 1) / FoliageBatchSize;
+    Job.Placements.setSize(mFieldData.mFoliageCount);
+
+    bool Parallel = Con::getBoolVariable("$pref::Foliage::parallelPlacement", true);
+    if (ThreadPool::get())
+        ThreadPool::get()->parallelFor(BatchCount, PlaceFoliageBatch, &Job, Parallel);
+    else
+        for (U32 batch = 0; batch < BatchCount; batch++)
+            PlaceFoliageBatch(batch, &Job);
 
     // Add Foliage.
+    U32 RelocationFailures = 0;
     for (U32 idx = 0; idx < mFieldData.mFoliageCount; idx++)
     {
+        const fxFoliagePlacement& Placement = Job.Placements[idx];
         fxFoliageItem* pFoliageItem;
         Point3F			FoliageOffsetPos;
 
-        // Reset Relocation Retry.
-        RelocationRetry = mFieldData.mFoliageRetries;
-
-        // Find it a home ...
-        do
-        {
-            // Get the fxFoliageReplicator Position.
-            FoliagePosition = getPosition();
-
-            // Calculate a random offset
-            HypX = RandomGen.randF((F32)mFieldData.mInnerRadiusX, (F32)mFieldData.mOuterRadiusX);
-            HypY = RandomGen.randF((F32)mFieldData.mInnerRadiusY, (F32)mFieldData.mOuterRadiusY);
-            Angle = RandomGen.randF(0, (F32)M_2PI);
-
-            // Calcualte the new position.
-            FoliagePosition.x += HypX * mCos(Angle);
-            FoliagePosition.y += HypY * mSin(Angle);
-
-            // Initialise RayCast Search Start/End Positions.
-            FoliageStart = FoliageEnd = FoliagePosition;
-            FoliageStart.z = 2000.f;
-            FoliageEnd.z = -2000.f;
-
-            // Perform Ray Cast Collision on Client.
-            CollisionResult = getCurrentClientContainer()->castRay(FoliageStart, FoliageEnd, FXFOLIAGEREPLICATOR_COLLISION_MASK, &RayEvent);
-
-            // Did we hit anything?
-            if (CollisionResult)
-            {
-                // For now, let's pretend we didn't get a collision.
-                CollisionResult = false;
-
-                // Yes, so get it's type.
-                U32 CollisionType = RayEvent.object->getTypeMask();
-
-                // Check Illegal Placements, fail if we hit a disallowed type.
-                if (((CollisionType & TerrainObjectType) && !mFieldData.mAllowOnTerrain) ||
-                    ((CollisionType & InteriorObjectType) && !mFieldData.mAllowOnInteriors) ||
-                    ((CollisionType & StaticTSObjectType) && !mFieldData.mAllowStatics) ||
-                    ((CollisionType & WaterObjectType) && !mFieldData.mAllowOnWater)) continue;
-
-                // If we collided with water and are not allowing on the water surface then let's find the
-                // terrain underneath and pass this on as the original collision else fail.
-                if ((CollisionType & WaterObjectType) && !mFieldData.mAllowWaterSurface &&
-                    !getCurrentClientContainer()->castRay(FoliageStart, FoliageEnd, FXFOLIAGEREPLICATOR_NOWATER_COLLISION_MASK, &RayEvent)) continue;
-
-                // We passed with flying colour so carry on.
-                CollisionResult = true;
-            }
-
-            // Invalidate if we are below Allowed Terrain Angle.
-            if (RayEvent.normal.z < mSin(mDegToRad(90.0f - mFieldData.mAllowedTerrainSlope))) CollisionResult = false;
-
-            // Wait until we get a collision.
-        } while (!CollisionResult && --RelocationRetry);
-
-        // Check for Relocation Problem.
-        if (RelocationRetry > 0)
+        // Skip Foliage that didn't find a home.
+        if (!Placement.Placed)
         {
-            // Adjust Impact point.
-            RayEvent.point.z += mFieldData.mOffsetZ;
-
-            // Set New Position.
-            FoliagePosition = RayEvent.point;
-        }
-        else
-        {
-            // Warning.
-            Con::warnf(ConsoleLogEntry::General, "fxFoliageReplicator - Could not find satisfactory position for Foliage!");
-
-            // Skip to next.
+            RelocationFailures++;
             continue;
         }
 
+        FoliagePosition = Placement.Position;
+
         // Monitor the total volume.
         FoliageOffsetPos = FoliagePosition - getPosition();
         MinPoint.setMin(FoliageOffsetPos);
@@ -707,39 +732,10 @@ void fxFoliageReplicator::CreateFoliage(void)
         // Set Position.
         pFoliageItem->Transform.setColumn(3, FoliagePosition);
 
-        // Are we fixing size @ max?
-        if (mFieldData.mFixSizeToMax)
-        {
-            // Yes, so set height maximum height.
-            pFoliageItem->Height = mFieldData.mMaxHeight;
-            // Is the Aspect Ratio Fixed?
-            if (mFieldData.mFixAspectRatio)
-                // Yes, so lock to height.
-                pFoliageItem->Width = pFoliageItem->Height;
-            else
-                // No, so set width to maximum width.
-                pFoliageItem->Width = mFieldData.mMaxWidth;
-        }
-        else
-        {
-            // No, so choose a new Scale.
-            pFoliageItem->Height = RandomGen.randF(mFieldData.mMinHeight, mFieldData.mMaxHeight);
-            // Is the Aspect Ratio Fixed?
-            if (mFieldData.mFixAspectRatio)
-                // Yes, so lock to height.
-                pFoliageItem->Width = pFoliageItem->Height;
-            else
-                // No, so choose a random width.
-                pFoliageItem->Width = RandomGen.randF(mFieldData.mMinWidth, mFieldData.mMaxWidth);
-        }
-
-        // Are we randomly flipping horizontally?
-        if (mFieldData.mRandomFlip)
-            // Yes, so choose a random flip for this object.
-            pFoliageItem->Flipped = (RandomGen.randF(0, 1000) < 500.0f) ? false : true;
-        else
-            // No, so turn-off flipping.
-            pFoliageItem->Flipped = false;
+        // Set Size and Flip.
+        pFoliageItem->Height = Placement.Height;
+        pFoliageItem->Width = Placement.Width;
+        pFoliageItem->Flipped = Placement.Flipped;
 
         // Calculate Foliage Item World Box.
         // NOTE:-	We generate a psuedo-volume here.  It's basically the volume to which the
@@ -780,6 +776,13 @@ void fxFoliageReplicator::CreateFoliage(void)
         mCurrentFoliageCount++;
     }
 
+    // Warning.
+    if (RelocationFailures)
+        Con::warnf(ConsoleLogEntry::General, "fxFoliageReplicator - Could not find satisfactory position for %d Foliage items!", RelocationFailures);
+
+    // Set Seed for the per-item animation phases.
+    RandomGen.setSeed(mFieldData.mSeed);
+
     // Is Lighting On?
     if (mFieldData.mLightOn)
     {
@@ -864,33 +867,28 @@ void fxFoliageReplicator::CreateFoliage(void)
     // Reset Next Allocated Node to Stack base.
     mNextAllocatedNodeIdx = 0;
 
-    // Allocate a new Node.
-    fxFoliageQuadrantNode* pNewNode = new fxFoliageQuadrantNode;
+    // Find the leaf quadrants of every billboard on the pool, then build the
+    // Quad-tree from the sorted leaves.
+    fxFoliageLeafJob LeafJob;
+    LeafJob.pReplicator = this;
+    LeafJob.RootBox = getWorldBox();
+    BatchCount = (mCurrentFoliageCount + FoliageBatchSize - 1) / FoliageBatchSize;
+    LeafJob.BatchKeys = new Vector<U64>[BatchCount ? BatchCount : 1];
 
-    // Store it in the Quad-tree.
-    mFoliageQuadTree.push_back(pNewNode);
+    if (ThreadPool::get())
+        ThreadPool::get()->parallelFor(BatchCount, FindFoliageLeaves, &LeafJob, Parallel);
+    else
+        for (U32 batch = 0; batch < BatchCount; batch++)
+            FindFoliageLeaves(batch, &LeafJob);
 
-    // Populate Initial Node.
-    //
-    // Set Start Level.
-    pNewNode->Level = mQuadTreeLevels;
-    // Calculate Total Foliage Area.
-    pNewNode->QuadrantBox = getWorldBox();
-    // Reset Quadrant child nodes.
-    pNewNode->QuadrantChildNode[0] =
-        pNewNode->QuadrantChildNode[1] =
-        pNewNode->QuadrantChildNode[2] =
-        pNewNode->QuadrantChildNode[3] = NULL;
-
-    // Create our initial cull list with *all* billboards into.
-    fxFoliageCulledList CullList;
-    CullList.mCulledObjectSet = mReplicatedFoliage;
+    Vector<U64> LeafKeys;
+    for (U32 batch = 0; batch < BatchCount; batch++)
+        LeafKeys.merge(LeafJob.BatchKeys[batch]);
+    delete[] LeafJob.BatchKeys;
 
-    // Move to next node Index.
-    mNextAllocatedNodeIdx++;
+    BuildQuadTree(LeafKeys);
 
-    // Let's start this thing going by recursing it's children.
-    ProcessNodeChildren(pNewNode, &CullList);
+    Mutex::destroyMutex(Job.CastRayMutex);
 
     // Calculate Elapsed Time and take new Timestamp.
     F32 ElapsedTime = (Platform::getRealMilliseconds() - mStartCreationTime) * 0.001f;
@@ -1052,64 +1050,248 @@ Box3F fxFoliageReplicator::FetchQuadrant(Box3F Box, U32 Quadrant)
 
 //------------------------------------------------------------------------------
 
-void fxFoliageReplicator::ProcessNodeChildren(fxFoliageQuadrantNode* pParentNode, fxFoliageCulledList* pCullList)
+void fxFoliageReplicator::PlaceFoliageBatch(U32 Batch, void* pData)
 {
-    // ---------------------------------------------------------------
-    // Split Node into Quadrants and Process each.
-    // ---------------------------------------------------------------
+    fxFoliagePlacementJob* pJob = static_cast<fxFoliagePlacementJob*>(pData);
+    fxFoliageReplicator* pReplicator = pJob->pReplicator;
+    const tagFieldData& FieldData = pReplicator->mFieldData;
+
+    F32				HypX, HypY;
+    F32				Angle;
+    U32				RelocationRetry;
+    Point3F			FoliagePosition;
+    Point3F			FoliageStart;
+    Point3F			FoliageEnd;
+    bool			CollisionResult;
+    RayInfo			RayEvent;
+
+    // Seed this batch, keeping the seed within the generator's valid range.
+    U32 BatchSeed = FieldData.mSeed ^ ((Batch + 1) * 0x9E3779B9);
+    MRandomLCG BatchRandom(S32(BatchSeed % (U32(S32_MAX) - 1)) + 1);
+
+    RayEvent.normal.set(0, 0, 1);
+
+    U32 FirstIdx = Batch * FoliageBatchSize;
+    U32 LastIdx = getMin(FirstIdx + FoliageBatchSize, FieldData.mFoliageCount);
+    for (U32 idx = FirstIdx; idx < LastIdx; idx++)
+    {
+        fxFoliagePlacement& Placement = pJob->Placements[idx];
+        Placement.Placed = false;
+
+        // Reset Relocation Retry.
+        RelocationRetry = FieldData.mFoliageRetries;
+
+        // Find it a home ...
+        do
+        {
+            // Get the fxFoliageReplicator Position.
+            FoliagePosition = pReplicator->getPosition();
+
+            // Calculate a random offset
+            HypX = BatchRandom.randF((F32)FieldData.mInnerRadiusX, (F32)FieldData.mOuterRadiusX);
+            HypY = BatchRandom.randF((F32)FieldData.mInnerRadiusY, (F32)FieldData.mOuterRadiusY);
+            Angle = BatchRandom.randF(0, (F32)M_2PI);
+
+            // Calcualte the new position.
+            FoliagePosition.x += HypX * mCos(Angle);
+            FoliagePosition.y += HypY * mSin(Angle);
+
+            // Initialise RayCast Search Start/End Positions.
+            FoliageStart = FoliageEnd = FoliagePosition;
+            FoliageStart.z = 2000.f;
+            FoliageEnd.z = -2000.f;
+
+            // Perform Ray Cast Collision.
+            CollisionResult = pJob->CastRay(FoliageStart, FoliageEnd, FXFOLIAGEREPLICATOR_COLLISION_MASK, &RayEvent);
+
+            // Did we hit anything?
+            if (CollisionResult)
+            {
+                // For now, let's pretend we didn't get a collision.
+                CollisionResult = false;
+
+                // Yes, so get it's type.
+                U32 CollisionType = RayEvent.object->getTypeMask();
+
+                // Check Illegal Placements, fail if we hit a disallowed type.
+                if (((CollisionType & TerrainObjectType) && !FieldData.mAllowOnTerrain) ||
+                    ((CollisionType & InteriorObjectType) && !FieldData.mAllowOnInteriors) ||
+                    ((CollisionType & StaticTSObjectType) && !FieldData.mAllowStatics) ||
+                    ((CollisionType & WaterObjectType) && !FieldData.mAllowOnWater)) continue;
+
+                // If we collided with water and are not allowing on the water surface then let's find the
+                // terrain underneath and pass this on as the original collision else fail.
+                if ((CollisionType & WaterObjectType) && !FieldData.mAllowWaterSurface &&
+                    !pJob->CastRay(FoliageStart, FoliageEnd, FXFOLIAGEREPLICATOR_NOWATER_COLLISION_MASK, &RayEvent)) continue;
+
+                // We passed with flying colour so carry on.
+                CollisionResult = true;
+            }
+
+            // Invalidate if we are below Allowed Terrain Angle.
+            if (RayEvent.normal.z < mSin(mDegToRad(90.0f - FieldData.mAllowedTerrainSlope))) CollisionResult = false;
+
+            // Wait until we get a collision.
+        } while (!CollisionResult && --RelocationRetry);
+
+        // Check for Relocation Problem, these are reported once all batches are done.
+        if (RelocationRetry == 0)
+            continue;
+
+        // Adjust Impact point.
+        RayEvent.point.z += FieldData.mOffsetZ;
+
+        // Set New Position.
+        Placement.Position = RayEvent.point;
+
+        // Are we fixing size @ max?
+        if (FieldData.mFixSizeToMax)
+        {
+            // Yes, so set height maximum height.
+            Placement.Height = FieldData.mMaxHeight;
+            // Is the Aspect Ratio Fixed?
+            if (FieldData.mFixAspectRatio)
+                // Yes, so lock to height.
+                Placement.Width = Placement.Height;
+            else
+                // No, so set width to maximum width.
+                Placement.Width = FieldData.mMaxWidth;
+        }
+        else
+        {
+            // No, so choose a new Scale.
+            Placement.Height = BatchRandom.randF(FieldData.mMinHeight, FieldData.mMaxHeight);
+            // Is the Aspect Ratio Fixed?
+            if (FieldData.mFixAspectRatio)
+                // Yes, so lock to height.
+                Placement.Width = Placement.Height;
+            else
+                // No, so choose a random width.
+                Placement.Width = BatchRandom.randF(FieldData.mMinWidth, FieldData.mMaxWidth);
+        }
+
+        // Are we randomly flipping horizontally?
+        if (FieldData.mRandomFlip)
+            // Yes, so choose a random flip for this object.
+            Placement.Flipped = (BatchRandom.randF(0, 1000) < 500.0f) ? false : true;
+        else
+            // No, so turn-off flipping.
+            Placement.Flipped = false;
+
+        Placement.Placed = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void fxFoliageReplicator::FindFoliageLeaves(U32 Batch, void* pData)
+{
+    fxFoliageLeafJob* pJob = static_cast<fxFoliageLeafJob*>(pData);
+    fxFoliageReplicator* pReplicator = pJob->pReplicator;
+
+    U32 FirstIdx = Batch * FoliageBatchSize;
+    U32 LastIdx = getMin(FirstIdx + FoliageBatchSize, pReplicator->mCurrentFoliageCount);
+    for (U32 idx = FirstIdx; idx < LastIdx; idx++)
+        pReplicator->FindLeafQuadrants(pJob->RootBox, pReplicator->mQuadTreeLevels, 0, idx, pJob->BatchKeys[Batch]);
+}
+
+//------------------------------------------------------------------------------
+
+void fxFoliageReplicator::FindLeafQuadrants(const Box3F& Box, U32 Level, U32 Path, U32 ItemIdx, Vector<U64>& Keys)
+{
+    const Box3F& FoliageBox = mReplicatedFoliage[ItemIdx]->FoliageBox;
 
     // Process All Quadrants (UL/UR/LL/LR).
     for (U32 q = 0; q < 4; q++)
-        ProcessQuadrant(pParentNode, pCullList, q);
+    {
+        // A billboard only goes into the quadrants it overlaps, all the way down.
+        const Box3F QuadrantBox = FetchQuadrant(Box, q);
+        if (!QuadrantBox.isOverlapped(FoliageBox))
+            continue;
+
+        U32 QuadrantPath = (Path << 2) | q;
+        if (Level == 1)
+            Keys.push_back((U64(QuadrantPath) << 32) | ItemIdx);
+        else
+            FindLeafQuadrants(QuadrantBox, Level - 1, QuadrantPath, ItemIdx, Keys);
+    }
 }
 
 //------------------------------------------------------------------------------
 
-void fxFoliageReplicator::ProcessQuadrant(fxFoliageQuadrantNode* pParentNode, fxFoliageCulledList* pCullList, U32 Quadrant)
+fxFoliageQuadrantNode* fxFoliageReplicator::AllocateQuadrantNode(U32 Level, const Box3F& QuadrantBox)
 {
-    // Fetch Quadrant Box.
-    const Box3F QuadrantBox = FetchQuadrant(pParentNode->QuadrantBox, Quadrant);
+    // Allocate a new Node.
+    fxFoliageQuadrantNode* pNewNode = new fxFoliageQuadrantNode;
 
-    // Create our new Cull List.
-    fxFoliageCulledList CullList(QuadrantBox, pCullList);
+    // Store it in the Quad-tree.
+    mFoliageQuadTree.push_back(pNewNode);
 
-    // Did we get any objects?
-    if (CullList.GetListCount() > 0)
-    {
-        // Yes, so allocate a new Node.
-        fxFoliageQuadrantNode* pNewNode = new fxFoliageQuadrantNode;
+    // Move to next node Index.
+    mNextAllocatedNodeIdx++;
+
+    // Populate Quadrant Node.
+    pNewNode->Level = Level;
+    pNewNode->QuadrantBox = QuadrantBox;
+    // Reset Child Nodes.
+    pNewNode->QuadrantChildNode[0] =
+        pNewNode->QuadrantChildNode[1] =
+        pNewNode->QuadrantChildNode[2] =
+        pNewNode->QuadrantChildNode[3] = NULL;
 
-        // Store it in the Quad-tree.
-        mFoliageQuadTree.push_back(pNewNode);
+    return pNewNode;
+}
 
-        // Move to next node Index.
-        mNextAllocatedNodeIdx++;
+//------------------------------------------------------------------------------
 
-        // Populate Quadrant Node.
-        //
-        // Next Sub-level.
-        pNewNode->Level = pParentNode->Level - 1;
-        // Calculate Quadrant Box.
-        pNewNode->QuadrantBox = QuadrantBox;
-        // Reset Child Nodes.
-        pNewNode->QuadrantChildNode[0] =
-            pNewNode->QuadrantChildNode[1] =
-            pNewNode->QuadrantChildNode[2] =
-            pNewNode->QuadrantChildNode[3] = NULL;
-
-        // Put a reference in parent.
-        pParentNode->QuadrantChildNode[Quadrant] = pNewNode;
-
-        // If we're not at sub-level 0 then process this nodes children.
-        if (pNewNode->Level != 0) ProcessNodeChildren(pNewNode, &CullList);
-        // If we've reached sub-level 0 then store Cull List (for rendering).
-        if (pNewNode->Level == 0)
+void fxFoliageReplicator::BuildQuadTree(Vector<U64>& LeafKeys)
+{
+    AssertFatal(mQuadTreeLevels <= MaxQuadTreeLevels, "fxFoliageReplicator::BuildQuadTree - Too many Quad-tree levels!");
+
+    // Sorting the keys puts the leaves in the depth-first order the tree has
+    // always been laid out in, with billboards in placement order within each
+    // leaf.  The render buffers depend on that order.
+    dQsort(LeafKeys.address(), LeafKeys.size(), sizeof(U64), cmpFoliageLeafKeys);
+
+    // The root covers the whole Foliage area.
+    fxFoliageQuadrantNode* pPathNodes[MaxQuadTreeLevels + 1];
+    pPathNodes[0] = AllocateQuadrantNode(mQuadTreeLevels, getWorldBox());
+
+    fxFoliageQuadrantNode* pLeafNode = NULL;
+    U32 LeafPath = 0;
+    for (U32 i = 0; i < LeafKeys.size(); i++)
+    {
+        U32 Path = U32(LeafKeys[i] >> 32);
+        U32 ItemIdx = U32(LeafKeys[i] & 0xFFFFFFFF);
+
+        if (!pLeafNode || Path != LeafPath)
         {
-            // Store the render list from our culled object set.
-            pNewNode->RenderList = CullList.mCulledObjectSet;
-            // Keep track of the total billboard acquired.
-            mBillboardsAcquired += CullList.GetListCount();
+            // Skip the levels shared with the previous leaf, then create the
+            // nodes leading down to this one.
+            U32 Depth = 0;
+            if (pLeafNode)
+                while (((Path ^ LeafPath) >> (2 * (mQuadTreeLevels - 1 - Depth))) == 0)
+                    Depth++;
+
+            for (; Depth < mQuadTreeLevels; Depth++)
+            {
+                U32 q = (Path >> (2 * (mQuadTreeLevels - 1 - Depth))) & 3;
+                fxFoliageQuadrantNode* pParentNode = pPathNodes[Depth];
+                fxFoliageQuadrantNode* pNewNode = AllocateQuadrantNode(pParentNode->Level - 1, FetchQuadrant(pParentNode->QuadrantBox, q));
+
+                // Put a reference in parent.
+                pParentNode->QuadrantChildNode[q] = pNewNode;
+                pPathNodes[Depth + 1] = pNewNode;
+            }
+
+            pLeafNode = pPathNodes[mQuadTreeLevels];
+            LeafPath = Path;
         }
+
+        // Store the billboard in the leaf render list.
+        pLeafNode->RenderList.push_back(mReplicatedFoliage[ItemIdx]);
+        // Keep track of the total billboard acquired.
+        mBillboardsAcquired++;
     }
 }
 
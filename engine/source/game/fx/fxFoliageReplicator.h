@@ -51,25 +51,6 @@ public:
     U32         LastFrameSerialID;
 };
 
-//------------------------------------------------------------------------------
-// Class: fxFoliageCulledList
-//------------------------------------------------------------------------------
-class fxFoliageCulledList
-{
-public:
-    fxFoliageCulledList() {};
-    fxFoliageCulledList(Box3F SearchBox, fxFoliageCulledList* InVec);
-    ~fxFoliageCulledList() {};
-
-    void FindCandidates(Box3F SearchBox, fxFoliageCulledList* InVec);
-
-    U32 GetListCount(void) { return mCulledObjectSet.size(); };
-    fxFoliageItem* GetElement(U32 index) { return mCulledObjectSet[index]; };
-
-    Vector<fxFoliageItem*>   mCulledObjectSet;      // Culled Object Set.
-};
-
-
 //------------------------------------------------------------------------------
 // Class: fxFoliageQuadNode
 //------------------------------------------------------------------------------
@@ -141,11 +122,22 @@ protected:
     void SyncFoliageReplicators(void);
 
     Box3F FetchQuadrant(Box3F Box, U32 Quadrant);
-    void ProcessQuadrant(fxFoliageQuadrantNode* pParentNode, fxFoliageCulledList* pCullList, U32 Quadrant);
-    void ProcessNodeChildren(fxFoliageQuadrantNode* pParentNode, fxFoliageCulledList* pCullList);
+
+    // Placement and Quad-tree construction, the batches run on the thread pool.
+    static void PlaceFoliageBatch(U32 Batch, void* pData);
+    static void FindFoliageLeaves(U32 Batch, void* pData);
+    void FindLeafQuadrants(const Box3F& Box, U32 Level, U32 Path, U32 ItemIdx, Vector<U64>& Keys);
+    fxFoliageQuadrantNode* AllocateQuadrantNode(U32 Level, const Box3F& QuadrantBox);
+    void BuildQuadTree(Vector<U64>& LeafKeys);
 
     enum { FoliageReplicationMask = (1 << 0) };
 
+    enum
+    {
+        FoliageBatchSize = 256,     // Foliage items per placement job.
+        MaxQuadTreeLevels = 16,     // Leaf paths are packed into 32 bits.
+    };
+
 
     U32   mCreationAreaAngle;
     bool  mClientReplicationStarted;
@@ -19,6 +19,7 @@
 #include "terrain/waterBlock.h"
 #endif
 #include "game/collisionTest.h"
+#include "collision/convex.h"
 #include "game/showTSShape.h"
 #include "sceneGraph/sceneGraph.h"
 #include "gui/core/guiTSControl.h"
@@ -370,7 +371,8 @@ ConsoleFunction(lightScene, bool, 1, 3, "(script_function completeCallback=NULL,
     "Relight the scene.\n\n"
     "If mode is \"forceAlways\", the lightmaps will be regenerated regardless of whether "
     "lighting cache files can be written to. If mode is \"forceWritable\", then the lightmaps "
-    "will be regenerated only if the lighting cache files can be written.")
+    "will be regenerated only if the lighting cache files can be written. If mode is \"forceStale\", "
+    "only objects whose cached lighting no longer matches their placement and lights are regenerated.")
 {
     const char* callback = StringTable->insert(argv[1]);
     BitSet32 flags = 0;
@@ -381,6 +383,8 @@ ConsoleFunction(lightScene, bool, 1, 3, "(script_function completeCallback=NULL,
             flags.set(SceneLighting::ForceAlways);
         else if (!dStricmp(argv[2], "forceWritable"))
             flags.set(SceneLighting::ForceWritable);
+        else if (!dStricmp(argv[2], "forceStale"))
+            flags.set(SceneLighting::ForceStale);
     }
 
     return(SceneLighting::lightScene(callback, flags));
@@ -873,6 +877,8 @@ void GameInit()
     // updated every frame
     Con::addVariable("cameraFov", TypeF32, &sConsoleCameraFov);
 
+    Con::addVariable("$pref::Physics::parallelNarrowphase", TypeS32, &Convex::smParallelNarrowphase);
+
     // Initialize the collision testing script stuff.
     collisionTest.consoleInit();
 }
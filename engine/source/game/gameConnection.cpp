@@ -8,6 +8,9 @@
 #include "console/consoleTypes.h"
 #include "console/simBase.h"
 #include "core/bitStream.h"
+#include "core/crc.h"
+#include "core/memstream.h"
+#include "core/resManager.h"
 #include "sim/pathManager.h"
 #include "sceneGraph/sceneGraph.h"
 #include "sceneGraph/sceneLighting.h"
@@ -27,6 +30,9 @@
 
 #define ControlRequestTime 5000
 
+/// Offer clients that have none of the datablocks yet a DataBlockBlob.
+static bool sgUseDataBlockBlob = true;
+
 const U32 GameConnection::CurrentProtocolVersion = TORQUE_PROTOCOL_VERSION;
 const U32 GameConnection::MinRequiredProtocolVersion = TORQUE_PROTOCOL_VERSION;
 
@@ -60,6 +66,11 @@ GameConnection::GameConnection()
 
     mDataBlockModifiedKey = 0;
     mMaxDataBlockModifiedKey = 0;
+    mDataBlockBlobHash = 0;
+    mDataBlockBlobKey = 0;
+    mDataBlockBlobSequence = 0;
+    mDataBlockBlobSize = 0;
+    mDataBlockBlobDownload = false;
     mAuthInfo = NULL;
     mControlMismatch = false;
     mControlForceMismatch = false;
@@ -809,6 +820,12 @@ void GameConnection::writeDemoStartBlock(ResizeBitStream* stream)
 
 bool GameConnection::readDemoStartBlock(BitStream* stream)
 {
+    if (getProtocolVersion() < MinRequiredProtocolVersion)
+    {
+        setLastError("Demo was recorded with an older protocol version.");
+        return false;
+    }
+
     while (stream->readFlag())
     {
         SimDataBlockEvent evt;
@@ -1414,6 +1431,15 @@ void GameConnection::preloadDataBlock(SimDataBlock* db)
 
 void GameConnection::fileDownloadSegmentComplete()
 {
+    // the datablock blob is in the cache now, unless the server didn't
+    // have it anymore...
+    if (mDataBlockBlobDownload)
+    {
+        mDataBlockBlobDownload = false;
+        bool loaded = loadDataBlockBlob();
+        postNetEvent(new DataBlockBlobReplyEvent(mDataBlockBlobSequence, mDataBlockBlobHash, loaded));
+    }
+
     // this is called when a the file list has finished processing...
     // at this point we can try again to add the object
     // subclasses can override this to do, for example, datablock redos.
@@ -1544,29 +1570,147 @@ void GameConnection::handleConnectionMessage(U32 message, U32 sequence, U32 ghos
 
 //----------------------------------------------------------------------------
 
-ConsoleMethod(GameConnection, transmitDataBlocks, void, 3, 3, "(int sequence)")
+void GameConnection::transmitDataBlocks(U32 sequence)
+{
+    setDataBlockSequence(sequence);
+    mDataBlockBlobHash = 0;
+
+    // a client that has none of the datablocks yet can take them all in one go,
+    // the file transfer needs a remote connection...
+    if (sgUseDataBlockBlob && mDataBlockModifiedKey == 0 && !isLocalConnection() &&
+        !Con::getBoolVariable("$NetConnection::neverUploadFiles"))
+    {
+        const DataBlockBlob* blob = DataBlockBlob::get(this, sequence);
+        if (blob)
+        {
+            mDataBlockBlobHash = blob->mHash;
+            mDataBlockBlobKey = blob->mModifiedKey;
+            postNetEvent(new DataBlockBlobEvent(sequence, blob->mHash, blob->mData.size()));
+            return;
+        }
+    }
+
+    sendDataBlockEvents();
+}
+
+void GameConnection::sendDataBlockEvents()
 {
-    object->setDataBlockSequence(dAtoi(argv[2]));
     SimDataBlockGroup* g = Sim::getDataBlockGroup();
 
     // find the first one we haven't sent:
     U32 i, groupCount = g->size();
-    S32 key = object->getDataBlockModifiedKey();
+    S32 key = getDataBlockModifiedKey();
     for (i = 0; i < groupCount; i++)
         if (((SimDataBlock*)(*g)[i])->getModifiedKey() > key)
             break;
     if (i == groupCount) {
-        object->sendConnectionMessage(GameConnection::DataBlocksDone, object->getDataBlockSequence());
+        sendConnectionMessage(GameConnection::DataBlocksDone, getDataBlockSequence());
         return;
     }
-    object->setMaxDataBlockModifiedKey(key);
+    setMaxDataBlockModifiedKey(key);
 
     // Ship the rest off...
     U32 max = getMin(i + DataBlockQueueCount, groupCount);
     for (; i < max; i++) {
         SimDataBlock* data = (SimDataBlock*)(*g)[i];
-        object->postNetEvent(new SimDataBlockEvent(data, i, groupCount, object->getDataBlockSequence()));
+        postNetEvent(new SimDataBlockEvent(data, i, groupCount, getDataBlockSequence()));
+    }
+}
+
+void GameConnection::onDataBlockBlobReply(U32 sequence, U32 hash, bool loaded)
+{
+    // a later transmitDataBlocks() took over...
+    if (sequence != getDataBlockSequence() || !mDataBlockBlobHash || hash != mDataBlockBlobHash)
+        return;
+
+    // only what was modified since the blob was built is left to send
+    mDataBlockBlobHash = 0;
+    if (loaded)
+        setDataBlockModifiedKey(mDataBlockBlobKey);
+    sendDataBlockEvents();
+}
+
+Stream* GameConnection::openFileForSending(const char* fileName)
+{
+    // the client asks for the blob under its cache file name
+    const DataBlockBlob* blob = mDataBlockBlobHash ? DataBlockBlob::find(mDataBlockBlobHash) : NULL;
+    if (blob)
+    {
+        char blobName[256];
+        DataBlockBlob::getFileName(blobName, sizeof(blobName), "", blob->mHash);
+        U32 nameLen = dStrlen(fileName);
+        U32 blobLen = dStrlen(blobName);
+        if (nameLen >= blobLen && !dStricmp(fileName + nameLen - blobLen, blobName))
+        {
+            void* data = dMalloc(blob->mData.size());
+            dMemcpy(data, blob->mData.address(), blob->mData.size());
+            return new ResizableMemStream(blob->mData.size(), data, true, false);
+        }
+    }
+    return Parent::openFileForSending(fileName);
+}
+
+void GameConnection::onDataBlockBlobOffered(U32 sequence, U32 hash, U32 size)
+{
+    mDataBlockBlobSequence = sequence;
+    mDataBlockBlobHash = hash;
+    mDataBlockBlobSize = size;
+
+    // already on its way, the reply goes out once it is here
+    if (mDataBlockBlobDownload)
+        return;
+
+    // without a cache, or with other downloads going on, the server
+    // sends the datablocks one by one instead
+    const char* path = Con::getVariable("$pref::Net::DataBlockCachePath");
+    bool loaded = path[0] && loadDataBlockBlob();
+    if (loaded || !path[0] || mMissingFileList.size() || Con::getBoolVariable("$NetConnection::neverDownloadFiles"))
+    {
+        postNetEvent(new DataBlockBlobReplyEvent(sequence, hash, loaded));
+        return;
+    }
+
+    char fileName[1024];
+    DataBlockBlob::getFileName(fileName, sizeof(fileName), path, hash);
+    mDataBlockBlobDownload = true;
+    mNumDownloadedFiles = 0;
+    addMissingFile(fileName);
+    sendNextFileDownloadRequest();
+}
+
+bool GameConnection::loadDataBlockBlob()
+{
+    const char* path = Con::getVariable("$pref::Net::DataBlockCachePath");
+    if (!path[0])
+        return false;
+
+    char fileName[1024];
+    DataBlockBlob::getFileName(fileName, sizeof(fileName), path, mDataBlockBlobHash);
+    Stream* stream = ResourceManager->openStream(fileName);
+    if (!stream)
+        return false;
+
+    Vector<U8> data;
+    bool read = stream->getStreamSize() == mDataBlockBlobSize;
+    if (read)
+    {
+        data.setSize(mDataBlockBlobSize);
+        read = stream->read(data.size(), data.address());
     }
+    ResourceManager->closeStream(stream);
+    if (!read || calculateCRC(data.address(), data.size()) != mDataBlockBlobHash)
+    {
+        Con::warnf("Datablock cache file %s is damaged.", fileName);
+        return false;
+    }
+
+    Con::printf("Loading datablocks from %s.", fileName);
+    return DataBlockBlob::process(this, data.address(), data.size());
+}
+
+ConsoleMethod(GameConnection, transmitDataBlocks, void, 3, 3, "(int sequence)")
+{
+    object->transmitDataBlocks(dAtoi(argv[2]));
 }
 
 ConsoleMethod(GameConnection, activateGhosting, void, 2, 2, "")
@@ -1688,6 +1832,7 @@ ConsoleMethod(GameConnection, delete, void, 2, 3, "(string reason=NULL) Disconne
 void GameConnection::consoleInit()
 {
     Con::addVariable("Pref::Net::LagThreshold", TypeS32, &mLagThresholdMS);
+    Con::addVariable("pref::Net::DataBlockBlob", TypeBool, &sgUseDataBlockBlob);
     Con::addVariable("specialFog", TypeBool, &SceneGraph::useSpecial);
 }
 
@@ -64,6 +64,19 @@ private:
     S32 mDataBlockModifiedKey;
     S32 mMaxDataBlockModifiedKey;
 
+    /// @name Datablock blob
+    /// See DataBlockBlob.
+    /// @{
+    U32 mDataBlockBlobHash;         ///< Server: blob offered to the client.  Client: blob offered by the server.
+    S32 mDataBlockBlobKey;          ///< Server: newest modified key of the offered blob.
+    U32 mDataBlockBlobSequence;     ///< Client: sequence of the offer.
+    U32 mDataBlockBlobSize;         ///< Client: size of the offered blob.
+    bool mDataBlockBlobDownload;    ///< Client: the offered blob is being downloaded.
+
+    bool loadDataBlockBlob();
+    void sendDataBlockEvents();
+    /// @}
+
     /// @name Client side first/third person
     /// @{
 
@@ -229,6 +242,7 @@ public:
     void handleConnectionMessage(U32 message, U32 sequence, U32 ghostCount);
     void preloadDataBlock(SimDataBlock* block);
     void fileDownloadSegmentComplete();
+    Stream* openFileForSending(const char* fileName);
     void preloadNextDataBlock(bool hadNew);
     static void consoleInit();
 
@@ -239,6 +253,12 @@ public:
     U32 getDataBlockSequence() { return mDataBlockSequence; }
     void setDataBlockSequence(U32 seq) { mDataBlockSequence = seq; }
 
+    /// Sends the client every datablock it doesn't have yet, as a
+    /// DataBlockBlob if it has none of them.
+    void transmitDataBlocks(U32 sequence);
+    void onDataBlockBlobOffered(U32 sequence, U32 hash, U32 size);
+    void onDataBlockBlobReply(U32 sequence, U32 hash, bool loaded);
+
     bool onAdd();
     void onRemove();
 
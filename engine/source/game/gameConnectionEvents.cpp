@@ -6,6 +6,7 @@
 #include "platform/platform.h"
 #include "core/dnet.h"
 #include "core/bitStream.h"
+#include "core/crc.h"
 #include "console/consoleTypes.h"
 #include "console/simBase.h"
 #include "sim/pathManager.h"
@@ -23,8 +24,106 @@ IMPLEMENT_CO_CLIENTEVENT_V1(SimDataBlockEvent);
 IMPLEMENT_CO_CLIENTEVENT_V1(Sim2DAudioEvent);
 IMPLEMENT_CO_CLIENTEVENT_V1(Sim3DAudioEvent);
 IMPLEMENT_CO_CLIENTEVENT_V1(SetMissionCRCEvent);
+IMPLEMENT_CO_CLIENTEVENT_V1(DataBlockBlobEvent);
+IMPLEMENT_CO_SERVEREVENT_V1(DataBlockBlobReplyEvent);
 
 
+//----------------------------------------------------------------------------
+
+/// Server side store of the packData() output of every datablock, indexed by
+/// datablock id.  Entries are rebuilt when the mission sequence, the class or
+/// the modified key of the datablock they were built from changes, so every
+/// client connecting during a mission gets the same bits without repacking.
+class DataBlockPackCache
+{
+public:
+    struct Entry
+    {
+        U32 sequence;
+        S32 modifiedKey;
+        AbstractClassRep* classRep;
+        U32 bitCount;
+        U8* data;
+    };
+
+    U32 mHits;
+    U32 mMisses;
+    U32 mBytes;
+
+    DataBlockPackCache()
+    {
+        mHits = mMisses = mBytes = 0;
+    }
+
+    ~DataBlockPackCache()
+    {
+        for (U32 i = 0; i < mEntries.size(); i++)
+            dFree(mEntries[i].data);
+    }
+
+    /// Returns the packed data of @a obj, or NULL if it does not fit in a
+    /// packet.  Those are not cached and have to be packed by the caller.
+    const Entry* get(SimDataBlock* obj, U32 sequence)
+    {
+        U32 slot = obj->getId() - DataBlockObjectIdFirst;
+        if (slot >= mEntries.size())
+        {
+            U32 oldSize = mEntries.size();
+            mEntries.setSize(slot + 1);
+            dMemset(mEntries.address() + oldSize, 0, (slot + 1 - oldSize) * sizeof(Entry));
+        }
+
+        Entry& entry = mEntries[slot];
+        if (entry.data && entry.sequence == sequence && entry.modifiedKey == obj->getModifiedKey() &&
+            entry.classRep == obj->getClassRep())
+        {
+            mHits++;
+            return &entry;
+        }
+
+        PROFILE_START(DataBlockPackCache_pack);
+        mMisses++;
+
+        U8 buffer[MaxPacketDataSize];
+        BitStream stream(buffer, sizeof(buffer));
+        obj->packData(&stream);
+        if (!stream.isValid())
+        {
+            Con::errorf("DataBlockPackCache::get - packed data of %s does not fit in a packet.", obj->getName());
+            PROFILE_END();
+            return NULL;
+        }
+
+        U32 bytes = (stream.getCurPos() + 7) >> 3;
+        mBytes -= entry.data ? (entry.bitCount + 7) >> 3 : 0;
+        mBytes += bytes;
+
+        entry.sequence = sequence;
+        entry.modifiedKey = obj->getModifiedKey();
+        entry.classRep = obj->getClassRep();
+        entry.bitCount = stream.getCurPos();
+        entry.data = (U8*)dRealloc(entry.data, getMax(bytes, U32(1)));
+        dMemcpy(entry.data, buffer, bytes);
+
+        PROFILE_END();
+        return &entry;
+    }
+
+private:
+    Vector<Entry> mEntries;
+};
+
+static DataBlockPackCache sgDataBlockPackCache;
+
+ConsoleFunction(getDataBlockPackCacheStats, const char*, 1, 1, "getDataBlockPackCacheStats();"
+    "Returns \"hits misses bytes\" of the server side cache of packed datablocks. Every "
+    "miss ran packData() on a datablock, hits were sent to a client as they were.")
+{
+    char* ret = Con::getReturnBuffer(64);
+    dSprintf(ret, 64, "%d %d %d", sgDataBlockPackCache.mHits, sgDataBlockPackCache.mMisses, sgDataBlockPackCache.mBytes);
+    return ret;
+}
+
 //----------------------------------------------------------------------------
 
 SimDataBlockEvent::~SimDataBlockEvent()
@@ -38,6 +137,7 @@ SimDataBlockEvent::SimDataBlockEvent(SimDataBlock* obj, U32 index, U32 total, U3
     mTotal = total;
     mMissionSequence = missionSequence;
     mProcess = false;
+    mPackedBits = 0;
 
     if (obj)
     {
@@ -105,7 +205,26 @@ void SimDataBlockEvent::pack(NetConnection* conn, BitStream* bstream)
         bstream->writeClassId(classId, NetClassTypeDataBlock, conn->getNetClassGroup());
         bstream->writeInt(mIndex, DataBlockObjectIdBitSize);
         bstream->writeInt(mTotal, DataBlockObjectIdBitSize + 1);
-        obj->packData(bstream);
+
+        const DataBlockPackCache::Entry* packed = sgDataBlockPackCache.get(obj, gc->getDataBlockSequence());
+        if (packed)
+            writePackedData(bstream, packed->bitCount, packed->data);
+        else
+        {
+            // too big for the cache, pack it straight into the packet
+            // and fill in the bit count afterwards...
+            U32 countPos = bstream->getCurPos();
+            bstream->writeInt(0, PackedBitCountBits);
+            U32 dataPos = bstream->getCurPos();
+            obj->packData(bstream);
+            if (bstream->isValid())
+            {
+                U32 endPos = bstream->getCurPos();
+                bstream->setCurPos(countPos);
+                bstream->writeInt(endPos - dataPos, PackedBitCountBits);
+                bstream->setCurPos(endPos);
+            }
+        }
 #ifdef TORQUE_DEBUG_NET
         bstream->writeInt(classId ^ DebugChecksum, 32);
 #endif
@@ -113,6 +232,13 @@ void SimDataBlockEvent::pack(NetConnection* conn, BitStream* bstream)
     }
 }
 
+void SimDataBlockEvent::writePackedData(BitStream* bstream, U32 bitCount, const U8* data)
+{
+    AssertFatal(bitCount < (1 << PackedBitCountBits), "SimDataBlockEvent::writePackedData - packed data too large.");
+    bstream->writeInt(bitCount, PackedBitCountBits);
+    bstream->writeBits(bitCount, data);
+}
+
 void SimDataBlockEvent::unpack(NetConnection* cptr, BitStream* bstream)
 {
     if (bstream->readFlag())
@@ -123,17 +249,9 @@ void SimDataBlockEvent::unpack(NetConnection* cptr, BitStream* bstream)
         mIndex = bstream->readInt(DataBlockObjectIdBitSize);
         mTotal = bstream->readInt(DataBlockObjectIdBitSize + 1);
 
-        SimObject* ptr = (SimObject*)ConsoleObject::create(cptr->getNetClassGroup(), NetClassTypeDataBlock, classId);
-        if ((mObj = dynamic_cast<SimDataBlock*>(ptr)) != 0) {
-            //Con::printf(" - SimDataBlockEvent: unpacking event of type: %s", mObj->getClassName());
-            mObj->unpackData(bstream);
-        }
-        else
-        {
-            //Con::printf(" - SimDataBlockEvent: INVALID PACKET!  Could not create class with classID: %d", classId);
-            delete ptr;
+        readPackedData(bstream);
+        if (!bstream->isValid() || !createObject(cptr, classId))
             cptr->setLastError("Invalid packet in SimDataBlockEvent::unpack()");
-        }
 
 #ifdef TORQUE_DEBUG_NET
         U32 checksum = bstream->readInt(32);
@@ -145,6 +263,32 @@ void SimDataBlockEvent::unpack(NetConnection* cptr, BitStream* bstream)
     }
 }
 
+void SimDataBlockEvent::readPackedData(BitStream* bstream)
+{
+    mPackedBits = bstream->readInt(PackedBitCountBits);
+    mPackedData.setSize((mPackedBits + 7) >> 3);
+    bstream->readBits(mPackedBits, mPackedData.address());
+}
+
+bool SimDataBlockEvent::createObject(NetConnection* cptr, S32 classId)
+{
+    if (classId < 0)
+        return false;
+
+    SimObject* ptr = (SimObject*)ConsoleObject::create(cptr->getNetClassGroup(), NetClassTypeDataBlock, classId);
+    if ((mObj = dynamic_cast<SimDataBlock*>(ptr)) == 0)
+    {
+        //Con::printf(" - SimDataBlockEvent: INVALID PACKET!  Could not create class with classID: %d", classId);
+        delete ptr;
+        return false;
+    }
+
+    //Con::printf(" - SimDataBlockEvent: unpacking event of type: %s", mObj->getClassName());
+    BitStream packed(mPackedData.address(), mPackedData.size());
+    mObj->unpackData(&packed);
+    return true;
+}
+
 void SimDataBlockEvent::write(NetConnection* cptr, BitStream* bstream)
 {
     if (bstream->writeFlag(mProcess))
@@ -154,7 +298,7 @@ void SimDataBlockEvent::write(NetConnection* cptr, BitStream* bstream)
         bstream->writeClassId(classId, NetClassTypeDataBlock, cptr->getNetClassGroup());
         bstream->writeInt(mIndex, DataBlockObjectIdBitSize);
         bstream->writeInt(mTotal, DataBlockObjectIdBitSize + 1);
-        mObj->packData(bstream);
+        writePackedData(bstream, mPackedBits, mPackedData.address());
     }
 }
 
@@ -170,10 +314,7 @@ void SimDataBlockEvent::process(NetConnection* cptr)
 
         if (Sim::findObject(id, obj) && dStrcmp(obj->getClassName(), mObj->getClassName()) == 0)
         {
-            U8 buf[1500];
-            BitStream stream(buf, 1500);
-            mObj->packData(&stream);
-            stream.setPosition(0);
+            BitStream stream(mPackedData.address(), mPackedData.size());
             obj->unpackData(&stream);
             obj->preload(false, errorBuffer);
         }
@@ -198,6 +339,163 @@ void SimDataBlockEvent::process(NetConnection* cptr)
 }
 
 
+//----------------------------------------------------------------------------
+
+static DataBlockBlob* sgDataBlockBlob = NULL;
+
+const DataBlockBlob* DataBlockBlob::get(NetConnection* conn, U32 sequence)
+{
+    SimDataBlockGroup* g = Sim::getDataBlockGroup();
+    S32 key = 0;
+    for (U32 i = 0; i < g->size(); i++)
+        key = getMax(key, ((SimDataBlock*)(*g)[i])->getModifiedKey());
+
+    DataBlockBlob* blob = sgDataBlockBlob;
+    if (blob && blob->mSequence == sequence && blob->mModifiedKey == key &&
+        blob->mCount == g->size() && blob->mClassGroup == conn->getNetClassGroup())
+        return blob;
+
+    delete sgDataBlockBlob;
+    sgDataBlockBlob = NULL;
+
+    PROFILE_START(DataBlockBlob_build);
+
+    InfiniteBitStream stream;
+    stream.write(U32(Version));
+    stream.write(U32(g->size()));
+    for (U32 i = 0; i < g->size(); i++)
+    {
+        SimDataBlock* obj = (SimDataBlock*)(*g)[i];
+        const DataBlockPackCache::Entry* packed = sgDataBlockPackCache.get(obj, sequence);
+        if (!packed)
+        {
+            PROFILE_END();
+            return NULL;
+        }
+
+        stream.validate((packed->bitCount >> 3) + 16);
+        stream.writeInt(obj->getId() - DataBlockObjectIdFirst, DataBlockObjectIdBitSize);
+        stream.writeClassId(obj->getClassId(conn->getNetClassGroup()), NetClassTypeDataBlock, conn->getNetClassGroup());
+        stream.writeInt(packed->bitCount, SimDataBlockEvent::PackedBitCountBits);
+        stream.writeBits(packed->bitCount, packed->data);
+    }
+
+    blob = new DataBlockBlob;
+    blob->mData.setSize(stream.getPosition());
+    dMemcpy(blob->mData.address(), stream.getBuffer(), blob->mData.size());
+    blob->mHash = calculateCRC(blob->mData.address(), blob->mData.size());
+    blob->mSequence = sequence;
+    blob->mModifiedKey = key;
+    blob->mCount = g->size();
+    blob->mClassGroup = conn->getNetClassGroup();
+    sgDataBlockBlob = blob;
+
+    PROFILE_END();
+    return blob;
+}
+
+const DataBlockBlob* DataBlockBlob::find(U32 hash)
+{
+    return (sgDataBlockBlob && sgDataBlockBlob->mHash == hash) ? sgDataBlockBlob : NULL;
+}
+
+void DataBlockBlob::getFileName(char* buffer, U32 bufferSize, const char* path, U32 hash)
+{
+    dSprintf(buffer, bufferSize, "%s/datablocks_%08x.dbb", path, hash);
+}
+
+bool DataBlockBlob::process(NetConnection* conn, const U8* data, U32 size)
+{
+    BitStream stream((void*)data, size);
+    U32 version, count;
+    stream.read(&version);
+    stream.read(&count);
+    if (!stream.isValid() || version != Version)
+        return false;
+
+    for (U32 i = 0; i < count; i++)
+    {
+        SimDataBlockEvent evt;
+        evt.mProcess = true;
+        evt.mIndex = i;
+        evt.mTotal = count;
+        evt.id = stream.readInt(DataBlockObjectIdBitSize) + DataBlockObjectIdFirst;
+        S32 classId = stream.readClassId(NetClassTypeDataBlock, conn->getNetClassGroup());
+        evt.readPackedData(&stream);
+        if (!stream.isValid() || !evt.createObject(conn, classId))
+            return false;
+
+        evt.process(conn);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
+DataBlockBlobEvent::DataBlockBlobEvent(U32 sequence, U32 hash, U32 size)
+{
+    mSequence = sequence;
+    mHash = hash;
+    mSize = size;
+}
+
+void DataBlockBlobEvent::pack(NetConnection*, BitStream* bstream)
+{
+    bstream->write(mSequence);
+    bstream->write(mHash);
+    bstream->write(mSize);
+}
+
+void DataBlockBlobEvent::write(NetConnection* con, BitStream* bstream)
+{
+    pack(con, bstream);
+}
+
+void DataBlockBlobEvent::unpack(NetConnection*, BitStream* bstream)
+{
+    bstream->read(&mSequence);
+    bstream->read(&mHash);
+    bstream->read(&mSize);
+}
+
+void DataBlockBlobEvent::process(NetConnection* con)
+{
+    // a demo has the datablocks in its start block...
+    if (!con->isPlayingBack())
+        static_cast<GameConnection*>(con)->onDataBlockBlobOffered(mSequence, mHash, mSize);
+}
+
+DataBlockBlobReplyEvent::DataBlockBlobReplyEvent(U32 sequence, U32 hash, bool loaded)
+{
+    mSequence = sequence;
+    mHash = hash;
+    mLoaded = loaded;
+}
+
+void DataBlockBlobReplyEvent::pack(NetConnection*, BitStream* bstream)
+{
+    bstream->write(mSequence);
+    bstream->write(mHash);
+    bstream->writeFlag(mLoaded);
+}
+
+void DataBlockBlobReplyEvent::write(NetConnection* con, BitStream* bstream)
+{
+    pack(con, bstream);
+}
+
+void DataBlockBlobReplyEvent::unpack(NetConnection*, BitStream* bstream)
+{
+    bstream->read(&mSequence);
+    bstream->read(&mHash);
+    mLoaded = bstream->readFlag();
+}
+
+void DataBlockBlobReplyEvent::process(NetConnection* con)
+{
+    static_cast<GameConnection*>(con)->onDataBlockBlobReply(mSequence, mHash, mLoaded);
+}
+
 //----------------------------------------------------------------------------
 
 
@@ -14,6 +14,12 @@ class QuitEvent : public SimEvent
     }
 };
 
+/// Sends a datablock to a client.
+///
+/// The packData() output of a datablock is built once per mission sequence on
+/// the server and shared by every connection it is sent to, it goes over the
+/// wire as a sized run of bits.  Clients keep the bits they got, so an already
+/// existing datablock is updated straight from them.
 class SimDataBlockEvent : public NetEvent
 {
     SimObjectId id;
@@ -22,6 +28,20 @@ class SimDataBlockEvent : public NetEvent
     U32 mTotal;
     U32 mMissionSequence;
     bool mProcess;
+
+    U32 mPackedBits;
+    Vector<U8> mPackedData;     ///< packData() output as received, client side.
+
+    enum
+    {
+        PackedBitCountBits = 16,
+    };
+
+    void writePackedData(BitStream* bstream, U32 bitCount, const U8* data);
+    void readPackedData(BitStream* bstream);
+    bool createObject(NetConnection* cptr, S32 classId);
+
+    friend class DataBlockBlob;
 public:
     ~SimDataBlockEvent();
     SimDataBlockEvent(SimDataBlock* obj = NULL, U32 index = 0, U32 total = 0, U32 missionSequence = 0);
@@ -36,6 +56,76 @@ public:
     DECLARE_CONOBJECT(SimDataBlockEvent);
 };
 
+/// The whole datablock set of the server packed into one versioned blob.
+///
+/// The server builds it at most once per mission sequence out of the same
+/// packData() output SimDataBlockEvent sends.  A client that has none of the
+/// datablocks yet is offered the blob (DataBlockBlobEvent) and either loads it
+/// from its cache, named after the blob's hash, or downloads it into the cache
+/// through the file transfer.  It answers with a DataBlockBlobReplyEvent and
+/// the server then only sends the datablocks modified since the blob was built.
+class DataBlockBlob
+{
+public:
+    enum
+    {
+        Version = 1,
+    };
+
+    U32 mHash;              ///< CRC of mData.
+    Vector<U8> mData;
+    U32 mSequence;
+    S32 mModifiedKey;       ///< Newest modified key of the datablocks in it.
+    U32 mCount;
+    U32 mClassGroup;
+
+    /// Returns the blob of the current datablock set, or NULL if a datablock
+    /// is too big to be packed on its own.
+    static const DataBlockBlob* get(NetConnection* conn, U32 sequence);
+
+    /// Returns the blob last returned by get() if its hash is @a hash.
+    static const DataBlockBlob* find(U32 hash);
+
+    /// File name of the blob with @a hash in a client's cache directory.
+    static void getFileName(char* buffer, U32 bufferSize, const char* path, U32 hash);
+
+    /// Creates or updates the datablocks in a blob on a client, returns false
+    /// if it is damaged.
+    static bool process(NetConnection* conn, const U8* data, U32 size);
+};
+
+/// Offers a client the datablock blob, see DataBlockBlob.
+class DataBlockBlobEvent : public NetEvent
+{
+    U32 mSequence;
+    U32 mHash;
+    U32 mSize;
+
+public:
+    DataBlockBlobEvent(U32 sequence = 0, U32 hash = 0, U32 size = 0);
+    void pack(NetConnection*, BitStream* bstream);
+    void write(NetConnection*, BitStream* bstream);
+    void unpack(NetConnection*, BitStream* bstream);
+    void process(NetConnection*);
+    DECLARE_CONOBJECT(DataBlockBlobEvent);
+};
+
+/// Tells the server whether the client created its datablocks from the blob.
+class DataBlockBlobReplyEvent : public NetEvent
+{
+    U32 mSequence;
+    U32 mHash;
+    bool mLoaded;
+
+public:
+    DataBlockBlobReplyEvent(U32 sequence = 0, U32 hash = 0, bool loaded = false);
+    void pack(NetConnection*, BitStream* bstream);
+    void write(NetConnection*, BitStream* bstream);
+    void unpack(NetConnection*, BitStream* bstream);
+    void process(NetConnection*);
+    DECLARE_CONOBJECT(DataBlockBlobReplyEvent);
+};
+
 class Sim2DAudioEvent : public NetEvent
 {
 private:
@@ -51,6 +51,9 @@
 #include "game/demoGame.h"
 #include "sim/decalManager.h"
 #include "core/frameAllocator.h"
+#include "core/frameArena.h"
+#include "collision/polyListArena.h"
+#include "core/threadPool.h"
 #include "sceneGraph/detailManager.h"
 #include "game/version.h"
 #include "platform/profiler.h"
@@ -160,6 +163,9 @@ static bool initLibraries()
     PlatformAssert::create();
 
     FrameAllocator::init(TORQUE_FRAME_SIZE);      // See comments in torqueConfig.h
+    FrameArena::init();
+    PolyListArena::init();
+    ThreadPool::init();
 
  //   // Cryptographic pool next
  //   CryptRandomPool::init();
@@ -247,6 +253,9 @@ static void shutdownLibraries()
     _StringTable::destroy();
 
     // asserts should be destroyed LAST
+    ThreadPool::destroy();
+    PolyListArena::destroy();
+    FrameArena::destroy();
     FrameAllocator::destroy();
 
     PlatformAssert::destroy();
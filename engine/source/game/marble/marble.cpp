@@ -1226,6 +1226,7 @@ bool Marble::updatePadState()
         SphereF sphere(boxCenter, in_rRadius);
         polyList.clear();
         mPadPtr->buildPolyList(&Marble::polyList, box, sphere);
+        cachePolyListPlanes();
         if (!polyList.mPolyList.empty())
         {
             int i = 0;
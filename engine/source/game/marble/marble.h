@@ -360,6 +360,10 @@ public:
     static Vector<Marble*> marbles;
     static ConcretePolyList polyList;
 
+    /// Rebuilds the edge and batched poly planes used by testMove() and
+    /// findContacts(), call it whenever polyList is filled.
+    static void cachePolyListPlanes();
+
 #ifdef MBXP_EMOTIVES
     static bool smUseEmotives;
 #endif
@@ -7,6 +7,7 @@
 
 #include "materials/material.h"
 #include "math/mathUtils.h"
+#include "math/mRandom.h"
 
 //----------------------------------------------------------------------------
 
@@ -15,6 +16,300 @@ static U32 sgLastCollisionMask;
 static bool sgResetFindObjects;
 static U32 sgCountCalls;
 
+//----------------------------------------------------------------------------
+// Poly list planes
+//
+// The edge planes of the polys, and the poly planes in a form that can be
+// tested four polys at a time, only depend on the poly list.  They are built
+// whenever the list is filled instead of by every testMove() and
+// findContacts() call.  Everything is computed with the same expressions the
+// tests used to evaluate in place, so the results are bit for bit the same.
+
+struct MarbleEdge
+{
+    PlaneD movePlane;       ///< Edge plane as testMove() builds it, through the float sum.
+    Point3D dir;            ///< Previous vertex minus this one.
+    F64 lenSq;
+    F64 len;
+    bool degenerate;        ///< Same position as the previous vertex, no planes.
+};
+
+/// One per index list entry, for the edge from the previous vertex of the poly.
+static Vector<MarbleEdge> sgPolyEdges;
+
+/// Poly planes split into components, padded to a multiple of four polys.
+static Vector<F64> sgPlaneX;
+static Vector<F64> sgPlaneY;
+static Vector<F64> sgPlaneZ;
+static Vector<F64> sgPlaneD;
+
+/// Per poly results of the batched plane tests.
+static Vector<F64> sgPlaneDist;
+static Vector<F64> sgPlaneDot;
+
+/// The planes findContacts() tests the contact point against, split into
+/// components, three per index list entry: the edge plane, then the planes
+/// bounding the region of this vertex and of the previous vertex of the edge.
+/// Degenerate edges get zero planes.  One entry of padding so the planes can
+/// be tested two at a time.
+enum
+{
+    EdgePlane = 0,
+    VertexPlane,
+    LastVertexPlane,
+    NumEdgePlanes
+};
+
+static Vector<F64> sgEdgeX;
+static Vector<F64> sgEdgeY;
+static Vector<F64> sgEdgeZ;
+static Vector<F64> sgEdgeD;
+static Vector<F64> sgEdgeDist;
+
+static inline void setEdgePlane(U32 index, const PlaneD& plane)
+{
+    sgEdgeX[index] = plane.x;
+    sgEdgeY[index] = plane.y;
+    sgEdgeZ[index] = plane.z;
+    sgEdgeD[index] = plane.d;
+}
+
+void Marble::cachePolyListPlanes()
+{
+    PROFILE_START(Marble_CachePolyListPlanes);
+
+    U32 numPolys = polyList.mPolyList.size();
+    U32 numPadded = (numPolys + 3) & ~3;
+
+    sgPlaneX.setSize(numPadded);
+    sgPlaneY.setSize(numPadded);
+    sgPlaneZ.setSize(numPadded);
+    sgPlaneD.setSize(numPadded);
+    sgPlaneDist.setSize(numPadded);
+    sgPlaneDot.setSize(numPadded);
+    sgPolyEdges.setSize(polyList.mIndexList.size());
+
+    U32 numEdgePlanes = polyList.mIndexList.size() * NumEdgePlanes + 1;
+    sgEdgeX.setSize(numEdgePlanes);
+    sgEdgeY.setSize(numEdgePlanes);
+    sgEdgeZ.setSize(numEdgePlanes);
+    sgEdgeD.setSize(numEdgePlanes);
+    sgEdgeDist.setSize(numEdgePlanes);
+    for (U32 i = 0; i < numEdgePlanes; i++)
+        sgEdgeX[i] = sgEdgeY[i] = sgEdgeZ[i] = sgEdgeD[i] = 0.0;
+
+    for (U32 i = 0; i < numPadded; i++)
+    {
+        if (i >= numPolys)
+        {
+            sgPlaneX[i] = sgPlaneY[i] = sgPlaneZ[i] = sgPlaneD[i] = 0.0;
+            continue;
+        }
+
+        const ConcretePolyList::Poly& poly = polyList.mPolyList[i];
+        PlaneD plane(poly.plane);
+        sgPlaneX[i] = plane.x;
+        sgPlaneY[i] = plane.y;
+        sgPlaneZ[i] = plane.z;
+        sgPlaneD[i] = plane.d;
+
+        if (poly.vertexCount == 0)
+            continue;
+
+        Point3F planeNormal(plane);
+        Point3F lastVert = polyList.mVertexList[polyList.mIndexList[poly.vertexStart + poly.vertexCount - 1]];
+        for (U32 j = 0; j < poly.vertexCount; j++)
+        {
+            Point3F thisVert = polyList.mVertexList[polyList.mIndexList[poly.vertexStart + j]];
+            MarbleEdge& edge = sgPolyEdges[poly.vertexStart + j];
+
+            edge.dir = lastVert - thisVert;
+            edge.lenSq = edge.dir.lenSquared();
+            edge.len = edge.dir.len();
+            edge.degenerate = thisVert == lastVert;
+
+            if (!edge.degenerate)
+            {
+                Point3D vertex = thisVert;
+                Point3D lastVertex = lastVert;
+                edge.movePlane = PlaneD(thisVert + planeNormal, thisVert, lastVert);
+
+                PlaneD edgePlane(vertex + plane, vertex, lastVertex);
+                U32 index = (poly.vertexStart + j) * NumEdgePlanes;
+                setEdgePlane(index + EdgePlane, edgePlane);
+                setEdgePlane(index + VertexPlane, PlaneD(edgePlane + vertex, vertex, vertex + plane));
+                setEdgePlane(index + LastVertexPlane, PlaneD(lastVertex - edgePlane, lastVertex, lastVertex + plane));
+            }
+
+            lastVert = thisVert;
+        }
+    }
+
+    PROFILE_END();
+}
+
+/// Makes sure the cached planes belong to the poly list, in case it was
+/// filled by someone who did not rebuild them.
+static void validatePolyListPlanes()
+{
+    if (sgPlaneX.size() != ((Marble::polyList.mPolyList.size() + 3) & ~3) ||
+        sgPolyEdges.size() != Marble::polyList.mIndexList.size() ||
+        sgEdgeX.size() != Marble::polyList.mIndexList.size() * NumEdgePlanes + 1)
+        Marble::cachePolyListPlanes();
+}
+
+/// Computes the dot product of @a point with the poly planes [start, end),
+/// plus the plane constant if @a withD is set, four polys at a time.  The
+/// operations are done in the order mDot() and PlaneD::distToPlane() do them.
+static void computePlaneDots(const Point3D& point, bool withD, U32 start, U32 end, F64* out)
+{
+    const F64* px = sgPlaneX.address();
+    const F64* py = sgPlaneY.address();
+    const F64* pz = sgPlaneZ.address();
+    const F64* pd = sgPlaneD.address();
+
+#ifdef TORQUE_POINT3D_SSE2
+    const __m128d x = _mm_set1_pd(point.x);
+    const __m128d y = _mm_set1_pd(point.y);
+    const __m128d z = _mm_set1_pd(point.z);
+
+    for (U32 i = start & ~3; i < end; i += 4)
+    {
+        __m128d dot0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(px + i), x),
+                                             _mm_mul_pd(_mm_loadu_pd(py + i), y)),
+                                  _mm_mul_pd(_mm_loadu_pd(pz + i), z));
+        __m128d dot1 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(px + i + 2), x),
+                                             _mm_mul_pd(_mm_loadu_pd(py + i + 2), y)),
+                                  _mm_mul_pd(_mm_loadu_pd(pz + i + 2), z));
+        if (withD)
+        {
+            dot0 = _mm_add_pd(dot0, _mm_loadu_pd(pd + i));
+            dot1 = _mm_add_pd(dot1, _mm_loadu_pd(pd + i + 2));
+        }
+        _mm_storeu_pd(out + i, dot0);
+        _mm_storeu_pd(out + i + 2, dot1);
+    }
+#else
+    for (U32 i = start; i < end; i++)
+    {
+        F64 dot = px[i] * point.x + py[i] * point.y + pz[i] * point.z;
+        out[i] = withD ? dot + pd[i] : dot;
+    }
+#endif
+}
+
+/// Computes the distance of @a point to the edge planes [start, end), two at
+/// a time, in the order PlaneD::distToPlane() does it.
+static void computeEdgeDists(const Point3D& point, U32 start, U32 end, F64* out)
+{
+    const F64* ex = sgEdgeX.address();
+    const F64* ey = sgEdgeY.address();
+    const F64* ez = sgEdgeZ.address();
+    const F64* ed = sgEdgeD.address();
+
+#ifdef TORQUE_POINT3D_SSE2
+    const __m128d x = _mm_set1_pd(point.x);
+    const __m128d y = _mm_set1_pd(point.y);
+    const __m128d z = _mm_set1_pd(point.z);
+
+    for (U32 i = start; i < end; i += 2)
+    {
+        __m128d dist = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(ex + i), x),
+                                             _mm_mul_pd(_mm_loadu_pd(ey + i), y)),
+                                  _mm_mul_pd(_mm_loadu_pd(ez + i), z));
+        _mm_storeu_pd(out + i, _mm_add_pd(dist, _mm_loadu_pd(ed + i)));
+    }
+#else
+    for (U32 i = start; i < end; i++)
+        out[i] = (ex[i] * point.x + ey[i] * point.y + ez[i] * point.z) + ed[i];
+#endif
+}
+
+/// Distance of @a point to a single cached edge plane.
+static inline F64 edgePlaneDist(U32 index, const Point3D& point)
+{
+    return (sgEdgeX[index] * point.x + sgEdgeY[index] * point.y + sgEdgeZ[index] * point.z) + sgEdgeD[index];
+}
+
+/// Finds the point where a sphere at @a pos, @a distance from the plane of
+/// poly @a polyIndex, touches the poly.  The point is projected onto the
+/// plane and then pushed back into the poly past any edge or vertex it is
+/// outside of.  Returns false if it lies further outside an edge than the
+/// sphere reaches.  In @a mbg mode the walk only updates the returned point,
+/// otherwise every edge after a push tests the pushed point.
+///
+/// The edge and vertex planes of the poly are tested against the projected
+/// point in one batch; only the tests after a push are done one at a time.
+static bool findPolyContact(U32 polyIndex, const Point3D& pos, F32 rad, F64 distance, bool mbg, Point3D& contact)
+{
+    const ConcretePolyList& polyList = Marble::polyList;
+    const ConcretePolyList::Poly& poly = polyList.mPolyList[polyIndex];
+    PlaneD plane(poly.plane);
+
+    Point3D lastVertex(polyList.mVertexList[polyList.mIndexList[poly.vertexStart + poly.vertexCount - 1]]);
+    Point3D contactVert = plane.project(pos);
+    Point3D finalContact = contactVert;
+
+    F64 separation = mSqrtD(rad * rad - distance * distance);
+
+    U32 first = poly.vertexStart * NumEdgePlanes;
+    computeEdgeDists(contactVert, first, first + poly.vertexCount * NumEdgePlanes, sgEdgeDist.address());
+    const F64* edgeDist = sgEdgeDist.address();
+    bool moved = false;
+
+    for (U32 j = 0; j < poly.vertexCount; j++)
+    {
+        if (sgPolyEdges[poly.vertexStart + j].degenerate)
+            continue;
+
+        Point3D vertex = polyList.mVertexList[polyList.mIndexList[poly.vertexStart + j]];
+        U32 index = first + j * NumEdgePlanes;
+
+        F64 vertDistance = moved ? edgePlaneDist(index + EdgePlane, contactVert) : edgeDist[index + EdgePlane];
+        if (vertDistance < 0.0)
+        {
+            if (vertDistance < -(separation + 0.0001))
+                return false;
+
+            F64 vertexDist = moved ? edgePlaneDist(index + VertexPlane, contactVert) : edgeDist[index + VertexPlane];
+            if (vertexDist >= 0.0)
+            {
+                F64 lastVertexDist = moved ? edgePlaneDist(index + LastVertexPlane, contactVert) : edgeDist[index + LastVertexPlane];
+                if (lastVertexDist >= 0.0)
+                {
+                    PlaneD vertPlane(sgEdgeX[index], sgEdgeY[index], sgEdgeZ[index], sgEdgeD[index]);
+                    if (mbg)
+                        finalContact = vertPlane.project(contactVert);
+                    else
+                        contactVert = vertPlane.project(contactVert);
+                    break;
+                }
+                if (mbg)
+                    finalContact = lastVertex;
+                else
+                {
+                    contactVert = lastVertex;
+                    moved = true;
+                }
+            }
+            else
+            {
+                if (mbg)
+                    finalContact = vertex;
+                else
+                {
+                    contactVert = vertex;
+                    moved = true;
+                }
+            }
+        }
+        lastVertex = vertex;
+    }
+
+    contact = mbg ? finalContact : contactVert;
+    return true;
+}
+
 void Marble::clearObjectsAndPolys()
 {
     sgResetFindObjects = true;
@@ -99,6 +394,8 @@ void Marble::findObjectsAndPolys(U32 collisionMask, const Box3F& testBox, bool t
 		        marbles.push_back(reinterpret_cast<Marble*>(obj));
 		    }
 		}
+
+		cachePolyListPlanes();
     }
 }
 
@@ -196,38 +493,48 @@ bool Marble::testMove(Point3D velocity, Point3D& position, F64& deltaT, F64 radi
     {
         ConcretePolyList::Poly* poly;
 
-        for (S32 index = 0; index < polyList.mPolyList.size(); index++)
-        {
-            poly = &polyList.mPolyList[index];
+        validatePolyListPlanes();
 
-            PlaneD polyPlane = poly->plane;
+        // Test the polys against the direction and final position in batches,
+        // the distances are redone for the rest of the polys whenever a
+        // collision moves the final position.
+        U32 numPolys = polyList.mPolyList.size();
+        Point3D culledPosition = finalPosition;
+        computePlaneDots(velocityDir, false, 0, numPolys, sgPlaneDot.address());
+        computePlaneDots(culledPosition, true, 0, numPolys, sgPlaneDist.address());
+
+        for (S32 index = 0; index < (S32)numPolys; index++)
+        {
+            if (finalPosition != culledPosition)
+            {
+                culledPosition = finalPosition;
+                computePlaneDots(culledPosition, true, index, numPolys, sgPlaneDist.address());
+            }
 
             // If we're going the wrong direction or not going to touch the plane, ignore...
-            if (mDot(polyPlane, velocityDir) > -0.001 || mDot(polyPlane, finalPosition) + polyPlane.d > radius)
+            if (sgPlaneDot[index] > -0.001 || sgPlaneDist[index] > radius)
                 continue;
 
+            poly = &polyList.mPolyList[index];
+
+            PlaneD polyPlane = poly->plane;
+
             // Time until collision with the plane
             F64 collisionTime = (radius - (mDot(polyPlane, position) + polyPlane.d)) / mDot(polyPlane, velocity);
 
             // Are we going to touch the plane during this time step?
             if (collisionTime >= 0.0 && finalT >= collisionTime)
             {
-                U32 lastVertIndex = polyList.mIndexList[poly->vertexCount - 1 + poly->vertexStart];
-                Point3F lastVert = polyList.mVertexList[lastVertIndex];
-
                 Point3D collisionPos = velocity * collisionTime + position;
 
                 U32 i;
                 for (i = 0; i < poly->vertexCount; i++)
                 {
-                    Point3F thisVert = polyList.mVertexList[polyList.mIndexList[i + poly->vertexStart]];
-                    if (thisVert != lastVert)
+                    const MarbleEdge& edge = sgPolyEdges[i + poly->vertexStart];
+                    if (!edge.degenerate)
                     {
-                        PlaneD edgePlane(thisVert + polyPlane, thisVert, lastVert);
-                        lastVert = thisVert;
-
                         // if we are on the far side of the edge
-                        if (mDot(edgePlane, collisionPos) + edgePlane.d < 0.0)
+                        if (mDot(edge.movePlane, collisionPos) + edge.movePlane.d < 0.0)
                             break;
                     }
                 }
@@ -257,8 +564,9 @@ bool Marble::testMove(Point3D velocity, Point3D& position, F64& deltaT, F64 radi
             for (S32 iter = 0; iter < poly->vertexCount; iter++)
             {
                 Point3D thisVert = polyList.mVertexList[polyList.mIndexList[iter + poly->vertexStart]];
+                const MarbleEdge& edge = sgPolyEdges[iter + poly->vertexStart];
 
-                Point3D vertDiff = lastVert - thisVert;
+                const Point3D& vertDiff = edge.dir;
                 Point3D posDiff = position - thisVert;
                 
                 Point3D velRejection = mCross(vertDiff, velocity);
@@ -269,7 +577,7 @@ bool Marble::testMove(Point3D velocity, Point3D& position, F64& deltaT, F64 radi
                 F64 halfB = mDot(posRejection, velRejection);
                 F64 b = halfB + halfB;
 
-                F64 discriminant = b * b - (posRejection.lenSquared() - vertDiff.lenSquared() * radSq) * (a * 4.0);
+                F64 discriminant = b * b - (posRejection.lenSquared() - edge.lenSq * radSq) * (a * 4.0);
 
                 // If it's not quadratic or has no solution, ignore this edge.
                 if (a == 0.0 || discriminant < 0.0)
@@ -303,7 +611,7 @@ bool Marble::testMove(Point3D velocity, Point3D& position, F64& deltaT, F64 radi
                 // Check if the collision hasn't already happened
                 if (edgeCollisionTime >= 0.0)
                 {
-                    F64 edgeLen = vertDiff.len();
+                    F64 edgeLen = edge.len;
 
                     Point3D relativeCollisionPos = velocity * edgeCollisionTime + position - thisVert;
 
@@ -564,56 +872,20 @@ void Marble::findContacts(U32 contactMask, const Point3D* inPos, const F32* inRa
         }
     }
     
+	validatePolyListPlanes();
+	computePlaneDots(*pos, true, 0, polyList.mPolyList.size(), sgPlaneDist.address());
+
 	for (int i = 0; i < polyList.mPolyList.size(); i++)
 	{
-		ConcretePolyList::Poly* poly = &polyList.mPolyList[i];
-		PlaneD plane(poly->plane);
-		F64 distance = plane.distToPlane(*pos);
+		F64 distance = sgPlaneDist[i];
 		if (mFabsD(distance) <= (F64)rad + 0.0001) {
-			Point3D lastVertex(polyList.mVertexList[polyList.mIndexList[poly->vertexStart + poly->vertexCount - 1]]);
-
-			Point3D contactVert = plane.project(*pos);
-
-            //if (mPhysics == MBG)
-            //{
-                Point3D finalContact = contactVert;
-            //}
-
-			F64 separation = mSqrtD(rad * rad - distance * distance);
-
-			for (int j = 0; j < poly->vertexCount; j++) {
-				Point3D vertex = polyList.mVertexList[polyList.mIndexList[poly->vertexStart + j]];
-				if (vertex != lastVertex) {
-					PlaneD vertPlane(vertex + plane, vertex, lastVertex);
-					F64 vertDistance = vertPlane.distToPlane(contactVert);
-					if (vertDistance < 0.0) {
-						if (vertDistance < -(separation + 0.0001))
-							goto superbreak;
-
-						if (PlaneD(vertPlane + vertex, vertex, vertex + plane).distToPlane(contactVert) >= 0.0) {
-							if (PlaneD(lastVertex - vertPlane, lastVertex, lastVertex + plane).distToPlane(contactVert) >= 0.0) {
-                                if (mPhysics == MBG || mPhysics == MBGSlopes)
-                                    finalContact = vertPlane.project(contactVert);
-                                else
-								    contactVert = vertPlane.project(contactVert);
-								break;
-							}
-                            if (mPhysics == MBG || mPhysics == MBGSlopes)
-                                finalContact = lastVertex;
-                            else
-							    contactVert = lastVertex;
-						}
-						else {
-                            if (mPhysics == MBG || mPhysics == MBGSlopes)
-							    finalContact = vertex;
-                            else
-                                contactVert = vertex;
-						}
-					}
-					lastVertex = vertex;
-				}
-			}
-            
+			ConcretePolyList::Poly* poly = &polyList.mPolyList[i];
+			PlaneD plane(poly->plane);
+
+			Point3D contactVert;
+			if (!findPolyContact(i, *pos, rad, distance, mPhysics == MBG || mPhysics == MBGSlopes, contactVert))
+				continue;
+
 			Material* matProp = poly->object->getMaterial(poly->material);
 
 			PathedInterior* hitPI = dynamic_cast<PathedInterior*>(poly->object);
@@ -627,11 +899,7 @@ void Marble::findContacts(U32 contactMask, const Point3D* inPos, const F32* inRa
 			}
 
 			U32 materialId = poly->material;
-            Point3D delta;
-            if (mPhysics == MBG || mPhysics == MBGSlopes)
-                delta = *pos - finalContact;
-            else
-			    delta = *pos - contactVert;
+			Point3D delta = *pos - contactVert;
 
 			F64 contactDistance = delta.len();
 			if ((F64)rad + 0.0001 < contactDistance) {
@@ -655,10 +923,7 @@ void Marble::findContacts(U32 contactMask, const Point3D* inPos, const F32* inRa
 
 			contact.restitution = restitution;
 			contact.normal = normal;
-            if (mPhysics == MBG || mPhysics == MBGSlopes)
-                contact.position = finalContact;
-            else
-			    contact.position = contactVert;
+			contact.position = contactVert;
 			contact.surfaceVelocity = surfaceVelocity;
 			contact.object = poly->object;
 			contact.contactDistance = contactDistance;
@@ -697,8 +962,6 @@ void Marble::findContacts(U32 contactMask, const Point3D* inPos, const F32* inRa
 				}
 			}
 		}
-	superbreak:
-		(void)0;
 	}
 }
 
@@ -753,6 +1016,7 @@ void Marble::computeFirstPlatformIntersect(F64& dt, Vector<PathedInterior*>& pit
                     SphereF sphere(boxCenter, diff.len());
                     polyList.clear();
                     it->buildPolyList(&polyList, itBox, sphere);
+                    cachePolyListPlanes();
 
                     Point3D position = mPosition;
                     testMove(vel, position, dt, mRadius, 0, false);
@@ -773,3 +1037,255 @@ void Marble::resetObjectsAndPolys(U32 collisionMask, const Box3F& testBox)
     if (smPathItrVec.empty())
         findObjectsAndPolys(collisionMask, testBox, false);
 }
+
+//----------------------------------------------------------------------------
+// Contact benchmark
+
+/// findPolyContact() the way findContacts() did it before the edge planes
+/// were cached, building every plane in place.  Kept to check and time the
+/// cached version against.
+static bool refFindPolyContact(U32 polyIndex, const Point3D& pos, F32 rad, F64 distance, bool mbg, Point3D& contact)
+{
+    const ConcretePolyList& polyList = Marble::polyList;
+    const ConcretePolyList::Poly* poly = &polyList.mPolyList[polyIndex];
+    PlaneD plane(poly->plane);
+
+    Point3D lastVertex(polyList.mVertexList[polyList.mIndexList[poly->vertexStart + poly->vertexCount - 1]]);
+    Point3D contactVert = plane.project(pos);
+    Point3D finalContact = contactVert;
+
+    F64 separation = mSqrtD(rad * rad - distance * distance);
+
+    for (U32 j = 0; j < poly->vertexCount; j++)
+    {
+        Point3D vertex = polyList.mVertexList[polyList.mIndexList[poly->vertexStart + j]];
+        if (vertex != lastVertex)
+        {
+            PlaneD vertPlane(vertex + plane, vertex, lastVertex);
+            F64 vertDistance = vertPlane.distToPlane(contactVert);
+            if (vertDistance < 0.0)
+            {
+                if (vertDistance < -(separation + 0.0001))
+                    return false;
+
+                if (PlaneD(vertPlane + vertex, vertex, vertex + plane).distToPlane(contactVert) >= 0.0)
+                {
+                    if (PlaneD(lastVertex - vertPlane, lastVertex, lastVertex + plane).distToPlane(contactVert) >= 0.0)
+                    {
+                        if (mbg)
+                            finalContact = vertPlane.project(contactVert);
+                        else
+                            contactVert = vertPlane.project(contactVert);
+                        break;
+                    }
+                    if (mbg)
+                        finalContact = lastVertex;
+                    else
+                        contactVert = lastVertex;
+                }
+                else
+                {
+                    if (mbg)
+                        finalContact = vertex;
+                    else
+                        contactVert = vertex;
+                }
+            }
+            lastVertex = vertex;
+        }
+    }
+
+    contact = mbg ? finalContact : contactVert;
+    return true;
+}
+
+enum
+{
+    BenchGridSize = 4,          ///< Cells along each side of the floor.
+    BenchPositions = 4096,
+};
+
+static const F32 BenchCellSize = 0.5f;
+static const F32 BenchRadius = 0.2f;
+
+static F32 getBenchHeight(MRandomLCG& rand)
+{
+    return rand.randF() * 0.25f;
+}
+
+/// Fills the marble poly list with a bumpy floor, about what findObjectsAndPolys()
+/// gathers around a marble: triangle pairs, and flat quads where every fifth
+/// one repeats a corner to give a degenerate edge.
+static void fillBenchPolyList(MRandomLCG& rand)
+{
+    ConcretePolyList& polyList = Marble::polyList;
+    polyList.clear();
+
+    MatrixF identity(true);
+    polyList.setTransform(&identity, Point3F(1, 1, 1));
+
+    F32 heights[BenchGridSize + 1][BenchGridSize + 1];
+    for (U32 x = 0; x <= BenchGridSize; x++)
+        for (U32 y = 0; y <= BenchGridSize; y++)
+            heights[x][y] = getBenchHeight(rand);
+
+    U32 quads = 0;
+    for (U32 x = 0; x < BenchGridSize; x++)
+    {
+        for (U32 y = 0; y < BenchGridSize; y++)
+        {
+            F32 x0 = x * BenchCellSize, x1 = x0 + BenchCellSize;
+            F32 y0 = y * BenchCellSize, y1 = y0 + BenchCellSize;
+
+            if (rand.randI(0, 2) == 0)
+            {
+                F32 z = heights[x][y];
+                U32 v0 = polyList.addPoint(Point3F(x0, y0, z));
+                U32 v1 = polyList.addPoint(Point3F(x1, y0, z));
+                U32 v2 = polyList.addPoint(Point3F(x1, y1, z));
+                U32 v3 = polyList.addPoint(Point3F(x0, y1, z));
+
+                polyList.begin(0, 0);
+                polyList.vertex(v0);
+                polyList.vertex(v1);
+                if (quads++ % 5 == 0)
+                    polyList.vertex(v1);
+                polyList.vertex(v2);
+                polyList.vertex(v3);
+                polyList.plane(v0, v1, v2);
+                polyList.end();
+                continue;
+            }
+
+            U32 v0 = polyList.addPoint(Point3F(x0, y0, heights[x][y]));
+            U32 v1 = polyList.addPoint(Point3F(x1, y0, heights[x + 1][y]));
+            U32 v2 = polyList.addPoint(Point3F(x1, y1, heights[x + 1][y + 1]));
+            U32 v3 = polyList.addPoint(Point3F(x0, y1, heights[x][y + 1]));
+
+            polyList.begin(0, 0);
+            polyList.vertex(v0);
+            polyList.vertex(v1);
+            polyList.vertex(v2);
+            polyList.plane(v0, v1, v2);
+            polyList.end();
+
+            polyList.begin(0, 0);
+            polyList.vertex(v0);
+            polyList.vertex(v2);
+            polyList.vertex(v3);
+            polyList.plane(v0, v2, v3);
+            polyList.end();
+        }
+    }
+
+    Marble::cachePolyListPlanes();
+}
+
+/// Runs the contact search of findContacts() for every poly near @a pos,
+/// through the reference or the cached tests, adding the contacts found to
+/// @a sum.  Returns the number of contacts.
+static U32 benchContacts(const Point3D& pos, bool mbg, bool ref, F64& sum)
+{
+    const ConcretePolyList& polyList = Marble::polyList;
+    U32 numPolys = polyList.mPolyList.size();
+    U32 contacts = 0;
+
+    if (!ref)
+        computePlaneDots(pos, true, 0, numPolys, sgPlaneDist.address());
+
+    for (U32 i = 0; i < numPolys; i++)
+    {
+        F64 distance = ref ? PlaneD(polyList.mPolyList[i].plane).distToPlane(pos) : sgPlaneDist[i];
+        if (mFabsD(distance) > (F64)BenchRadius + 0.0001)
+            continue;
+
+        Point3D contact;
+        bool hit = ref ? refFindPolyContact(i, pos, BenchRadius, distance, mbg, contact) :
+                         findPolyContact(i, pos, BenchRadius, distance, mbg, contact);
+        if (hit)
+        {
+            sum += contact.x + contact.y + contact.z;
+            contacts++;
+        }
+    }
+    return contacts;
+}
+
+ConsoleFunction(marbleContactBenchmark, void, 1, 2, "marbleContactBenchmark( [passes] );"
+    "Checks the cached edge plane contact tests of findContacts() against building the planes in place, "
+    "bit for bit on random marbles over a bumpy floor, then times both.  Clears the marble poly list.")
+{
+    U32 passes = argc > 1 ? getMax(dAtoi(argv[1]), 1) : 100;
+
+    MRandomLCG rand(1376312589);
+    fillBenchPolyList(rand);
+
+    F32 extent = BenchGridSize * BenchCellSize;
+    Point3D* positions = new Point3D[BenchPositions];
+    for (U32 i = 0; i < BenchPositions; i++)
+        positions[i].set(rand.randF(0.0f, extent), rand.randF(0.0f, extent), rand.randF(-BenchRadius, 0.25f + BenchRadius));
+
+    // Compare every contact, both ways of walking the edges
+    const ConcretePolyList& polyList = Marble::polyList;
+    U32 contacts = 0, mismatches = 0;
+    for (U32 i = 0; i < BenchPositions; i++)
+    {
+        computePlaneDots(positions[i], true, 0, polyList.mPolyList.size(), sgPlaneDist.address());
+
+        for (U32 j = 0; j < polyList.mPolyList.size(); j++)
+        {
+            F64 distance = PlaneD(polyList.mPolyList[j].plane).distToPlane(positions[i]);
+            if (dMemcmp(&distance, &sgPlaneDist[j], sizeof(distance)))
+                mismatches++;
+            if (mFabsD(distance) > (F64)BenchRadius + 0.0001)
+                continue;
+
+            for (U32 mbg = 0; mbg < 2; mbg++)
+            {
+                Point3D refContact(0, 0, 0), contact(0, 0, 0);
+                bool refHit = refFindPolyContact(j, positions[i], BenchRadius, distance, mbg, refContact);
+                bool hit = findPolyContact(j, positions[i], BenchRadius, distance, mbg, contact);
+                if (refHit != hit || dMemcmp(&refContact, &contact, sizeof(contact)))
+                    mismatches++;
+                contacts += hit;
+            }
+        }
+    }
+
+    U32 refTime = 0, cachedTime = 0;
+    U32 refCount = 0, cachedCount = 0;
+    F64 refSum = 0.0, cachedSum = 0.0;
+    for (U32 pass = 0; pass < passes; pass++)
+    {
+        bool mbg = pass & 1;
+
+        U32 start = Platform::getRealMilliseconds();
+        for (U32 i = 0; i < BenchPositions; i++)
+            refCount += benchContacts(positions[i], mbg, true, refSum);
+        refTime += Platform::getRealMilliseconds() - start;
+
+        start = Platform::getRealMilliseconds();
+        for (U32 i = 0; i < BenchPositions; i++)
+            cachedCount += benchContacts(positions[i], mbg, false, cachedSum);
+        cachedTime += Platform::getRealMilliseconds() - start;
+    }
+
+    bool same = refCount == cachedCount && !dMemcmp(&refSum, &cachedSum, sizeof(refSum));
+    F32 speedup = cachedTime ? F32(refTime) / F32(cachedTime) : 0.0f;
+
+    Con::printf("Marble contact benchmark: %d passes", passes);
+    Con::printf("   %d polys, %d marbles: %d contacts, %d mismatches%s", polyList.mPolyList.size(), BenchPositions,
+        contacts, mismatches, mismatches ? " - CONTACTS CHANGED" : "");
+    Con::printf("   %d contacts per pass, %s", refCount / passes, same ? "same contacts" : "CONTACTS DIFFER");
+    Con::printf("   %-8s %6s     %6s     %6s", "", "planes", "cached", "speedup");
+    Con::printf("   %-8s %6d ms  %6d ms  %5.2fx", "contacts", refTime, cachedTime, speedup);
+
+    delete[] positions;
+
+    // Let the next tick gather the polys again
+    Marble::polyList.clear();
+    Marble::cachePolyListPlanes();
+    sgResetFindObjects = true;
+    sgLastCollisionBox.min.set(0, 0, 0);
+    sgLastCollisionBox.max.set(0, 0, 0);
+}
@@ -82,6 +82,7 @@
 #include "platform/event.h"
 #include "core/dnet.h"
 #include "core/tVector.h"
+#include "core/tDictionary.h"
 #include "core/resManager.h"
 #include "core/bitStream.h"
 #include "console/console.h"
@@ -97,7 +98,8 @@ static const char* versionString = "VER1";
 Vector<NetAddress> localNetAddresses;
 Vector<ServerInfo> gServerList(__FILE__, __LINE__);
 static Vector<MasterInfo> gMasterServerList(__FILE__, __LINE__);
-static Vector<NetAddress> gFinishedList(__FILE__, __LINE__); // timed out servers and finished servers go here
+static HashTable<U64, U32> gServerIndex;       // address key -> index into gServerList
+static HashTable<U64, bool> gFinishedList;      // timed out servers and finished servers go here
 NetAddress gMasterServerQueryAddress;
 bool gServerBrowserDirty = false;
 
@@ -106,8 +108,10 @@ static const S32 gMasterServerRetryCount = 3;
 static const S32 gMasterServerTimeout = 2000;
 static const S32 gPacketRetryCount = 4;
 static const S32 gPacketTimeout = 1000;
-static const S32 gMaxConcurrentPings = 10;
-static const S32 gMaxConcurrentQueries = 2;
+static const S32 gMinConcurrentRequests = 2;
+static const S32 gInitialConcurrentPings = 10;
+static const S32 gInitialConcurrentQueries = 4;
+static const S32 gMaxConcurrentRequests = 128;
 static const S32 gPingRetryCount = 4;
 static const S32 gPingTimeout = 800;
 static const S32 gQueryRetryCount = 4;
@@ -139,9 +143,246 @@ struct Ping
     bool isLocal;
 };
 
+//-----------------------------------------------------------------------------
+
+/// Packs the parts of an address that Net::compareAddresses() looks at into a
+/// single hash key.  The IP goes in the low bits so the key still spreads well
+/// where the hash table truncates it to 32 bits.
+///
+/// @note IPX node numbers are not part of the key, the server browser only
+///       deals with IP addresses.
+static inline U64 getAddressKey(const NetAddress* addr)
+{
+    U32 netNum = (U32(addr->netNum[0]) << 24) | (U32(addr->netNum[1]) << 16) |
+        (U32(addr->netNum[2]) << 8) | U32(addr->netNum[3]);
+    return (U64(addr->type & 0xFFFF) << 48) | (U64(addr->port) << 32) | U64(netNum);
+}
+
+//-----------------------------------------------------------------------------
+
+/// Outstanding pings or queries, looked up by address.
+///
+/// New entries wait in a FIFO until the scheduler lets them go out, then move
+/// to the in-flight list that is checked for resends and timeouts every tick.
+/// Every entry is indexed by its address key, so matching a response to its
+/// request no longer walks the whole list.
+class PingList
+{
+    enum { WaitingFlag = BIT(31) };
+
+    Vector<Ping> mActive;         ///< Requests that have been sent at least once.
+    Vector<Ping> mWaiting;        ///< Requests not sent yet, oldest first from mWaitingHead.
+    U32 mWaitingHead;
+    U32 mWaitingCount;            ///< Live entries in mWaiting, removed ones leave a hole.
+    U32 mBroadcastCount;
+    HashTable<U64, U32> mIndex;   ///< Address key -> index into mActive, or into mWaiting | WaitingFlag.
+
+    bool isWaitingSlot(U32 slot)
+    {
+        HashTable<U64, U32>::Iterator itr = mIndex.find(getAddressKey(&mWaiting[slot].address));
+        return itr != mIndex.end() && itr->value == (slot | WaitingFlag);
+    }
+
+    void unlink(const Ping& p, HashTable<U64, U32>::Iterator itr)
+    {
+        mIndex.erase(itr);
+        if (p.broadcast)
+            mBroadcastCount--;
+    }
+
+public:
+    PingList() : mWaitingHead(0), mWaitingCount(0), mBroadcastCount(0) {}
+
+    U32 size() const { return mActive.size() + mWaitingCount; }
+    U32 getActiveCount() const { return mActive.size(); }
+    U32 getWaitingCount() const { return mWaitingCount; }
+    U32 getBroadcastCount() const { return mBroadcastCount; }
+
+    Ping& getActive(U32 index) { return mActive[index]; }
+
+    /// Returns the entry for @a addr whether it was sent yet or not, or NULL.
+    Ping* find(const NetAddress* addr)
+    {
+        HashTable<U64, U32>::Iterator itr = mIndex.find(getAddressKey(addr));
+        if (itr == mIndex.end())
+            return NULL;
+        return (itr->value & WaitingFlag) ? &mWaiting[itr->value & ~WaitingFlag] : &mActive[itr->value];
+    }
+
+    /// Queues @a p behind the other waiting entries.  Returns false if there
+    /// already is an entry for the address.
+    bool push(const Ping& p)
+    {
+        if (mIndex.insertUnique(getAddressKey(&p.address), mWaiting.size() | WaitingFlag) == mIndex.end())
+            return false;
+        mWaiting.push_back(p);
+        mWaitingCount++;
+        if (p.broadcast)
+            mBroadcastCount++;
+        return true;
+    }
+
+    /// Moves the oldest waiting entry to the in-flight list and returns it.
+    Ping* activateNext()
+    {
+        while (mWaitingHead < mWaiting.size() && !isWaitingSlot(mWaitingHead))
+            mWaitingHead++;
+        if (mWaitingHead == mWaiting.size())
+            return NULL;
+
+        mIndex.find(getAddressKey(&mWaiting[mWaitingHead].address))->value = mActive.size();
+        mActive.push_back(mWaiting[mWaitingHead++]);
+        mWaitingCount--;
+
+        // Drop the consumed part of the FIFO once it dominates the vector:
+        if (mWaitingHead > 64 && mWaitingHead * 2 > mWaiting.size())
+        {
+            U32 shift = mWaitingHead;
+            for (U32 i = shift; i < mWaiting.size(); i++)
+            {
+                HashTable<U64, U32>::Iterator itr = mIndex.find(getAddressKey(&mWaiting[i].address));
+                if (itr != mIndex.end() && itr->value == (i | WaitingFlag))
+                    itr->value = (i - shift) | WaitingFlag;
+                mWaiting[i - shift] = mWaiting[i];
+            }
+            mWaiting.setSize(mWaiting.size() - shift);
+            mWaitingHead = 0;
+        }
+        return &mActive.last();
+    }
+
+    /// Removes the in-flight entry at @a index.  The last in-flight entry takes
+    /// its place.
+    void removeActive(U32 index)
+    {
+        unlink(mActive[index], mIndex.find(getAddressKey(&mActive[index].address)));
+        if (index != mActive.size() - 1)
+        {
+            mActive[index] = mActive.last();
+            mIndex.find(getAddressKey(&mActive[index].address))->value = index;
+        }
+        mActive.pop_back();
+    }
+
+    void remove(const NetAddress* addr)
+    {
+        HashTable<U64, U32>::Iterator itr = mIndex.find(getAddressKey(addr));
+        if (itr == mIndex.end())
+            return;
+
+        if (itr->value & WaitingFlag)
+        {
+            // Leave a hole, activateNext() skips over it:
+            unlink(mWaiting[itr->value & ~WaitingFlag], itr);
+            mWaitingCount--;
+        }
+        else
+            removeActive(itr->value);
+    }
+
+    /// Removes and returns an arbitrary entry, for draining the list.
+    Ping pop()
+    {
+        AssertFatal(size(), "PingList::pop - list is empty.");
+        if (!mActive.size())
+            activateNext();
+        Ping p = mActive.last();
+        removeActive(mActive.size() - 1);
+        return p;
+    }
+
+    void clear()
+    {
+        mActive.clear();
+        mWaiting.clear();
+        mWaitingHead = mWaitingCount = mBroadcastCount = 0;
+        mIndex.clear();
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+/// Number of requests one phase of a server query may have in flight.
+///
+/// Behaves like TCP congestion control: the window grows by one for every
+/// reply until it first has to back off, and by a fraction of a request per
+/// reply after that.  Lost requests halve it, at most once per timeout period
+/// so a batch of dead servers timing out together only counts once.
+struct RequestWindow
+{
+    F32 size;
+    F32 threshold;     ///< Size below which every reply grows the window by one.
+    U32 lastBackoff;
+
+    RequestWindow(S32 initialSize) { reset(initialSize); }
+
+    void reset(S32 initialSize)
+    {
+        size = F32(initialSize);
+        threshold = F32(gMaxConcurrentRequests);
+        lastBackoff = 0;
+    }
+
+    void onReply()
+    {
+        size += (size < threshold) ? 1.0f : 1.0f / size;
+        size = getMin(size, F32(gMaxConcurrentRequests));
+    }
+
+    void onTimeout(U32 time, S32 timeout)
+    {
+        if (lastBackoff && time - lastBackoff < U32(timeout))
+            return;
+        threshold = getMax(size * 0.5f, F32(gMinConcurrentRequests));
+        size = threshold;
+        lastBackoff = time;
+    }
+
+    U32 getLimit() const { return U32(size); }
+};
+
+/// Token bucket shared by every ping and query packet we send, so a long
+/// master server list goes out at a steady rate instead of in bursts.
+///
+/// The rate is $pref::Net::ServerQueryRate packets per second, with at most
+/// $pref::Net::ServerQueryBurst packets going out back to back.
+struct SendBudget
+{
+    F32 tokens;
+    U32 lastTime;
+
+    // Starts out empty, the first refill() tops it up to a full burst.
+    SendBudget() : tokens(0.0f), lastTime(0) {}
+
+    void reset(U32 time)
+    {
+        tokens = F32(getMax(Con::getIntVariable("$pref::Net::ServerQueryBurst", 16), 1));
+        lastTime = time;
+    }
+
+    void refill(U32 time)
+    {
+        F32 rate = F32(getMax(Con::getIntVariable("$pref::Net::ServerQueryRate", 200), 1));
+        F32 burst = F32(getMax(Con::getIntVariable("$pref::Net::ServerQueryBurst", 16), 1));
+        tokens = getMin(tokens + F32(time - lastTime) * rate * 0.001f, burst);
+        lastTime = time;
+    }
+
+    bool take()
+    {
+        if (tokens < 1.0f)
+            return false;
+        tokens -= 1.0f;
+        return true;
+    }
+};
+
 static Ping gMasterServerPing;
-static Vector<Ping> gPingList(__FILE__, __LINE__);
-static Vector<Ping> gQueryList(__FILE__, __LINE__);
+static PingList gPingList;
+static PingList gQueryList;
+static RequestWindow gPingWindow(gInitialConcurrentPings);
+static RequestWindow gQueryWindow(gInitialConcurrentQueries);
+static SendBudget gSendBudget;
 
 //-----------------------------------------------------------------------------
 
@@ -245,8 +486,8 @@ static void pushPingRequest(const NetAddress* addr);
 static void pushPingBroadcast(const NetAddress* addr);
 static void pushServerFavorites();
 static bool pickMasterServer();
-static S32 findPingEntry(Vector<Ping>& v, const NetAddress* addr);
 static bool addressFinished(const NetAddress* addr);
+static void markAddressFinished(const NetAddress* addr);
 static ServerInfo* findServerInfo(const NetAddress* addr);
 static ServerInfo* findOrCreateServerInfo(const NetAddress* addr);
 static void removeServerInfo(const NetAddress* addr);
@@ -258,6 +499,10 @@ static void readLongCString(BitStream* stream, char* buffer);
 static void processMasterServerQuery(U32 session);
 static void processPingsAndQueries(U32 session, bool schedule = true);
 static void processServerListPackets(U32 session);
+#if defined(TORQUE_DEBUG)
+static bool routeFakeServerPacket(U8 pType, const NetAddress* addr, U32 key, U8 flags);
+static void finishServerQueryBenchmark();
+#endif
 static void processHeartbeat(U32);
 static void updatePingProgress();
 static void updateQueryProgress();
@@ -668,14 +913,9 @@ void querySingleServer(const NetAddress* addr, U8 /*flags*/)
         si->status = ServerInfo::Status_New | ServerInfo::Status_Updating;
 
     // Remove the server from the finished list (if it's there):
-    for (U32 i = 0; i < gFinishedList.size(); i++)
-    {
-        if (Net::compareAddresses(addr, &gFinishedList[i]))
-        {
-            gFinishedList.erase(i);
-            break;
-        }
-    }
+    HashTable<U64, bool>::Iterator itr = gFinishedList.find(getAddressKey(addr));
+    if (itr != gFinishedList.end())
+        gFinishedList.erase(itr);
 
     Con::executef(4, "onServerQueryStatus", "start", "Refreshing server...", "0");
     gServerPingCount = gServerQueryCount = 0;
@@ -700,21 +940,19 @@ void cancelServerQuery()
         // Clear the ping list:
         while (gPingList.size())
         {
-            si = findServerInfo(&gPingList[0].address);
+            Ping p = gPingList.pop();
+            si = findServerInfo(&p.address);
             if (si && !si->status.test(ServerInfo::Status_Responded))
                 si->status = ServerInfo::Status_TimedOut;
-
-            gPingList.erase(U32(0));
         }
 
         // Clear the query list:
         while (gQueryList.size())
         {
-            si = findServerInfo(&gQueryList[0].address);
+            Ping p = gQueryList.pop();
+            si = findServerInfo(&p.address);
             if (si && !si->status.test(ServerInfo::Status_Responded))
                 si->status = ServerInfo::Status_TimedOut;
-
-            gQueryList.erase(U32(0));
         }
 
         sgServerQueryActive = false;
@@ -742,8 +980,8 @@ void stopServerQuery()
         {
             while (gPingList.size())
             {
-                gFinishedList.push_back(gPingList[0].address);
-                gPingList.erase(U32(0));
+                Ping p = gPingList.pop();
+                markAddressFinished(&p.address);
             }
         }
         else
@@ -925,10 +1163,16 @@ void clearServerList(bool clearServerInfo)
 {
     gPacketStatusList.clear();
     if (clearServerInfo)
+    {
         gServerList.clear();
+        gServerIndex.clear();
+    }
     gFinishedList.clear();
     gPingList.clear();
     gQueryList.clear();
+    gPingWindow.reset(gInitialConcurrentPings);
+    gQueryWindow.reset(gInitialConcurrentQueries);
+    gSendBudget.reset(Platform::getVirtualMilliseconds());
     gServerPingCount = gServerQueryCount = 0;
     localNetAddresses.clear();
 
@@ -966,8 +1210,8 @@ static void pushPingRequest(const NetAddress* addr)
     p.tryCount = gPingRetryCount;
     p.broadcast = false;
     p.isLocal = false;
-    gPingList.push_back(p);
-    gServerPingCount++;
+    if (gPingList.push(p))
+        gServerPingCount++;
 }
 
 //-----------------------------------------------------------------------------
@@ -985,7 +1229,7 @@ static void pushPingBroadcast(const NetAddress* addr)
     p.tryCount = 1; // only try this once
     p.broadcast = true;
     p.isLocal = true;
-    gPingList.push_back(p);
+    gPingList.push(p);
     // Don't increment gServerPingCount, broadcasts are not
     // counted as requests.
 }
@@ -996,11 +1240,7 @@ static S32 countPingRequests()
 {
     // Need a function here because the ping list also includes
     // broadcast pings we don't want counted.
-    U32 pSize = gPingList.size(), count = pSize;
-    for (U32 i = 0; i < pSize; i++)
-        if (gPingList[i].broadcast)
-            count--;
-    return count;
+    return gPingList.size() - gPingList.getBroadcastCount();
 }
 
 
@@ -1048,32 +1288,24 @@ static void pushServerFavorites()
 
 //-----------------------------------------------------------------------------
 
-static S32 findPingEntry(Vector<Ping>& v, const NetAddress* addr)
+static bool addressFinished(const NetAddress* addr)
 {
-    for (U32 i = 0; i < v.size(); i++)
-        if (Net::compareAddresses(addr, &v[i].address))
-            return S32(i);
-    return -1;
+    return gFinishedList.find(getAddressKey(addr)) != gFinishedList.end();
 }
 
 //-----------------------------------------------------------------------------
 
-static bool addressFinished(const NetAddress* addr)
+static void markAddressFinished(const NetAddress* addr)
 {
-    for (U32 i = 0; i < gFinishedList.size(); i++)
-        if (Net::compareAddresses(addr, &gFinishedList[i]))
-            return true;
-    return false;
+    gFinishedList.insertUnique(getAddressKey(addr), true);
 }
 
 //-----------------------------------------------------------------------------
 
 static ServerInfo* findServerInfo(const NetAddress* addr)
 {
-    for (U32 i = 0; i < gServerList.size(); i++)
-        if (Net::compareAddresses(addr, &gServerList[i].address))
-            return &gServerList[i];
-    return NULL;
+    HashTable<U64, U32>::Iterator itr = gServerIndex.find(getAddressKey(addr));
+    return (itr != gServerIndex.end()) ? &gServerList[itr->value] : NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -1086,6 +1318,7 @@ static ServerInfo* findOrCreateServerInfo(const NetAddress* addr)
 
     ServerInfo si;
     si.address = *addr;
+    gServerIndex.insertUnique(getAddressKey(addr), gServerList.size());
     gServerList.push_back(si);
 
     return &gServerList.last();
@@ -1095,14 +1328,18 @@ static ServerInfo* findOrCreateServerInfo(const NetAddress* addr)
 
 static void removeServerInfo(const NetAddress* addr)
 {
-    for (U32 i = 0; i < gServerList.size(); i++)
-    {
-        if (Net::compareAddresses(addr, &gServerList[i].address))
-        {
-            gServerList.erase(i);
-            gServerBrowserDirty = true;
-        }
-    }
+    HashTable<U64, U32>::Iterator itr = gServerIndex.find(getAddressKey(addr));
+    if (itr == gServerIndex.end())
+        return;
+
+    U32 index = itr->value;
+    gServerIndex.erase(itr);
+    gServerList.erase(index);
+    gServerBrowserDirty = true;
+
+    // Everything behind the removed server moved down a slot:
+    for (U32 i = index; i < gServerList.size(); i++)
+        gServerIndex.find(getAddressKey(&gServerList[i].address))->value = i;
 }
 
 //-----------------------------------------------------------------------------
@@ -1127,6 +1364,19 @@ static void addLocalAddress(const NetAddress* addr)
 //-----------------------------------------------------------------------------
 
 #if defined(TORQUE_DEBUG)
+// Fake servers get addresses in the 198.18.0.0/15 network reserved for
+// benchmarking (RFC 2544), so they never collide with real servers.
+static void getFakeServerAddress(S32 index, NetAddress* addr)
+{
+    dMemset(addr, 0, sizeof(NetAddress));
+    addr->type = NetAddress::IPAddress;
+    addr->netNum[0] = 198;
+    addr->netNum[1] = 18 + ((index >> 16) & 1);
+    addr->netNum[2] = (index >> 8) & 0xFF;
+    addr->netNum[3] = index & 0xFF;
+    addr->port = 28000;
+}
+
 // This function is solely for testing the functionality of the server browser
 // with more servers in the list.
 void addFakeServers(S32 howMany)
@@ -1136,6 +1386,13 @@ void addFakeServers(S32 howMany)
 
     for (S32 i = 0; i < howMany; i++)
     {
+        getFakeServerAddress(sNumFakeServers, &newServer.address);
+        if (findServerInfo(&newServer.address))
+        {
+            sNumFakeServers++;
+            continue;
+        }
+
         newServer.numPlayers = Platform::getRandom() * 64;
         newServer.maxPlayers = 64;
         char buf[256];
@@ -1144,15 +1401,15 @@ void addFakeServers(S32 howMany)
         dStrcpy(newServer.name, buf);
         newServer.gameType = (char*)dMalloc(5);
         dStrcpy(newServer.gameType, "Fake");
-        newServer.missionType = (char*)dMalloc(4);
+        newServer.missionType = (char*)dMalloc(16);
         dStrcpy(newServer.missionType, "FakeMissionType");
-        newServer.missionName = (char*)dMalloc(14);
+        newServer.missionName = (char*)dMalloc(12);
         dStrcpy(newServer.missionName, "FakeMapName");
-        Net::stringToAddress("IP:198.74.33.35:28000", &newServer.address);
         newServer.ping = (Platform::getRandom() * 200);
         newServer.cpuSpeed = 470;
         newServer.status = ServerInfo::Status_Responded;
 
+        gServerIndex.insertUnique(getAddressKey(&newServer.address), gServerList.size());
         gServerList.push_back(newServer);
         sNumFakeServers++;
     }
@@ -1165,6 +1422,11 @@ void addFakeServers(S32 howMany)
 
 static void sendPacket(U8 pType, const NetAddress* addr, U32 key, U32 session, U8 flags)
 {
+#if defined(TORQUE_DEBUG)
+    if (routeFakeServerPacket(pType, addr, U32((session << 16) | (key & 0xFFFF)), flags))
+        return;
+#endif
+
     BitStream* out = BitStream::getPacketStream();
     out->write(pType);
     out->write(flags);
@@ -1318,145 +1580,194 @@ static void processMasterServerQuery(U32 session)
 
 //-----------------------------------------------------------------------------
 
+static void sendPingRequest(Ping& p, U32 time, U8 flags)
+{
+    char addressString[256];
+
+    p.tryCount--;
+    p.time = time;
+    p.key = gKey++;
+
+    Net::addressToString(&p.address, addressString);
+
+    if (p.broadcast)
+        Con::printf("LAN server ping: %s...", addressString);
+    else
+        Con::printf("Pinging Server %s (%d)...", addressString, p.tryCount);
+    sendPacket(NetInterface::GamePingRequest, &p.address, p.key, p.session, flags);
+
+#ifdef TORQUE_NET_HOLEPUNCHING
+    if (!p.broadcast) {
+        BitStream* out = BitStream::getPacketStream();
+        out->write(U8(NetInterface::MasterServerGamePingRequest));
+        out->write(p.address.netNum[0]);
+        out->write(p.address.netNum[1]);
+        out->write(p.address.netNum[2]);
+        out->write(p.address.netNum[3]);
+        out->write(p.address.port);
+        out->write(flags);
+        out->write((p.session << 16) | (p.key & 0xFFFF));
+        for (int i = 0; i < gMasterServerList.size(); i++)
+            BitStream::sendPacketStream(&gMasterServerList[i].address);
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+
+static void sendQueryRequest(Ping& p, ServerInfo* si, U32 time, U8 flags)
+{
+    char addressString[256];
+
+    p.tryCount--;
+    p.time = time;
+    p.key = gKey++;
+
+    Net::addressToString(&p.address, addressString);
+    Con::printf("Querying Server %s (%d)...", addressString, p.tryCount);
+    sendPacket(NetInterface::GameInfoRequest, &p.address, p.key, p.session, flags);
+
+#ifdef TORQUE_NET_HOLEPUNCHING
+    if (!p.broadcast) {
+        BitStream* out = BitStream::getPacketStream();
+        out->write(U8(NetInterface::MasterServerGameInfoRequest));
+        out->write(p.address.netNum[0]);
+        out->write(p.address.netNum[1]);
+        out->write(p.address.netNum[2]);
+        out->write(p.address.netNum[3]);
+        out->write(p.address.port);
+        out->write(flags);
+        out->write((p.session << 16) | (p.key & 0xFFFF));
+
+        for (int i = 0; i < gMasterServerList.size(); i++)
+            BitStream::sendPacketStream(&gMasterServerList[i].address);
+    }
+#endif
+
+    if (!si->isQuerying())
+    {
+        si->status |= ServerInfo::Status_Querying;
+        gServerBrowserDirty = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 static void processPingsAndQueries(U32 session, bool schedule)
 {
     if (session != gPingSession)
         return;
 
     U32 i = 0;
-    U32 activePings = 0;
     U32 time = Platform::getVirtualMilliseconds();
     char addressString[256];
     U8 flags = ServerFilter::OnlineQuery;
     bool waitingForMaster = (sActiveFilter.type == ServerFilter::Normal) && !gGotFirstListPacket && sgServerQueryActive;
 
-    for (i = 0; i < gPingList.size() && i < gMaxConcurrentPings; )
+    gSendBudget.refill(time);
+
+    // Resend or time out the pings that are already out:
+    for (i = 0; i < gPingList.getActiveCount(); )
     {
-        Ping& p = gPingList[i];
+        Ping& p = gPingList.getActive(i);
 
-        if (p.time + gPingTimeout < time)
+        if (p.time + gPingTimeout >= time)
         {
-            if (!p.tryCount)
-            {
-                // it's timed out.
-                if (!p.broadcast)
-                {
-                    Net::addressToString(&p.address, addressString);
-                    Con::printf("Ping to server %s timed out.", addressString);
-                }
-
-                // If server info is in list (favorite), set its status:
-                ServerInfo* si = findServerInfo(&p.address);
-                if (si)
-                {
-                    si->status = ServerInfo::Status_TimedOut;
-                    gServerBrowserDirty = true;
-                }
-
-                gFinishedList.push_back(p.address);
-                gPingList.erase(i);
+            i++;
+            continue;
+        }
 
-                if (!waitingForMaster)
-                    updatePingProgress();
-            }
-            else
+        if (!p.tryCount)
+        {
+            // it's timed out.
+            if (!p.broadcast)
             {
-                p.tryCount--;
-                p.time = time;
-                p.key = gKey++;
-
                 Net::addressToString(&p.address, addressString);
+                Con::printf("Ping to server %s timed out.", addressString);
+            }
 
-                if (p.broadcast)
-                    Con::printf("LAN server ping: %s...", addressString);
-                else
-                    Con::printf("Pinging Server %s (%d)...", addressString, p.tryCount);
-                sendPacket(NetInterface::GamePingRequest, &p.address, p.key, p.session, flags);
-                
-#ifdef TORQUE_NET_HOLEPUNCHING
-                if (!p.broadcast) {
-                    BitStream* out = BitStream::getPacketStream();
-                    out->write(U8(NetInterface::MasterServerGamePingRequest));
-                    out->write(p.address.netNum[0]);
-                    out->write(p.address.netNum[1]);
-                    out->write(p.address.netNum[2]);
-                    out->write(p.address.netNum[3]);
-                    out->write(p.address.port);
-                    out->write(flags);
-                    out->write((p.session << 16) | (p.key & 0xFFFF));
-                    for (int i = 0; i < gMasterServerList.size(); i++)
-                        BitStream::sendPacketStream(&gMasterServerList[i].address);
-                }
-#endif
-
-                i++;
+            // If server info is in list (favorite), set its status:
+            ServerInfo* si = findServerInfo(&p.address);
+            if (si)
+            {
+                si->status = ServerInfo::Status_TimedOut;
+                gServerBrowserDirty = true;
             }
+
+            markAddressFinished(&p.address);
+            gPingList.removeActive(i);
+
+            if (!waitingForMaster)
+                updatePingProgress();
         }
         else
+        {
+            // Nobody answers broadcasts from the broadcast address itself, so
+            // only lost pings to real servers count against the window.
+            if (!gSendBudget.take())
+                break;
+            if (!p.broadcast)
+                gPingWindow.onTimeout(time, gPingTimeout);
+            sendPingRequest(p, time, flags);
             i++;
+        }
     }
 
+    // Send new pings while the window and the send budget allow it:
+    while (gPingList.getWaitingCount() && gPingList.getActiveCount() < gPingWindow.getLimit() && gSendBudget.take())
+        sendPingRequest(*gPingList.activateNext(), time, flags);
+
     if (!gPingList.size() && !waitingForMaster)
     {
         // Start the query phase:
-        for (U32 i = 0; i < gQueryList.size() && i < gMaxConcurrentQueries; )
+        for (i = 0; i < gQueryList.getActiveCount(); )
         {
-            Ping& p = gQueryList[i];
-            if (p.time + gPingTimeout < time)
+            Ping& p = gQueryList.getActive(i);
+            if (p.time + gQueryTimeout >= time)
             {
-                ServerInfo* si = findServerInfo(&p.address);
-                if (!si)
-                {
-                    // Server info not found, so remove the query:
-                    gQueryList.erase(i);
-                    gServerBrowserDirty = true;
-                    continue;
-                }
-
-                Net::addressToString(&p.address, addressString);
-                if (!p.tryCount)
-                {
-                    Con::printf("Query to server %s timed out.", addressString);
-                    si->status = ServerInfo::Status_TimedOut;
-                    gQueryList.erase(i);
-                    gServerBrowserDirty = true;
-                }
-                else
-                {
-                    p.tryCount--;
-                    p.time = time;
-                    p.key = gKey++;
+                i++;
+                continue;
+            }
 
-                    Con::printf("Querying Server %s (%d)...", addressString, p.tryCount);
-                    sendPacket(NetInterface::GameInfoRequest, &p.address, p.key, p.session, flags);
+            ServerInfo* si = findServerInfo(&p.address);
+            if (!si)
+            {
+                // Server info not found, so remove the query:
+                gQueryList.removeActive(i);
+                gServerBrowserDirty = true;
+                continue;
+            }
 
-#ifdef TORQUE_NET_HOLEPUNCHING
-                    if (!p.broadcast) {
-                        BitStream* out = BitStream::getPacketStream();
-                        out->write(U8(NetInterface::MasterServerGameInfoRequest));
-                        out->write(p.address.netNum[0]);
-                        out->write(p.address.netNum[1]);
-                        out->write(p.address.netNum[2]);
-                        out->write(p.address.netNum[3]);
-                        out->write(p.address.port);
-                        out->write(flags);
-                        out->write((p.session << 16) | (p.key & 0xFFFF));
-
-                        for (int i = 0; i < gMasterServerList.size(); i++)
-                            BitStream::sendPacketStream(&gMasterServerList[i].address);
-                    }
-#endif
-                    
-                    if (!si->isQuerying())
-                    {
-                        si->status |= ServerInfo::Status_Querying;
-                        gServerBrowserDirty = true;
-                    }
-                    i++;
-                }
+            if (!p.tryCount)
+            {
+                Net::addressToString(&p.address, addressString);
+                Con::printf("Query to server %s timed out.", addressString);
+                si->status = ServerInfo::Status_TimedOut;
+                gQueryList.removeActive(i);
+                gServerBrowserDirty = true;
             }
             else
+            {
+                if (!gSendBudget.take())
+                    break;
+                gQueryWindow.onTimeout(time, gQueryTimeout);
+                sendQueryRequest(p, si, time, flags);
                 i++;
+            }
+        }
+
+        // Send new queries while the window and the send budget allow it:
+        while (gQueryList.getWaitingCount() && gQueryList.getActiveCount() < gQueryWindow.getLimit() && gSendBudget.take())
+        {
+            Ping* p = gQueryList.activateNext();
+            ServerInfo* si = findServerInfo(&p->address);
+            if (si)
+                sendQueryRequest(*p, si, time, flags);
+            else
+            {
+                gQueryList.remove(&p->address);
+                gServerBrowserDirty = true;
+            }
         }
     }
 
@@ -1479,6 +1790,9 @@ static void processPingsAndQueries(U32 session, bool schedule)
         else
             dSprintf(msg, sizeof(msg), "%d servers found.", foundCount);
 
+#if defined(TORQUE_DEBUG)
+        finishServerQueryBenchmark();
+#endif
         Con::executef(4, "onServerQueryStatus", "done", msg, "1");
     }
 }
@@ -1855,23 +2169,26 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     if (!gPingList.size())
         return;
 
-    S32 index = findPingEntry(gPingList, address);
-    if (index == -1)
+    Ping* entry = gPingList.find(address);
+    if (!entry)
     {
         // an anonymous ping response - if it's not already timed
         // out or finished, ping it.  Probably from a broadcast
         if (!addressFinished(address)) {
             pushPingRequest(address);
-            S32 index = findPingEntry(gPingList, address);
-            gPingList[index].isLocal = true;
+            entry = gPingList.find(address);
+            if (entry)
+                entry->isLocal = true;
         }
         return;
     }
-    Ping& p = gPingList[index];
+    Ping p = *entry;
     U32 infoKey = (p.session << 16) | (p.key & 0xFFFF);
     if (infoKey != key)
         return;
 
+    gPingWindow.onReply();
+
     // Find if the server info already exists (favorite or refreshing):
     ServerInfo* si = findServerInfo(address);
     bool applyFilter = false;
@@ -1889,8 +2206,8 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     {
         // Version is different, so remove it from consideration:
         Con::printf("Server %s is a different version.", addrString);
-        gFinishedList.push_back(*address);
-        gPingList.erase(index);
+        markAddressFinished(address);
+        gPingList.remove(address);
         if (si)
         {
             si->status = ServerInfo::Status_TimedOut;
@@ -1907,8 +2224,8 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     if (temp32 < GameConnection::MinRequiredProtocolVersion)
     {
         Con::printf("Protocol for server %s does not meet minimum protocol.", addrString);
-        gFinishedList.push_back(*address);
-        gPingList.erase(index);
+        markAddressFinished(address);
+        gPingList.remove(address);
         if (si)
         {
             si->status = ServerInfo::Status_TimedOut;
@@ -1924,8 +2241,8 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     if (GameConnection::CurrentProtocolVersion < temp32)
     {
         Con::printf("You do not meet the minimum protocol for server %s.", addrString);
-        gFinishedList.push_back(*address);
-        gPingList.erase(index);
+        markAddressFinished(address);
+        gPingList.remove(address);
         if (si)
         {
             si->status = ServerInfo::Status_TimedOut;
@@ -1945,8 +2262,8 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     {
         // Ping is too high, so remove this server from consideration:
         Con::printf("Server %s filtered out by maximum ping.", addrString);
-        gFinishedList.push_back(*address);
-        gPingList.erase(index);
+        markAddressFinished(address);
+        gPingList.remove(address);
         if (si)
             removeServerInfo(address);
         if (!waitingForMaster)
@@ -1962,8 +2279,8 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     if (temp32 != getVersionNumber())
     {
         Con::printf("Server %s filtered out by version number.", addrString);
-        gFinishedList.push_back(*address);
-        gPingList.erase(index);
+        markAddressFinished(address);
+        gPingList.remove(address);
         if (si)
             removeServerInfo(address);
         if (!waitingForMaster)
@@ -1987,13 +2304,13 @@ static void handleGamePingResponse(const NetAddress* address, BitStream* stream,
     }
 
     // Set the server up to be queried:
-    gFinishedList.push_back(*address);
+    markAddressFinished(address);
     p.key = 0;
     p.time = 0;
     p.tryCount = gQueryRetryCount;
-    gQueryList.push_back(p);
-    gServerQueryCount++;
-    gPingList.erase(index);
+    if (gQueryList.push(p))
+        gServerQueryCount++;
+    gPingList.remove(address);
     if (!waitingForMaster)
         updatePingProgress();
 
@@ -2061,12 +2378,12 @@ static void handleGameInfoResponse(const NetAddress* address, BitStream* stream,
     if (!gQueryList.size())
         return;
 
-    S32 index = findPingEntry(gQueryList, address);
-    if (index == -1)
+    if (!gQueryList.find(address))
         return;
 
     // Remove the server from the query list since it has been so kind as to respond:
-    gQueryList.erase(index);
+    gQueryList.remove(address);
+    gQueryWindow.onReply();
     updateQueryProgress();
     ServerInfo* si = findServerInfo(address);
     if (!si)
@@ -2509,6 +2826,140 @@ static void handleMasterServerJoinInviteResponse(const NetAddress* address, BitS
 }
 #endif
 
+#if defined(TORQUE_DEBUG)
+//-----------------------------------------------------------------------------
+// Server query benchmark
+//
+// Pings and queries to fake server addresses never go out on the wire while a
+// benchmark is running.  Instead every fake server answers through a posted
+// event after the simulated round trip, unless the packet gets "lost", which
+// exercises the same scheduling, resend and timeout paths as real servers.
+
+static S32 sgFakeServerCount = 0;
+static U32 sgFakeServerRTT = 0;
+static F32 sgFakeServerLoss = 0.0f;
+static U32 sgBenchmarkStartTime = 0;
+static U32 sgBenchmarkPacketCount = 0;
+
+class FakeServerReplyEvent : public SimEvent
+{
+    U8 mRequestType;
+    NetAddress mAddress;
+    U32 mKey;
+    U8 mFlags;
+
+public:
+    FakeServerReplyEvent(U8 requestType, const NetAddress* addr, U32 key, U8 flags)
+    {
+        mRequestType = requestType;
+        mAddress = *addr;
+        mKey = key;
+        mFlags = flags;
+    }
+
+    void process(SimObject* object)
+    {
+        if (!sgFakeServerCount)
+            return;
+
+        U8 buffer[MaxPacketDataSize];
+        BitStream stream(buffer, sizeof(buffer));
+        char name[32];
+        dSprintf(name, sizeof(name), "Fake server %d.%d", mAddress.netNum[2], mAddress.netNum[3]);
+
+        if (mRequestType == NetInterface::GamePingRequest)
+        {
+            stream.writeString(versionString);
+            stream.write(GameConnection::CurrentProtocolVersion);
+            stream.write(GameConnection::MinRequiredProtocolVersion);
+            stream.write(getVersionNumber());
+            stream.writeString(name);
+            stream.setPosition(0);
+            handleGamePingResponse(&mAddress, &stream, mKey, mFlags);
+        }
+        else
+        {
+            stream.writeString("Fake");
+            stream.writeString("FakeMissionType");
+            stream.writeString("FakeMapName");
+            stream.write(U8(0));
+            stream.write(U8(Platform::getRandom() * 16));
+            stream.write(U8(16));
+            stream.write(U8(0));
+            stream.write(U16(470));
+            stream.writeString(name);
+            writeLongCString(&stream, "");
+            stream.setPosition(0);
+            handleGameInfoResponse(&mAddress, &stream, mKey, mFlags);
+        }
+    }
+};
+
+static bool routeFakeServerPacket(U8 pType, const NetAddress* addr, U32 key, U8 flags)
+{
+    if (!sgFakeServerCount || addr->type != NetAddress::IPAddress ||
+        addr->netNum[0] != 198 || (addr->netNum[1] & 0xFE) != 18)
+        return false;
+
+    sgBenchmarkPacketCount++;
+    if (Platform::getRandom() >= sgFakeServerLoss)
+    {
+        // Spread the replies over +-25% of the round trip time:
+        U32 delay = U32(sgFakeServerRTT * (0.75f + Platform::getRandom() * 0.5f));
+        Sim::postEvent(Sim::getRootGroup(), new FakeServerReplyEvent(pType, addr, key, flags), Sim::getCurrentTime() + delay);
+    }
+    return true;
+}
+
+static void finishServerQueryBenchmark()
+{
+    if (!sgFakeServerCount)
+        return;
+
+    U32 elapsed = Platform::getRealMilliseconds() - sgBenchmarkStartTime;
+    Con::printf("Server query benchmark: %d of %d servers listed in %d ms, %d packets sent.",
+        gServerList.size(), sgFakeServerCount, elapsed, sgBenchmarkPacketCount);
+    Con::setIntVariable("$ServerQueryBenchmark::Time", elapsed);
+    Con::setIntVariable("$ServerQueryBenchmark::Servers", gServerList.size());
+    sgFakeServerCount = 0;
+}
+
+ConsoleFunction(addFakeServers, void, 2, 2, "addFakeServers(count);"
+    "Adds fake entries to the server list for testing the server browser.")
+{
+    argc;
+    addFakeServers(getMax(dAtoi(argv[1]), 0));
+}
+
+ConsoleFunction(benchmarkServerQuery, void, 2, 4, "benchmarkServerQuery(count, [rttMs], [lossPercent]);"
+    "Runs a server query against count simulated servers and reports the time until the list is complete.")
+{
+    S32 count = mClamp(dAtoi(argv[1]), 1, 0x1FFFF);
+    sgFakeServerRTT = (argc > 2) ? getMax(dAtoi(argv[2]), 0) : 60;
+    sgFakeServerLoss = (argc > 3) ? mClampF(dAtof(argv[3]) * 0.01f, 0.0f, 1.0f) : 0.0f;
+
+    clearServerList();
+    sActiveFilter.type = ServerFilter::Offline;
+    sActiveFilter.queryFlags = ServerFilter::OfflineQuery;
+    sgServerQueryActive = true;
+
+    sgFakeServerCount = count;
+    sgBenchmarkPacketCount = 0;
+    sgBenchmarkStartTime = Platform::getRealMilliseconds();
+
+    NetAddress addr;
+    for (S32 i = 0; i < count; i++)
+    {
+        getFakeServerAddress(i, &addr);
+        pushPingRequest(&addr);
+    }
+
+    Con::printf("Server query benchmark: querying %d servers, %d ms round trip, %g%% loss...",
+        count, sgFakeServerRTT, sgFakeServerLoss * 100.0f);
+    processPingsAndQueries(gPingSession);
+}
+#endif // DEBUG
+
 //-----------------------------------------------------------------------------
 // Packet Dispatch
 
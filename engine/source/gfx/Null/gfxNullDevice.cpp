@@ -38,6 +38,8 @@ protected:
       { 
          GFXNullTextureObject* to = new GFXNullTextureObject(GFX, profile);
          to->mBitmap = new GBitmap(width, height);
+         to->mTextureSize.set( width, height, depth );
+         to->mFormat = format;
          return to;
       };
 
@@ -11,6 +11,7 @@
 #include "platform/platform.h"
 #include "math/mRect.h"
 #include "platform/profiler.h"
+#include "core/threadPool.h"
 
 #include "console/console.h"
 
@@ -119,6 +120,7 @@ void GBitmap::convertToBGRx(bool forceSwap)
         {
             U8* bits = (U8*)getBits(j);
 
+#ifdef _XBOX
             for (U32 i = 0; i < getWidth(j) * getHeight(j); i++)
             {
                 U8 red = bits[i * 4 + 0];
@@ -126,36 +128,20 @@ void GBitmap::convertToBGRx(bool forceSwap)
                 U8 blue = bits[i * 4 + 2];
                 U8 alpha = bits[i * 4 + 3];
 
-#ifdef _XBOX
                 bits[i * 4 + 0] = alpha;
                 bits[i * 4 + 1] = blue;
                 bits[i * 4 + 2] = green;
                 bits[i * 4 + 3] = red;
+            }
 #else
-                bits[i * 4 + 0] = blue;
-                bits[i * 4 + 1] = green;
-                bits[i * 4 + 2] = red;
-                bits[i * 4 + 3] = alpha;
+            bitmapSwizzleRGBA(bits, getWidth(j) * getHeight(j));
 #endif
-            }
         }
     }
     else if (internalFormat == GFXFormatR8G8B8)
     {
         for (U32 j = 0; j < numMipLevels; j++)
-        {
-            U8* bits = (U8*)getBits(j);
-            for (U32 i = 0; i < getWidth(j) * getHeight(j); i++)
-            {
-                U8 red = bits[i * 3 + 0];
-                U8 green = bits[i * 3 + 1];
-                U8 blue = bits[i * 3 + 2];
-
-                bits[i * 3 + 0] = blue;
-                bits[i * 3 + 1] = green;
-                bits[i * 3 + 2] = red;
-            }
-        }
+            bitmapSwizzleRGB((U8*)getBits(j), getWidth(j) * getHeight(j));
     }
 }
 
@@ -452,6 +438,59 @@ void (*bitmapExtrudeRGB)(const void* srcMip, void* mip, U32 srcHeight, U32 srcWi
 void (*bitmapExtrudeRGBA)(const void* srcMip, void* mip, U32 srcHeight, U32 srcWidth) = bitmapExtrudeRGBA_c;
 void (*bitmapExtrudePaletted)(const void* srcMip, void* mip, U32 srcHeight, U32 srcWidth) = bitmapExtrudePaletted_c;
 
+//--------------------------------------------------------------------------
+// Large mip levels are extruded in bands of rows on the thread pool.  Every
+// destination row only reads its own two source rows, so the bands are
+// independent and the result is the same as extruding the level in one go.
+
+static const U32 csParallelExtrudePixels = 512 * 512;
+static const U32 csExtrudeBandRows = 32;
+
+struct MipExtrudeJob
+{
+    void (*extrude)(const void* srcMip, void* mip, U32 srcHeight, U32 srcWidth);
+    const U8* src;
+    U8* dst;
+    U32 srcWidth;
+    U32 dstHeight;
+    U32 bytesPerPixel;
+};
+
+static void extrudeMipBand(U32 band, void* data)
+{
+    const MipExtrudeJob* job = static_cast<const MipExtrudeJob*>(data);
+
+    U32 firstRow = band * csExtrudeBandRows;
+    U32 rows = getMin(csExtrudeBandRows, job->dstHeight - firstRow);
+    U32 srcRowBytes = job->srcWidth * job->bytesPerPixel;
+    U32 dstRowBytes = (job->srcWidth >> 1) * job->bytesPerPixel;
+
+    job->extrude(job->src + firstRow * 2 * srcRowBytes, job->dst + firstRow * dstRowBytes, rows * 2, job->srcWidth);
+}
+
+static void extrudeMip(void (*extrude)(const void*, void*, U32, U32), const U8* src, U8* dst,
+    U32 srcHeight, U32 srcWidth, U32 bytesPerPixel)
+{
+    // Odd sizes don't split into rows of whole source pixel pairs.
+    if (ThreadPool::get() == NULL || srcWidth * srcHeight < csParallelExtrudePixels ||
+        (srcWidth & 1) || (srcHeight & 1))
+    {
+        extrude(src, dst, srcHeight, srcWidth);
+        return;
+    }
+
+    MipExtrudeJob job;
+    job.extrude = extrude;
+    job.src = src;
+    job.dst = dst;
+    job.srcWidth = srcWidth;
+    job.dstHeight = srcHeight >> 1;
+    job.bytesPerPixel = bytesPerPixel;
+
+    U32 bands = (job.dstHeight + csExtrudeBandRows - 1) / csExtrudeBandRows;
+    ThreadPool::get()->parallelFor(bands, extrudeMipBand, &job);
+}
+
 
 //--------------------------------------------------------------------------
 void GBitmap::extrudeMipLevels(bool clearBorders)
@@ -475,14 +514,14 @@ void GBitmap::extrudeMipLevels(bool clearBorders)
     case GFXFormatR8G8B8:
     {
         for (U32 i = 1; i < numMipLevels; i++)
-            bitmapExtrudeRGB(getBits(i - 1), getWritableBits(i), getHeight(i - 1), getWidth(i - 1));
+            extrudeMip(bitmapExtrudeRGB, getBits(i - 1), getWritableBits(i), getHeight(i - 1), getWidth(i - 1), 3);
         break;
     }
 
     case GFXFormatR8G8B8A8:
     {
         for (U32 i = 1; i < numMipLevels; i++)
-            bitmapExtrudeRGBA(getBits(i - 1), getWritableBits(i), getHeight(i - 1), getWidth(i - 1));
+            extrudeMip(bitmapExtrudeRGBA, getBits(i - 1), getWritableBits(i), getHeight(i - 1), getWidth(i - 1), 4);
         break;
     }
 
@@ -625,6 +664,31 @@ void bitmapConvertRGB_to_RGBX_c(U8** src, U32 pixels)
 
 void (*bitmapConvertRGB_to_RGBX)(U8** src, U32 pixels) = bitmapConvertRGB_to_RGBX_c;
 
+//------------------------------------------------------------------------------
+
+void bitmapSwizzleRGB_c(U8* bits, U32 pixels)
+{
+    for (U32 i = 0; i < pixels; i++)
+    {
+        U8 red = bits[i * 3 + 0];
+        bits[i * 3 + 0] = bits[i * 3 + 2];
+        bits[i * 3 + 2] = red;
+    }
+}
+
+void bitmapSwizzleRGBA_c(U8* bits, U32 pixels)
+{
+    for (U32 i = 0; i < pixels; i++)
+    {
+        U8 red = bits[i * 4 + 0];
+        bits[i * 4 + 0] = bits[i * 4 + 2];
+        bits[i * 4 + 2] = red;
+    }
+}
+
+void (*bitmapSwizzleRGB)(U8* bits, U32 pixels) = bitmapSwizzleRGB_c;
+void (*bitmapSwizzleRGBA)(U8* bits, U32 pixels) = bitmapSwizzleRGBA_c;
+
 //--------------------------------------------------------------------------
 bool GBitmap::setFormat(GFXFormat fmt)
 {
@@ -239,7 +239,16 @@ extern void (*bitmapConvertRGB_to_5551)(U8* src, U32 pixels);
 extern void (*bitmapConvertRGB_to_1555)(U8* src, U32 pixels);
 extern void (*bitmapConvertRGB_to_RGBX)(U8** src, U32 pixels);
 extern void (*bitmapExtrudePaletted)(const void* srcMip, void* mip, U32 height, U32 width);
+extern void (*bitmapExtrudeRGBA)(const void* srcMip, void* mip, U32 height, U32 width);
+
+/// Swap the red and blue channels in place.
+extern void (*bitmapSwizzleRGB)(U8* bits, U32 pixels);
+extern void (*bitmapSwizzleRGBA)(U8* bits, U32 pixels);
 
 void bitmapExtrudeRGB_c(const void* srcMip, void* mip, U32 height, U32 width);
+void bitmapExtrudeRGBA_c(const void* srcMip, void* mip, U32 height, U32 width);
+
+/// Installs the SSE2/SSSE3 bitmap routines the CPU supports.
+void bitmapInstall_SSE(U32 properties);
 
 #endif //_GBITMAP_H_
@@ -0,0 +1,252 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "gfx/gBitmap.h"
+
+// SSE2 and SSSE3 versions of the bitmap mip extrusion and pixel conversion
+// routines.  The box filters work on 16 bit sums with the same rounding as the
+// C versions, so the results are identical.  The SSSE3 functions are compiled
+// individually since the engine is not built with -mssse3, and are only
+// installed when the CPU has it.
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#  if defined(TORQUE_COMPILER_GCC)
+#     define ADD_SSE_FN
+#     define SSE2_FN __attribute__((target("sse2")))
+#     define SSSE3_FN __attribute__((target("ssse3")))
+#  elif defined(TORQUE_COMPILER_VISUALC) && (_MSC_VER >= 1500)
+#     define ADD_SSE_FN
+#     define SSE2_FN
+#     define SSSE3_FN
+#  endif
+#endif
+
+#if defined(ADD_SSE_FN)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+//--------------------------------------------------------------------------
+// Mip extrusion
+
+// Four destination pixels per iteration: the two source rows are summed
+// vertically as 16 bit values, then neighbouring pixels horizontally.
+SSE2_FN static void SSE2_ExtrudeRGBA(const void* srcMip, void* mip, U32 srcHeight, U32 srcWidth)
+{
+    if (srcWidth == 1)
+    {
+        bitmapExtrudeRGBA_c(srcMip, mip, srcHeight, srcWidth);
+        return;
+    }
+
+    const U8* src = (const U8*)srcMip;
+    U8* dst = (U8*)mip;
+    U32 stride = srcHeight != 1 ? (srcWidth) * 4 : 0;
+
+    U32 width = srcWidth >> 1;
+    U32 height = srcHeight >> 1;
+    if (height == 0) height = 1;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+
+    for (U32 y = 0; y < height; y++)
+    {
+        U32 x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)(src));
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(src + 16));
+            __m128i b0 = _mm_loadu_si128((const __m128i*)(src + stride));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(src + stride + 16));
+
+            __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+            __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+            __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+            __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+            __m128i h0 = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+            __m128i h1 = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+            h0 = _mm_srli_epi16(_mm_add_epi16(h0, two), 2);
+            h1 = _mm_srli_epi16(_mm_add_epi16(h1, two), 2);
+
+            _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(h0, h1));
+            src += 32;
+            dst += 16;
+        }
+
+        for (; x < width; x++)
+        {
+            for (U32 c = 0; c < 4; c++)
+                *dst++ = (U32(src[c]) + U32(src[c + 4]) + U32(src[stride + c]) + U32(src[stride + c + 4]) + 2) >> 2;
+            src += 8;
+        }
+        src += stride;   // skip
+    }
+}
+
+// The RGB pixels don't line up with the registers, so a row is done in chunks:
+// vertical sums and the horizontal pair sums are vectorized, then every other
+// pixel of the result is picked out.
+SSE2_FN static void SSE2_ExtrudeRGB(const void* srcMip, void* mip, U32 srcHeight, U32 srcWidth)
+{
+    if (srcWidth == 1)
+    {
+        bitmapExtrudeRGB_c(srcMip, mip, srcHeight, srcWidth);
+        return;
+    }
+
+    enum { ChunkPixels = 64, ChunkBytes = ChunkPixels * 6 };
+
+    const U8* src = (const U8*)srcMip;
+    U8* dst = (U8*)mip;
+    U32 stride = srcHeight != 1 ? (srcWidth) * 3 : 0;
+
+    U32 width = srcWidth >> 1;
+    U32 height = srcHeight >> 1;
+    if (height == 0) height = 1;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+
+    U16 sums[ChunkBytes + 8];
+    U16 filtered[ChunkBytes + 8];
+
+    for (U32 y = 0; y < height; y++)
+    {
+        for (U32 x = 0; x < width; x += ChunkPixels)
+        {
+            U32 pixels = getMin(width - x, U32(ChunkPixels));
+            U32 bytes = pixels * 6;
+
+            U32 i = 0;
+            for (; i + 16 <= bytes; i += 16)
+            {
+                __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(src + stride + i));
+                _mm_storeu_si128((__m128i*)(sums + i), _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+                _mm_storeu_si128((__m128i*)(sums + i + 8), _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+            }
+            for (; i < bytes; i++)
+                sums[i] = U16(src[i]) + U16(src[stride + i]);
+
+            U32 j = 0;
+            for (; j + 8 + 3 <= bytes; j += 8)
+            {
+                __m128i h = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(sums + j)),
+                                          _mm_loadu_si128((const __m128i*)(sums + j + 3)));
+                _mm_storeu_si128((__m128i*)(filtered + j), _mm_srli_epi16(_mm_add_epi16(h, two), 2));
+            }
+            for (; j + 3 < bytes; j++)
+                filtered[j] = (sums[j] + sums[j + 3] + 2) >> 2;
+
+            for (U32 p = 0; p < pixels; p++)
+            {
+                *dst++ = U8(filtered[p * 6 + 0]);
+                *dst++ = U8(filtered[p * 6 + 1]);
+                *dst++ = U8(filtered[p * 6 + 2]);
+            }
+            src += bytes;
+        }
+        src += stride;   // skip
+    }
+}
+
+//--------------------------------------------------------------------------
+// Channel swizzles
+
+SSE2_FN static void SSE2_SwizzleRGBA(U8* bits, U32 pixels)
+{
+    const __m128i greenAlpha = _mm_set1_epi32(0xFF00FF00);
+    const __m128i lowByte = _mm_set1_epi32(0xFF);
+
+    U32 i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(bits + i * 4));
+        __m128i r = _mm_or_si128(_mm_and_si128(v, greenAlpha),
+                                 _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 16), lowByte),
+                                              _mm_slli_epi32(_mm_and_si128(v, lowByte), 16)));
+        _mm_storeu_si128((__m128i*)(bits + i * 4), r);
+    }
+
+    for (; i < pixels; i++)
+    {
+        U8 red = bits[i * 4 + 0];
+        bits[i * 4 + 0] = bits[i * 4 + 2];
+        bits[i * 4 + 2] = red;
+    }
+}
+
+// Five pixels per 16 byte load, the last byte belongs to the next pixel and
+// is written back unchanged.
+SSSE3_FN static void SSSE3_SwizzleRGB(U8* bits, U32 pixels)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+
+    U32 i = 0;
+    for (; i * 3 + 16 <= pixels * 3; i += 5)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(bits + i * 3));
+        _mm_storeu_si128((__m128i*)(bits + i * 3), _mm_shuffle_epi8(v, shuffle));
+    }
+
+    for (; i < pixels; i++)
+    {
+        U8 red = bits[i * 3 + 0];
+        bits[i * 3 + 0] = bits[i * 3 + 2];
+        bits[i * 3 + 2] = red;
+    }
+}
+
+//--------------------------------------------------------------------------
+// Format conversion
+
+SSSE3_FN static void SSSE3_ConvertRGB_to_RGBX(U8** src, U32 pixels)
+{
+    const U8* oldBits = *src;
+    U8* newBits = new U8[pixels * 4];
+
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+    U32 i = 0;
+    for (; i * 3 + 16 <= pixels * 3; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(oldBits + i * 3));
+        _mm_storeu_si128((__m128i*)(newBits + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+    }
+
+    for (; i < pixels; i++)
+    {
+        dMemcpy(&newBits[i * 4], &oldBits[i * 3], sizeof(U8) * 3);
+        newBits[i * 4 + 3] = 0xFF;
+    }
+
+    delete[] * src;
+    *src = newBits;
+}
+
+#endif // ADD_SSE_FN
+
+//--------------------------------------------------------------------------
+
+void bitmapInstall_SSE(U32 properties)
+{
+#if defined(ADD_SSE_FN)
+    if (properties & CPU_PROP_SSE2)
+    {
+        bitmapExtrudeRGBA = SSE2_ExtrudeRGBA;
+        bitmapExtrudeRGB = SSE2_ExtrudeRGB;
+        bitmapSwizzleRGBA = SSE2_SwizzleRGBA;
+    }
+
+    if (properties & CPU_PROP_SSSE3)
+    {
+        bitmapSwizzleRGB = SSSE3_SwizzleRGB;
+        bitmapConvertRGB_to_RGBX = SSSE3_ConvertRGB_to_RGBX;
+    }
+#endif
+}
@@ -27,6 +27,10 @@ S32 gTextureQualityMode = 0;
 // 0 == none, 1 == 1/(4^1), 2 == 1/(4^2), 3 = 1/(4^3)
 S32 gTextureReductionLevel = 1;
 
+/// Memory, in bytes, all textures may hold before unreferenced ones are
+/// evicted from the cache.  0 frees textures as soon as they are released.
+S32 gTextureResidencyBudget = 134217728;  // 128 MB
+
 //-----------------------------------------------------------------------------
 
 void GFXTextureManager::init()
@@ -34,6 +38,7 @@ void GFXTextureManager::init()
     Con::addVariable("pref::TextureManager::scaleThreshold", TypeS32, &gTextureScaleThreshold);
     Con::addVariable("pref::TextureManager::qualityMode", TypeS32, &gTextureQualityMode);
     Con::addVariable("pref::TextureManager::reductionLevel", TypeS32, &gTextureReductionLevel);
+    Con::addVariable("pref::TextureManager::residencyBudget", TypeS32, &gTextureResidencyBudget);
 }
 
 GFXTextureManager::GFXTextureManager()
@@ -49,12 +54,19 @@ GFXTextureManager::GFXTextureManager()
 
     mValidTextureQualityInfo = false;
     mHandleCount = 0;
+
+    mCacheHead = mCacheTail = NULL;
+    dMemset(&mResidencyStats, 0, sizeof(mResidencyStats));
 }
 
 //-----------------------------------------------------------------------------
 
 GFXTextureManager::~GFXTextureManager()
 {
+    // Nobody else holds the cached textures.
+    if (mTextureManagerState != GFXTextureManager::Dead)
+        flushTextureCache();
+
     delete[] mHashTable;
 }
 
@@ -149,6 +161,9 @@ void GFXTextureManager::kill()
 {
     AssertFatal(mTextureManagerState != GFXTextureManager::Dead, "Don't beat a dead texture manager!");
 
+    // The cached textures are unreferenced, delete them outright.
+    flushTextureCache();
+
     GFXTextureObject* curr = mListHead;
     GFXTextureObject* temp;
 
@@ -168,6 +183,9 @@ void GFXTextureManager::zombify()
 {
     AssertFatal(mTextureManagerState != GFXTextureManager::Zombie, "Texture Manager already a zombie! Get the holy water!");
 
+    // No point bringing unreferenced textures back with the device.
+    flushTextureCache();
+
     GFXTextureObject* temp = mListHead;
 
     // Free all the device copies of the textures.
@@ -224,12 +242,16 @@ GFXTextureObject* GFXTextureManager::createTexture(GBitmap* bmp, GFXTextureProfi
     if (cacheHit = hashFind(fileName))
     {
         // Con::errorf("Cached texture '%s'", (fileName ? fileName : "unknown"));
+        touchTexture(cacheHit);
         if (deleteBmp)
             delete bmp;
         PROFILE_END();
         return cacheHit;
     }
 
+    if (fileName)
+        mResidencyStats.misses++;
+
     // Massage the bitmap based on any resize rules.
     U32 scalePower = getBitmapScalePower(profile);
 
@@ -420,6 +442,7 @@ GFXTextureObject* GFXTextureManager::createTexture(const char* filename, GFXText
         GFXTextureObject* cacheHit = hashFind(fileName);
         if (cacheHit)
         {
+            touchTexture(cacheHit);
             PROFILE_END();
             return cacheHit;
         }
@@ -565,6 +588,117 @@ GFXTextureObject* GFXTextureManager::hashFind(StringTableEntry name)
 }
 
 
+//-----------------------------------------------------------------------------
+
+/// Rough size of a texture with all its mips, in bytes.
+static U32 getTextureBytes(U32 width, U32 height, U32 depth, U32 numMips, GFXFormat format)
+{
+    U32 bits;
+    if (format >= GFXFormat_UNKNOWNSIZE)
+        bits = (format == GFXFormatDXT1) ? 4 : 8;
+    else if (format >= GFXFormat_128BIT)
+        bits = 128;
+    else if (format >= GFXFormat_64BIT)
+        bits = 64;
+    else if (format >= GFXFormat_32BIT)
+        bits = 32;
+    else if (format >= GFXFormat_24BIT)
+        bits = 24;
+    else if (format >= GFXFormat_16BIT)
+        bits = 16;
+    else
+        bits = 8;
+
+    U32 bytes = 0;
+    for (U32 i = 0; i < getMax(numMips, U32(1)); i++)
+    {
+        bytes += (width * height * getMax(depth, U32(1)) * bits + 7) / 8;
+
+        width = getMax(width >> 1, U32(1));
+        height = getMax(height >> 1, U32(1));
+        depth >>= 1;
+    }
+
+    return bytes;
+}
+
+void GFXTextureManager::cacheUnlink(GFXTextureObject* object)
+{
+    AssertFatal(object->mCached, "GFXTextureManager::cacheUnlink - texture is not cached.");
+
+    if (object->mCachePrev)
+        object->mCachePrev->mCacheNext = object->mCacheNext;
+    else
+        mCacheHead = object->mCacheNext;
+
+    if (object->mCacheNext)
+        object->mCacheNext->mCachePrev = object->mCachePrev;
+    else
+        mCacheTail = object->mCachePrev;
+
+    object->mCacheNext = object->mCachePrev = NULL;
+    object->mCached = false;
+
+    mResidencyStats.cachedBytes -= object->mResidentBytes;
+    mResidencyStats.cachedTextures--;
+}
+
+void GFXTextureManager::touchTexture(GFXTextureObject* object)
+{
+    mResidencyStats.hits++;
+
+    // It's about to get a handle again.
+    if (object->mCached)
+        cacheUnlink(object);
+}
+
+bool GFXTextureManager::cacheTexture(GFXTextureObject* texture)
+{
+    // Only named textures can be asked for again.
+    if (mTextureManagerState != GFXTextureManager::Living || !texture->mTextureFileName)
+        return false;
+
+    if (gTextureResidencyBudget <= 0 || texture->mResidentBytes > U32(gTextureResidencyBudget))
+        return false;
+
+    AssertFatal(!texture->mCached, "GFXTextureManager::cacheTexture - texture is already cached.");
+
+    texture->mCached = true;
+    texture->mCachePrev = NULL;
+    texture->mCacheNext = mCacheHead;
+    if (mCacheHead)
+        mCacheHead->mCachePrev = texture;
+    else
+        mCacheTail = texture;
+    mCacheHead = texture;
+
+    mResidencyStats.cachedBytes += texture->mResidentBytes;
+    mResidencyStats.cachedTextures++;
+
+    // This may evict the texture again if the referenced ones fill the budget.
+    evictTextures(gTextureResidencyBudget);
+    return true;
+}
+
+void GFXTextureManager::evictTextures(U32 budget)
+{
+    PROFILE_START(GFXTextureManager_evictTextures);
+
+    while (mCacheTail && (!budget || mResidencyStats.residentBytes > budget))
+    {
+        GFXTextureObject* texture = mCacheTail;
+        cacheUnlink(texture);
+
+        if (budget)
+            mResidencyStats.evictions++;
+
+        // Nobody has a handle to it, so this is its last reference.
+        delete texture;
+    }
+
+    PROFILE_END();
+}
+
 //-----------------------------------------------------------------------------
 // Register texture event callback
 //-----------------------------------------------------------------------------
@@ -662,6 +796,19 @@ void GFXTextureManager::linkTexture(GFXTextureObject* obj)
     obj->mPrev = mListTail;
     mListTail = obj;
 
+    //    - info for the residency budget...
+    U32 width = obj->mTextureSize.x ? obj->mTextureSize.x : obj->mBitmapSize.x;
+    U32 height = obj->mTextureSize.y ? obj->mTextureSize.y : obj->mBitmapSize.y;
+    U32 depth = obj->mTextureSize.x ? obj->mTextureSize.z : obj->mBitmapSize.z;
+
+    obj->mResidentBytes = getTextureBytes(width, height, depth, obj->mMipLevels, obj->mFormat);
+    if (obj->mBitmap)
+        obj->mResidentBytes += obj->mBitmap->byteSize;
+
+    mResidencyStats.residentBytes += obj->mResidentBytes;
+    if (gTextureResidencyBudget > 0)
+        evictTextures(gTextureResidencyBudget);
+
     PROFILE_END();
 }
 
@@ -743,6 +890,29 @@ ConsoleFunction(reloadTextures, void, 1, 1, "")
     }
 }
 
+ConsoleFunction(getTextureCacheStats, const char*, 1, 1, "getTextureCacheStats();"
+    "Returns \"hits misses evictions residentBytes cachedBytes cachedTextures\" for the texture "
+    "manager.  Hits and misses count named texture loads, cached textures are unreferenced ones "
+    "kept within $pref::TextureManager::residencyBudget bytes.")
+{
+    if (!GFX || !GFX->getTextureManager())
+        return "0 0 0 0 0 0";
+
+    const GFXTextureManager::ResidencyStats& stats = GFX->getTextureManager()->getResidencyStats();
+
+    char* ret = Con::getReturnBuffer(128);
+    dSprintf(ret, 128, "%d %d %d %d %d %d", stats.hits, stats.misses, stats.evictions,
+        stats.residentBytes, stats.cachedBytes, stats.cachedTextures);
+    return ret;
+}
+
+ConsoleFunction(flushTextureCache, void, 1, 1, "flushTextureCache();"
+    "Frees every texture the texture manager is keeping around without a reference.")
+{
+    if (GFX && GFX->getTextureManager())
+        GFX->getTextureManager()->flushTextureCache();
+}
+
 ConsoleFunction(preloadTexture, void, 2, 2, "preloadTexture(filename)")
 {
     static Vector<GFXTexHandle*> sPreloadGuiTextureVector;
@@ -15,6 +15,18 @@ typedef void (*GFXTexEventCallback)(GFXTexCallbackCode code, void* userData);
 
 class GFXTextureManager
 {
+public:
+    /// Texture cache stats.  Hits, misses and evictions count since startup.
+    struct ResidencyStats
+    {
+        U32 hits;           ///< Named textures found in the cache.
+        U32 misses;         ///< Named textures that had to be loaded.
+        U32 evictions;      ///< Unreferenced textures freed to stay within budget.
+        U32 residentBytes;  ///< Estimated memory held by all textures and their bitmaps.
+        U32 cachedBytes;    ///< Part of that held by unreferenced textures.
+        U32 cachedTextures; ///< Unreferenced textures kept around.
+    };
+
 private:
     U32 mHandleCount;
 
@@ -44,6 +56,33 @@ protected:
     void              hashInsert(GFXTextureObject* object);
     void              hashRemove(GFXTextureObject* object);
 
+    /// @name Residency
+    ///
+    /// Named textures that lose their last handle are not freed right away.
+    /// They stay in the hash, and on a least recently released list, so the
+    /// next level that uses them gets them back without loading the bitmap
+    /// again.  Whenever the memory held by all textures goes over
+    /// $pref::TextureManager::residencyBudget the oldest of them are freed.
+    /// Textures that are still referenced are never evicted.
+    ///
+    /// @{
+
+    ResidencyStats mResidencyStats;
+
+    GFXTextureObject* mCacheHead;   ///< Most recently released unreferenced texture.
+    GFXTextureObject* mCacheTail;   ///< Next one to evict.
+
+    void cacheUnlink(GFXTextureObject* object);
+
+    /// Hands a cached texture out again.
+    void touchTexture(GFXTextureObject* object);
+
+    /// Evicts unreferenced textures, oldest first, until the resident memory
+    /// is within @a budget bytes.  A budget of 0 evicts them all.
+    void evictTextures(U32 budget);
+
+    /// @}
+
     enum TextureManagerState
     {
         Living,
@@ -187,6 +226,15 @@ public:
         U32 numMipLevels = 0);
 
     void deleteTexture(GFXTextureObject* texture);
+
+    /// Called when the last handle to a texture goes away.  Returns true if
+    /// the texture was kept in the cache, false if the caller should delete it.
+    bool cacheTexture(GFXTextureObject* texture);
+
+    /// Frees every unreferenced texture held by the cache.
+    void flushTextureCache() { evictTextures(0); }
+
+    const ResidencyStats& getResidencyStats() const { return mResidencyStats; }
     void reloadTexture(GFXTextureObject* texture);
     void reloadTextureResource(const char* filename);
 
@@ -224,6 +272,10 @@ inline void GFXTextureManager::deleteTexture(GFXTextureObject* texture)
     if (mListTail == texture)
         mListTail = texture->mPrev;
 
+    if (texture->mCached)
+        cacheUnlink(texture);
+    mResidencyStats.residentBytes -= texture->mResidentBytes;
+
     hashRemove(texture);
 
     GFXTextureProfile::updateStatsForDeletion(texture);
@@ -40,6 +40,10 @@ GFXTextureObject::GFXTextureObject(GFXDevice* aDevice, GFXTextureProfile* aProfi
 {
     mHashNext = mNext = mPrev = NULL;
 
+    mCached = false;
+    mCacheNext = mCachePrev = NULL;
+    mResidentBytes = 0;
+
     mDevice = aDevice;
     mProfile = aProfile;
 
@@ -49,6 +53,7 @@ GFXTextureObject::GFXTextureObject(GFXDevice* aDevice, GFXTextureProfile* aProfi
     mMipLevels = 1;
 
     mTextureSize.set(0, 0, 0);
+    mFormat = GFXFormatR8G8B8A8;
 
     mDead = false;
 
@@ -133,6 +138,18 @@ void GFXTextureObject::kill()
     mDead = true;
 }
 
+//-----------------------------------------------------------------------------
+// destroySelf - the last handle went away.  Named textures may be kept by the
+// texture manager until they are used again or evicted.
+//-----------------------------------------------------------------------------
+void GFXTextureObject::destroySelf()
+{
+    if (!mDead && mDevice && mDevice->mTextureManager && mDevice->mTextureManager->cacheTexture(this))
+        return;
+
+    delete this;
+}
+
 void GFXTextureObject::describeSelf( char* buffer, U32 sizeOfBuffer )
 {
     dSprintf(buffer, sizeOfBuffer, " (width: %4d, height: %4d)  profile: %s   creation path: %s", getWidth(),
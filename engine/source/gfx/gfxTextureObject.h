@@ -68,6 +68,12 @@ public:
     GFXTextureObject* mPrev;     ///< Previous texture in the linked list
     GFXTextureObject* mHashNext; ///< Used for hash table lookups.
 
+    // Residency management
+    bool mCached;                   ///< Unreferenced, kept by the texture manager for reuse.
+    GFXTextureObject* mCacheNext;   ///< Next (less recently released) cached texture.
+    GFXTextureObject* mCachePrev;   ///< Previous (more recently released) cached texture.
+    U32 mResidentBytes;             ///< Estimated memory held by the texture and its bitmaps.
+
     StringTableEntry mTextureFileName;
 
     Point3I  mBitmapSize;
@@ -121,6 +127,10 @@ public:
 
     virtual void kill();
 
+    /// Called when the last handle goes away.  Gives the texture manager a
+    /// chance to keep the texture cached instead of deleting it.
+    virtual void destroySelf();
+
     // GFXResource interface
     virtual void describeSelf(char* buffer, U32 sizeOfBuffer);
 };
@@ -16,6 +16,7 @@
 #include "gfx/screenshot.h"
 #include "sim/sceneObject.h"
 #include "gfx/gammaBuffer.h"
+#include "core/frameArena.h"
 
 bool gEnableDatablockCanvasRepaint = false;
 
@@ -1522,6 +1523,9 @@ void GuiCanvas::renderFrame(bool preRenderOnly)
 
     swapBuffers();
 
+    // Everything the scene and render instance manager built this frame is done with.
+    FrameArena::endFrame();
+
 #ifdef TORQUE_GFX_STATE_DEBUG
     GFX->getDebugStateManager()->endFrame();
 #endif
@@ -1294,32 +1294,51 @@ Box3F InteriorConvex::getBoundingBox(const MatrixF& mat, const Point3F& scale) c
     return newBox;
 }
 
-Point3F InteriorConvex::support(const VectorF& v) const
+/// Returns the hull point furthest along @a v.  The dot products are done a
+/// batch at a time on the stack, rather than in the FrameAllocator, so the
+/// support can be evaluated from the thread pool.
+static const Point3F& findHullSupport(const VectorF& v, const ItrPaddedPoint* points,
+    const U32* indices, const U32 count)
 {
-    FrameAllocatorMarker fam;
+    enum { BatchSize = 64 };
+    F32 dots[BatchSize];
 
-    if (hullId >= 0)
+    U32 index = 0;
+    F32 maxDot = 0.0f;
+    for (U32 start = 0; start < count; start += BatchSize)
     {
-        AssertFatal(hullId < pInterior->mConvexHulls.size(), "Out of bounds hull!");
+        U32 batch = getMin(count - start, U32(BatchSize));
+        m_point3F_bulk_dot_indexed(&v.x, &points[0].point.x, batch, sizeof(ItrPaddedPoint),
+            &indices[start], dots);
 
-        const Interior::ConvexHull& rHull = pInterior->mConvexHulls[hullId];
-
-        F32* pDots = (F32*)fam.alloc(sizeof(F32) * rHull.hullCount);
-        m_point3F_bulk_dot_indexed(&v.x,
-            &pInterior->mPoints[0].point.x,
-            rHull.hullCount,
-            sizeof(ItrPaddedPoint),
-            &pInterior->mHullIndices[rHull.hullStart],
-            pDots);
-
-        U32 index = 0;
-        for (U32 i = 1; i < rHull.hullCount; i++)
+        U32 i = 0;
+        if (start == 0)
+        {
+            maxDot = dots[0];
+            i = 1;
+        }
+        for (; i < batch; i++)
         {
-            if (pDots[i] > pDots[index])
-                index = i;
+            if (dots[i] > maxDot)
+            {
+                maxDot = dots[i];
+                index = start + i;
+            }
         }
+    }
 
-        return pInterior->mPoints[pInterior->mHullIndices[rHull.hullStart + index]].point;
+    return points[indices[index]].point;
+}
+
+Point3F InteriorConvex::support(const VectorF& v) const
+{
+    if (hullId >= 0)
+    {
+        AssertFatal(hullId < pInterior->mConvexHulls.size(), "Out of bounds hull!");
+
+        const Interior::ConvexHull& rHull = pInterior->mConvexHulls[hullId];
+        return findHullSupport(v, pInterior->mPoints.address(),
+            &pInterior->mHullIndices[rHull.hullStart], rHull.hullCount);
     }
     else
     {
@@ -1327,23 +1346,8 @@ Point3F InteriorConvex::support(const VectorF& v) const
         AssertFatal(actualId < pInterior->mVehicleConvexHulls.size(), "Out of bounds hull!");
 
         const Interior::ConvexHull& rHull = pInterior->mVehicleConvexHulls[actualId];
-
-        F32* pDots = (F32*)fam.alloc(sizeof(F32) * rHull.hullCount);
-        m_point3F_bulk_dot_indexed(&v.x,
-            &pInterior->mVehiclePoints[0].point.x,
-            rHull.hullCount,
-            sizeof(ItrPaddedPoint),
-            &pInterior->mVehicleHullIndices[rHull.hullStart],
-            pDots);
-
-        U32 index = 0;
-        for (U32 i = 1; i < rHull.hullCount; i++)
-        {
-            if (pDots[i] > pDots[index])
-                index = i;
-        }
-
-        return pInterior->mVehiclePoints[pInterior->mVehicleHullIndices[rHull.hullStart + index]].point;
+        return findHullSupport(v, pInterior->mVehiclePoints.address(),
+            &pInterior->mVehicleHullIndices[rHull.hullStart], rHull.hullCount);
     }
 }
 
@@ -1380,8 +1384,7 @@ void InteriorConvex::getFeatures(const MatrixF& mat, const VectorF& n, ConvexFea
         U32 currPos = 0;
         const U8* pString = &pInterior->mConvexHullEmitStrings[pInterior->mHullEmitStringIndices[rHull.hullStart + spIndex]];
 
-        FrameAllocatorMarker fam;
-        U32* pRemaps = (U32*)fam.alloc(256 * sizeof(U32));
+        U32 pRemaps[256];
 
         // Ok, this is a piece of cake.  Lets dump the points first...
         U32 numPoints = pString[currPos++];
@@ -1468,8 +1471,7 @@ void InteriorConvex::getFeatures(const MatrixF& mat, const VectorF& n, ConvexFea
             pInterior->mVehicleHullEmitStringIndices[rHull.hullStart + spIndex]
         ];
 
-        FrameAllocatorMarker fam;
-        U32* pRemaps = (U32*)fam.alloc(256 * sizeof(U32));
+        U32 pRemaps[256];
 
         // Ok, this is a piece of cake.  Lets dump the points first...
         U32 numPoints = pString[currPos++];
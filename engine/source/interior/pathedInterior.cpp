@@ -368,6 +368,8 @@ void PathedInterior::resolvePathKey()
     if (mPathKey == Path::NoPathIndex)
     {
         mPathKey = getPathKey();
+        if (getPathManager()->isValidPath(mPathKey))
+            getPathManager()->buildPathCache(mPathKey);
         Point3F pathPos(0.0, 0.0, 0.0);
         Point3F initialPos = mBaseTransform.getPosition();
         getPathManager()->getPathPosition(mPathKey, 0, pathPos);
@@ -20,6 +20,7 @@
 #include "game/tsStatic.h"
 #include "collision/concretePolyList.h"
 #include "lightingSystem/sgSceneLighting.h"
+#include "lightingSystem/sgLightingModel.h"
 
 
 namespace
@@ -76,6 +77,10 @@ void SceneLighting::sgLightingStartEvent()
             continue;
         }
 
+        // restored from the cache, keep its light maps...
+        if ((*proxyItr)->mCached)
+            continue;
+
         InteriorInstance* interior = dynamic_cast<InteriorInstance*>((*proxyItr)->getObject());
         if (!interior)
             continue;
@@ -212,7 +217,7 @@ void SceneLighting::sgTGELightProcessEvent(U32 light, S32 object)
     //process object and light
     S32 time = Platform::getRealMilliseconds();
 #ifdef TORQUE_TERRAIN
-    if (dynamic_cast<TerrainProxy*>(mLitObjects[object]))
+    if (dynamic_cast<TerrainProxy*>(mLitObjects[object]) && !mLitObjects[object]->mCached)
         mLitObjects[object]->light(mLights[light]);
 #endif
 
@@ -281,6 +286,7 @@ void SceneLighting::sgSGPassSetupEvent()
     Con::printf("  Starting Synapse Gaming Lighting Pack scene lighting...");
 
     mLitObjects.clear();
+    U32 relitCount = 0;
     for (ObjectProxy** proxyItr = mSceneObjects.begin(); proxyItr != mSceneObjects.end(); proxyItr++)
     {
         // is there an object?
@@ -291,14 +297,17 @@ void SceneLighting::sgSGPassSetupEvent()
             continue;
         }
 
-        // add all lights
+        // add all objects, cached ones are not relit but still
+        // cast shadows onto the ones that are...
         mLitObjects.push_back(*proxyItr);
+        if (!(*proxyItr)->mCached)
+            relitCount++;
     }
 
 
     // stats...
     sgStatistics::sgClear();
-    sgStatistics::sgInteriorObjectCount += mLitObjects.size();
+    sgStatistics::sgInteriorObjectCount += relitCount;
 
 
     Canvas->paint();
@@ -310,6 +319,10 @@ void SceneLighting::sgSGPassSetupEvent()
 */
 void SceneLighting::sgSGObjectStartEvent(S32 object)
 {
+    // restored from the cache, their light maps are already done...
+    while ((object < mLitObjects.size()) && mLitObjects[object]->mCached)
+        object++;
+
     // catch bad light index and jump to complete event
     if (object >= mLitObjects.size())
     {
@@ -618,7 +631,7 @@ bool SceneLighting::light(BitSet32 flags)
     }
 
     // check for some persisted data, check if being forced..
-    if (!flags.test(ForceAlways | ForceWritable))
+    if (!flags.test(ForceAlways | ForceWritable | ForceStale))
     {
         if (loadPersistInfo(mFileName))
         {
@@ -640,7 +653,7 @@ bool SceneLighting::light(BitSet32 flags)
     }
 
     // don't light if file is read-only?
-    if (!flags.test(ForceAlways))
+    if (!flags.test(ForceAlways | ForceStale))
     {
         Stream* fileStream;
         if (!ResourceManager->openFileForWrite(fileStream, mFileName))
@@ -651,6 +664,22 @@ bool SceneLighting::light(BitSet32 flags)
         delete fileStream;
     }
 
+    // pick up the objects that have not changed since the last lighting...
+    if (!flags.test(ForceAlways) && Con::getBoolVariable("$pref::sceneLighting::incrementalCache", true))
+    {
+        U32 reused = loadIncrementalPersistInfo(misName);
+        if (reused)
+            Con::printf(" Reused cached lighting for %d of %d objects", reused, mSceneObjects.size());
+
+        if (reused == mSceneObjects.size())
+        {
+            // nothing is stale, just store it under the new mission crc...
+            if (Con::getBoolVariable("$pref::sceneLighting::cacheLighting", true) && !savePersistInfo(mFileName))
+                Con::errorf(ConsoleLogEntry::General, "SceneLighting::light: unable to persist lighting!");
+            return(false);
+        }
+    }
+
     // initialize the objects for lighting
     for (ObjectProxy** proxyItr = mSceneObjects.begin(); proxyItr != mSceneObjects.end(); proxyItr++)
         (*proxyItr)->init();
@@ -931,6 +960,101 @@ bool SceneLighting::savePersistInfo(const char* fileName)
     return(true);
 }
 
+/// Restores the lighting of every object that has a matching chunk in the
+/// most recent lighting file of this mission, regardless of the mission CRC.
+/// Returns the number of objects restored, these are flagged as cached and
+/// skipped by the lighting passes.
+U32 SceneLighting::loadIncrementalPersistInfo(const char* misName)
+{
+    // files are named '<mission>_<crc>.ml' or '<mission>_<crc>-raw.ml'...
+    char prefix[256];
+    dSprintf(prefix, sizeof(prefix), "%s_", misName);
+    U32 prefixLen = dStrlen(prefix);
+    const char* suffix = LightManager::sgAllowFullLightMaps() ? ".ml" : "-raw.ml";
+    U32 suffixLen = dStrlen(suffix);
+
+    // find the newest one...
+    const char* name;
+    ResourceObject* match = ResourceManager->findMatch("*.ml", &name, 0);
+    StringTableEntry newest = NULL;
+    FileTime newestTime;
+    while (match)
+    {
+        char fileName[1024];
+        dSprintf(fileName, sizeof(fileName), "%s/%s", match->path, match->name);
+        U32 len = dStrlen(fileName);
+
+        if ((match->flags & ResourceObject::File) && (len > prefixLen + suffixLen) &&
+            !dStrnicmp(fileName, prefix, prefixLen) && !dStricmp(fileName + len - suffixLen, suffix) &&
+            (LightManager::sgAllowFullLightMaps() == !dStrstr((const char*)fileName, "-raw.ml")))
+        {
+            FileTime create, modify;
+            if (Platform::getFileTimes(fileName, &create, &modify) &&
+                (!newest || Platform::compareFileTimes(modify, newestTime) > 0))
+            {
+                newest = StringTable->insert(fileName);
+                newestTime = modify;
+            }
+        }
+
+        match = ResourceManager->findMatch("*.ml", &name, match);
+    }
+
+    if (!newest)
+        return 0;
+
+    Stream* stream = ResourceManager->openStream(newest);
+    if (!stream)
+        return 0;
+
+    PersistInfo persistInfo;
+    bool success = persistInfo.read(*stream);
+    ResourceManager->closeStream(stream);
+    if (!success)
+        return 0;
+
+    // the mission chunk is skipped, it changes with any edit to the mission...
+    Vector<bool> used;
+    used.setSize(persistInfo.mChunks.size());
+    for (U32 i = 0; i < used.size(); i++)
+        used[i] = false;
+
+    U32 reused = 0;
+    for (U32 i = 0; i < mSceneObjects.size(); i++)
+    {
+        ObjectProxy* proxy = mSceneObjects[i];
+
+        U32 type;
+        if (isInterior(proxy->mObj))
+            type = PersistInfo::PersistChunk::InteriorChunkType;
+#ifdef TORQUE_TERRAIN
+        else if (isTerrain(proxy->mObj))
+            type = PersistInfo::PersistChunk::TerrainChunkType;
+        else if (dynamic_cast<AtlasLightMapProxy*>(proxy))
+            type = PersistInfo::PersistChunk::AtlasLightMapChunkType;
+#endif
+        else
+            continue;
+
+        for (U32 j = 1; j < persistInfo.mChunks.size(); j++)
+        {
+            PersistInfo::PersistChunk* chunk = persistInfo.mChunks[j];
+            if (used[j] || (chunk->mChunkType != type) || !proxy->isValidChunk(chunk))
+                continue;
+
+            if (proxy->setPersistInfo(chunk))
+            {
+                used[j] = true;
+                proxy->mCached = true;
+                reused++;
+            }
+            break;
+        }
+    }
+
+    return reused;
+}
+
 struct CacheEntry {
     ResourceObject* mFileObject;
     const char* mFileName;
@@ -1142,12 +1266,168 @@ U32 SceneLighting::calcMissionCRC()
     return(calculateCRC(crc.address(), sizeof(U32) * crc.size(), 0xffffffff));
 }
 
+/// CRC of everything in a light that changes the light maps it produces.
+static U32 sgCalcLightCRC(const LightInfo* light)
+{
+    U32 crc = calculateCRC(&light->mType, sizeof(light->mType), 0xffffffff);
+    crc = calculateCRC(&light->mPos, sizeof(light->mPos), crc);
+    crc = calculateCRC(&light->mDirection, sizeof(light->mDirection), crc);
+    crc = calculateCRC(&light->mColor, sizeof(light->mColor), crc);
+    crc = calculateCRC(&light->mAmbient, sizeof(light->mAmbient), crc);
+    crc = calculateCRC(&light->mRadius, sizeof(light->mRadius), crc);
+    crc = calculateCRC(&light->sgSpotAngle, sizeof(light->sgSpotAngle), crc);
+    crc = calculateCRC(&light->sgLocalAmbientAmount, sizeof(light->sgLocalAmbientAmount), crc);
+    crc = calculateCRC(light->sgZone, sizeof(light->sgZone), crc);
+
+    U8 flags[6];
+    flags[0] = light->sgCastsShadows;
+    flags[1] = light->sgDiffuseRestrictZone;
+    flags[2] = light->sgAmbientRestrictZone;
+    flags[3] = light->sgSmoothSpotLight;
+    flags[4] = light->sgDoubleSidedAmbient;
+    flags[5] = light->sgUseNormals;
+    crc = calculateCRC(flags, sizeof(flags), crc);
+
+    if (light->sgLightingModelName)
+        crc = calculateCRC(light->sgLightingModelName, dStrlen(light->sgLightingModelName), crc);
+    return crc;
+}
+
+/// CRC of everything in a shadow caster that changes the shadows it casts.
+static U32 sgCalcCasterCRC(SceneObject* caster)
+{
+    U32 crc = 0xffffffff;
+    if (InteriorInstance* interior = dynamic_cast<InteriorInstance*>(caster))
+        crc = interior->getCRC();
+#ifdef TORQUE_TERRAIN
+    else if (TerrainBlock* terrain = dynamic_cast<TerrainBlock*>(caster))
+        crc = terrain->getCRC();
+#endif
+    else if (TSStatic* shape = dynamic_cast<TSStatic*>(caster))
+    {
+        StringTableEntry shapeName = shape->getShapeFileName();
+        if (shapeName)
+            crc = calculateCRC(shapeName, dStrlen(shapeName), crc);
+    }
+    else if (ShapeBase* shape = dynamic_cast<ShapeBase*>(caster))
+    {
+        ShapeBaseData* data = static_cast<ShapeBaseData*>(shape->getDataBlock());
+        if (data && data->shapeName)
+            crc = calculateCRC(data->shapeName, dStrlen(data->shapeName), crc);
+    }
+
+    const MatrixF& transform = caster->getTransform();
+    const Point3F& scale = caster->getScale();
+    const Box3F& box = caster->getObjBox();
+    crc = calculateCRC(&transform, sizeof(MatrixF), crc);
+    crc = calculateCRC(&scale, sizeof(Point3F), crc);
+    crc = calculateCRC(&box, sizeof(Box3F), crc);
+    return crc;
+}
+
 bool SceneLighting::ObjectProxy::calcValidation()
 {
     mChunkCRC = getResourceCRC();
     if (!mChunkCRC)
         return(false);
 
+    SceneObject* obj = getObject();
+    if (!obj || !gLighting)
+        return(true);
+
+    // where the object is...
+    const MatrixF& transform = obj->getTransform();
+    const Point3F& scale = obj->getScale();
+    mChunkCRC = calculateCRC(&transform, sizeof(MatrixF), mChunkCRC);
+    mChunkCRC = calculateCRC(&scale, sizeof(Point3F), mChunkCRC);
+
+    U8 shadows = LightManager::sgAllowShadows();
+    mChunkCRC = calculateCRC(&shadows, sizeof(shadows), mChunkCRC);
+
+    // ...and what lights it, in any order (same filter as sgAddLight)...
+    Vector<LightInfo*> reaching;
+    Vector<U32> lights;
+    for (U32 i = 0; i < gLighting->mLights.size(); i++)
+    {
+        LightInfo* light = gLighting->mLights[i];
+        if (light->mType != LightInfo::Vector)
+        {
+            sgLightingModel& model = sgLightingModelManager::sgGetLightingModel(
+                light->sgLightingModelName);
+            model.sgSetState(light);
+            bool canilluminate = model.sgCanIlluminate(obj->getWorldBox());
+            model.sgResetState();
+
+            if (!canilluminate)
+                continue;
+        }
+
+        reaching.push_back(light);
+        lights.push_back(sgCalcLightCRC(light));
+    }
+
+    if (lights.size())
+    {
+        dQsort(lights.address(), lights.size(), sizeof(U32), compareS32);
+        mChunkCRC = calculateCRC(lights.address(), sizeof(U32) * lights.size(), mChunkCRC);
+    }
+
+    // ...and what can shadow it from those lights, a caster is anything
+    // whose box overlaps the volume between a light and the object.
+    // Vector lights sweep the object's box back along the light direction
+    // far enough to take in the caster.
+    Vector<SceneObject*> objects;
+    if (obj->getContainer())
+        obj->getContainer()->findObjects(InteriorObjectType | TerrainObjectType | ShadowCasterObjectType,
+            findObjectsCallback, &objects);
+
+    const Box3F& box = obj->getWorldBox();
+    Point3F center;
+    box.getCenter(&center);
+
+    Vector<U32> casters;
+    for (U32 i = 0; i < objects.size(); i++)
+    {
+        SceneObject* caster = objects[i];
+        if (caster == obj)
+            continue;
+
+        const Box3F& casterBox = caster->getWorldBox();
+        Point3F casterCenter;
+        casterBox.getCenter(&casterCenter);
+        F32 reach = (casterCenter - center).len() + (casterBox.max - casterBox.min).len();
+
+        for (U32 j = 0; j < reaching.size(); j++)
+        {
+            LightInfo* light = reaching[j];
+
+            Box3F volume = box;
+            if (light->mType == LightInfo::Vector)
+            {
+                Point3F back = light->mDirection * -reach;
+                volume.intersect(Box3F(box.min + back, box.max + back));
+            }
+            else
+                volume.intersect(light->mPos);
+
+            if (volume.isOverlapped(casterBox))
+            {
+                casters.push_back(sgCalcCasterCRC(caster));
+                break;
+            }
+        }
+    }
+
+    if (casters.size())
+    {
+        dQsort(casters.address(), casters.size(), sizeof(U32), compareS32);
+        mChunkCRC = calculateCRC(casters.address(), sizeof(U32) * casters.size(), mChunkCRC);
+    }
+
+    // zero means invalid...
+    if (!mChunkCRC)
+        mChunkCRC = 1;
+
     return(true);
 }
 
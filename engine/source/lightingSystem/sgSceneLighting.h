@@ -71,6 +71,7 @@ public:
 
     bool loadPersistInfo(const char*);
     bool savePersistInfo(const char*);
+    U32 loadIncrementalPersistInfo(const char*);
 
     class ObjectProxy;
     class TerrainProxy;
@@ -90,8 +91,11 @@ public:
     public:
         SimObjectPtr<SceneObject>     mObj;
         U32                           mChunkCRC;
+        /// Lighting was restored from an older cache file, the object
+        /// is left out of the lighting passes.
+        bool                          mCached;
 
-        ObjectProxy(SceneObject* obj) : mObj(obj) { mChunkCRC = 0; }
+        ObjectProxy(SceneObject* obj) : mObj(obj) { mChunkCRC = 0; mCached = false; }
         virtual ~ObjectProxy() {}
         SceneObject* operator->() { return(mObj); }
         SceneObject* getObject() { return(mObj); }
@@ -111,6 +115,12 @@ public:
         ///
         /// There are flags such as ForceAlways and LoadOnly which allow you
         /// to control this behaviour.
+        ///
+        /// The chunk CRC covers the object's resource, its transform, every
+        /// light that can reach it and every object that can shadow it from
+        /// those lights, so a chunk from an older cache file is still valid
+        /// for this object when the CRCs match.  See
+        /// SceneLighting::loadIncrementalPersistInfo.
         /// @{
         bool calcValidation();
         bool isValidChunk(PersistInfo::PersistChunk*);
@@ -348,6 +358,7 @@ public:
         ForceAlways = BIT(0),   ///< Regenerate the scene lighting no matter what.
         ForceWritable = BIT(1),   ///< Regenerate the scene lighting only if we can write to the lighting cache files.
         LoadOnly = BIT(2),   ///< Just load cached lighting data.
+        ForceStale = BIT(3),   ///< Regenerate only the objects whose cached lighting is out of date.
     };
     static bool lightScene(const char*, BitSet32 flags = 0);
     static bool isLighting();
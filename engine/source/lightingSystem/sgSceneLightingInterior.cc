@@ -23,6 +23,7 @@
 #include "lightingSystem/sgLightMap.h"
 #include "lightingSystem/sgSceneLightingGlobals.h"
 #include "lightingSystem/sgLightingModel.h"
+#include "core/threadPool.h"
 
 
 /// adds the ability to bake point lights into interior light maps.
@@ -83,6 +84,155 @@ void SceneLighting::InteriorProxy::sgAddLight(LightInfo* light, InteriorInstance
     sgSurfacesPerPass = sgSurfaces.size() / sgLights.size();
 }
 
+//------------------------------------------------------------------------------
+// The stock shadow volume pass in InteriorProxy::light spends nearly all of its
+// time clipping one poly per lexel against the shadow volume.  The surfaces are
+// set up on the main thread, clipped on the ThreadPool into a color per lexel
+// and then added into the light maps on the main thread in surface order.
+
+/// a surface of the shadow volume pass in flight.
+struct sgLexelJob
+{
+    ShadowVolumeBSP::SurfaceInfo* sgSurfaceInfo;
+    const Interior::Surface* sgSurface;
+    GFXTexHandle sgNormHandle;
+    GFXTexHandle sgAlarmHandle;
+    GBitmap* sgNormLightmap;
+    GBitmap* sgAlarmLightmap;
+    F32 sgDot;
+    ColorF sgAmbient;
+
+    /// lexel walk, only set up for shadowed surfaces.
+    Point3F sgStart;
+    Point3F sgSVec;
+    Point3F sgTVec;
+    F32 sgMaxLexelArea;
+
+    /// mapSizeX * mapSizeY colors filled in by sgLightLexels.
+    Vector<ColorI> sgColors;
+};
+
+/// one light and detail level worth of surfaces.
+struct sgLexelPass
+{
+    ShadowVolumeBSP* sgShadowVolume;
+    LightInfo* sgLight;
+    Vector<sgLexelJob> sgJobs;
+};
+
+/// ThreadPool job, works out the color of every lexel of a shadowed surface.
+static void sgLightLexels(U32 index, void* data)
+{
+    sgLexelPass* pass = static_cast<sgLexelPass*>(data);
+    sgLexelJob& job = pass->sgJobs[index];
+    ShadowVolumeBSP::SurfaceInfo* surfaceInfo = job.sgSurfaceInfo;
+    if (!surfaceInfo->mShadowed.size())
+        return;
+
+    ShadowVolumeBSP& shadowVolume = *pass->sgShadowVolume;
+    LightInfo* light = pass->sgLight;
+    const Interior::Surface& surface = *job.sgSurface;
+
+    // the tree is shared, the polys clipped against it are not...
+    ShadowVolumeBSP::PolyStore polyStore;
+    ShadowVolumeBSP::setThreadPolyStore(&polyStore);
+
+    job.sgColors.setSize(surface.mapSizeX * surface.mapSizeY);
+    ColorI* color = job.sgColors.address();
+
+    const Point3F& sVec = job.sgSVec;
+    const Point3F& tVec = job.sgTVec;
+    Point3F curPos = job.sgStart;
+    Point3F sRun = sVec * surface.mapSizeX;
+
+    const PlaneF& surfacePlane = shadowVolume.getPlane(surfaceInfo->mPlaneIndex);
+
+    // get the world coordinate for each lexel
+    for (U32 y = 0; y < surface.mapSizeY; y++)
+    {
+        for (U32 x = 0; x < surface.mapSizeX; x++)
+        {
+            ShadowVolumeBSP::SVPoly* poly = shadowVolume.createPoly();
+            poly->mPlane = surfacePlane;
+            poly->mWindingCount = 4;
+
+            // set the poly indices
+            poly->mWinding[0] = curPos;
+            poly->mWinding[1] = curPos + sVec;
+            poly->mWinding[2] = curPos + sVec + tVec;
+            poly->mWinding[3] = curPos + tVec;
+
+            F32 area = shadowVolume.getLitSurfaceArea(poly, surfaceInfo);
+            F32 shadowScale = mClampF(area / job.sgMaxLexelArea, 0.f, 1.f);
+
+            // get the color into U8
+            ColorF tmp = (light->mColor * job.sgDot * shadowScale) + job.sgAmbient;
+            tmp.clamp();
+            *color++ = tmp;
+
+            curPos += sVec;
+        }
+
+        curPos -= sRun;
+        curPos += tVec;
+    }
+
+    ShadowVolumeBSP::setThreadPolyStore(NULL);
+}
+
+/// adds a surface's lexels into its normal and alarm light maps, main thread only.
+static void sgWriteLexels(sgLexelJob& job, LightInfo* light)
+{
+    const Interior::Surface& surface = *job.sgSurface;
+    bool shadowed = job.sgSurfaceInfo->mShadowed.size() != 0;
+
+    // unshadowed surfaces are a single color
+    ColorI fill;
+    if (!shadowed)
+    {
+        // calc the color and convert to U8 rep
+        ColorF tmp = (light->mColor * job.sgDot) + job.sgAmbient;
+        tmp.clamp();
+        fill = tmp;
+    }
+
+    // attempt to light both the normal and the alarm states
+    for (U32 c = 0; c < 2; c++)
+    {
+        GBitmap* lightmap = (c == 0) ? job.sgNormLightmap : job.sgAlarmLightmap;
+        if (!lightmap)
+            continue;
+
+        const ColorI* color = shadowed ? job.sgColors.address() : &fill;
+        for (U32 y = 0; y < surface.mapSizeY; y++)
+        {
+            U8* pBits = lightmap->getAddress(surface.mapOffsetX, surface.mapOffsetY + y);
+            for (U32 x = 0; x < surface.mapSizeX; x++)
+            {
+#ifdef SET_COLORS
+                * pBits++ = color->red;
+                *pBits++ = color->green;
+                *pBits++ = color->blue;
+#else
+                U32 _r = static_cast<U32>(color->red) + static_cast<U32>(*pBits);
+                *pBits = (_r <= 255) ? _r : 255;
+                pBits++;
+
+                U32 _g = static_cast<U32>(color->green) + static_cast<U32>(*pBits);
+                *pBits = (_g <= 255) ? _g : 255;
+                pBits++;
+
+                U32 _b = static_cast<U32>(color->blue) + static_cast<U32>(*pBits);
+                *pBits = (_b <= 255) ? _b : 255;
+                pBits++;
+#endif
+                if (shadowed)
+                    color++;
+            }
+        }
+    }
+}
+
 void SceneLighting::InteriorProxy::light(LightInfo* light)
 {
     U32 i;
@@ -91,6 +241,7 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
     ColorF ambient = light->mAmbient;
 
     S32 time = Platform::getRealMilliseconds();
+    bool parallel = Con::getBoolVariable("$pref::sceneLighting::parallelBake", true);
 
     // create own shadow volume
     ShadowVolumeBSP shadowVolume;
@@ -188,6 +339,13 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
 
         gLighting->addInterior(&shadowVolume, *this, light, i);
 
+        // set up every surface and its light maps here, clip the lexels of
+        // the shadowed ones on the ThreadPool and write them all out here...
+        sgLexelPass pass;
+        pass.sgShadowVolume = &shadowVolume;
+        pass.sgLight = light;
+        pass.sgJobs.setSize(shadowVolume.mSurfaces.size());
+
         for (U32 j = 0; j < shadowVolume.mSurfaces.size(); j++)
         {
             ShadowVolumeBSP::SurfaceInfo* surfaceInfo = shadowVolume.mSurfaces[j];
@@ -196,20 +354,24 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
 
             const Interior::Surface& surface = detail->getSurface(surfaceIndex);
 
+            sgLexelJob& job = pass.sgJobs[j];
+            job.sgSurfaceInfo = surfaceInfo;
+            job.sgSurface = &surface;
+
             // alarm lighting
-            GFXTexHandle normHandle = gInteriorLMManager.duplicateBaseLightmap(detail->getLMHandle(), sgInterior->getLMHandle(), detail->getNormalLMapIndex(surfaceIndex));
-            GFXTexHandle alarmHandle;
+            job.sgNormHandle = gInteriorLMManager.duplicateBaseLightmap(detail->getLMHandle(), sgInterior->getLMHandle(), detail->getNormalLMapIndex(surfaceIndex));
 
-            GBitmap* normLightmap = normHandle->getBitmap();
-            GBitmap* alarmLightmap = 0;
+            GBitmap* normLightmap = job.sgNormHandle->getBitmap();
+            job.sgNormLightmap = normLightmap;
+            job.sgAlarmLightmap = 0;
 
             // check if the lightmaps are shared
             if (hasAlarm)
             {
                 if (detail->getNormalLMapIndex(surfaceIndex) != detail->getAlarmLMapIndex(surfaceIndex))
                 {
-                    alarmHandle = gInteriorLMManager.duplicateBaseLightmap(detail->getLMHandle(), sgInterior->getLMHandle(), detail->getAlarmLMapIndex(surfaceIndex));
-                    alarmLightmap = alarmHandle->getBitmap();
+                    job.sgAlarmHandle = gInteriorLMManager.duplicateBaseLightmap(detail->getLMHandle(), sgInterior->getLMHandle(), detail->getAlarmLMapIndex(surfaceIndex));
+                    job.sgAlarmLightmap = job.sgAlarmHandle->getBitmap();
                 }
             }
 
@@ -235,50 +397,12 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
                 ambient.set(0.0, 0.0, 0.0);
             }
 
-            // shadowed?
-            if (!surfaceInfo->mShadowed.size())
-            {
-                // calc the color and convert to U8 rep
-                ColorF tmp = (light->mColor * dot) + ambient;
-                tmp.clamp();
-                ColorI color = tmp;
-
-                // attempt to light both the normal and the alarm states
-                for (U32 c = 0; c < 2; c++)
-                {
-                    GBitmap* lightmap = (c == 0) ? normLightmap : alarmLightmap;
-                    if (!lightmap)
-                        continue;
-
-                    // fill it
-                    for (U32 y = 0; y < surface.mapSizeY; y++)
-                    {
-                        U8* pBits = lightmap->getAddress(surface.mapOffsetX, surface.mapOffsetY + y);
-                        for (U32 x = 0; x < surface.mapSizeX; x++)
-                        {
-#ifdef SET_COLORS
-                            * pBits++ = color.red;
-                            *pBits++ = color.green;
-                            *pBits++ = color.blue;
-#else
-                            U32 _r = static_cast<U32>(color.red) + static_cast<U32>(*pBits);
-                            *pBits = (_r <= 255) ? _r : 255;
-                            pBits++;
-
-                            U32 _g = static_cast<U32>(color.green) + static_cast<U32>(*pBits);
-                            *pBits = (_g <= 255) ? _g : 255;
-                            pBits++;
-
-                            U32 _b = static_cast<U32>(color.blue) + static_cast<U32>(*pBits);
-                            *pBits = (_b <= 255) ? _b : 255;
-                            pBits++;
-#endif
-                        }
-                    }
-                }
+            job.sgDot = dot;
+            job.sgAmbient = ambient;
 
+            // shadowed?  if not the whole surface gets a single color...
+            if (!surfaceInfo->mShadowed.size())
                 continue;
-            }
 
             // get the lmagGen...
             const Interior::TexGenPlanes& lmTexGenEQ = detail->getLMTexGenEQ(surfaceIndex);
@@ -339,7 +463,7 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
 
             const F32* pNormal = ((const F32*)plane);
 
-            Point3F start;
+            Point3F& start = job.sgStart;
             F32* pStart = ((F32*)start);
 
             F32 lumelScale = 1.0 / (lGenX[si] * normLightmap->getWidth());
@@ -353,8 +477,8 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
             transform.mulP(start);
 
             // get the s/t vecs oriented on the surface
-            Point3F sVec;
-            Point3F tVec;
+            Point3F& sVec = job.sgSVec;
+            Point3F& tVec = job.sgTVec;
 
             F32* pSVec = ((F32*)sVec);
             F32* pTVec = ((F32*)tVec);
@@ -396,85 +520,17 @@ void SceneLighting::InteriorProxy::light(LightInfo* light)
             transform.mulV(tVec);
             tVec.convolve(scale);
 
-            Point3F& curPos = start;
-            Point3F sRun = sVec * surface.mapSizeX;
-
             // get the lexel area
             Point3F cross;
             mCross(sVec, tVec, &cross);
-            F32 maxLexelArea = cross.len();
-
-            const PlaneF& surfacePlane = shadowVolume.getPlane(surfaceInfo->mPlaneIndex);
-
-            // get the world coordinate for each lexel
-            for (U32 y = 0; y < surface.mapSizeY; y++)
-            {
-                U8* normBits = normLightmap->getAddress(surface.mapOffsetX, surface.mapOffsetY + y);
-                U8* alarmBits = alarmLightmap ? alarmLightmap->getAddress(surface.mapOffsetX, surface.mapOffsetY + y) : 0;
-
-                for (U32 x = 0; x < surface.mapSizeX; x++)
-                {
-                    ShadowVolumeBSP::SVPoly* poly = shadowVolume.createPoly();
-                    poly->mPlane = surfacePlane;
-                    poly->mWindingCount = 4;
-
-                    // set the poly indices
-                    poly->mWinding[0] = curPos;
-                    poly->mWinding[1] = curPos + sVec;
-                    poly->mWinding[2] = curPos + sVec + tVec;
-                    poly->mWinding[3] = curPos + tVec;
-
-                    //               // insert poly which has been clipped to own shadow volume
-                    //               ShadowVolumeBSP::SVPoly * store = 0;
-                    //               shadowVolume.clipToSelf(surfaceInfo->mShadowVolume, &store, poly);
-                    //
-                    //               if(!store)
-                    //                  continue;
-                    //
-                    //               F32 lexelArea = shadowVolume.getPolySurfaceArea(store);
-                    //               F32 area = shadowVolume.getLitSurfaceArea(store, surfaceInfo);
-
-                    F32 area = shadowVolume.getLitSurfaceArea(poly, surfaceInfo);
-                    F32 shadowScale = mClampF(area / maxLexelArea, 0.f, 1.f);
-
-                    // get the color into U8
-                    ColorF tmp = (light->mColor * dot * shadowScale) + ambient;
-                    tmp.clamp();
-                    ColorI color = tmp;
-
-                    // attempt to light both normal and alarm lightmaps
-                    for (U32 c = 0; c < 2; c++)
-                    {
-                        U8*& pBits = (c == 0) ? normBits : alarmBits;
-                        if (!pBits)
-                            continue;
-
-#ifdef SET_COLORS
-                        * pBits++ = color.red;
-                        *pBits++ = color.green;
-                        *pBits++ = color.blue;
-#else
-                        U32 _r = static_cast<U32>(color.red) + static_cast<U32>(*pBits);
-                        *pBits = (_r <= 255) ? _r : 255;
-                        pBits++;
-
-                        U32 _g = static_cast<U32>(color.green) + static_cast<U32>(*pBits);
-                        *pBits = (_g <= 255) ? _g : 255;
-                        pBits++;
-
-                        U32 _b = static_cast<U32>(color.blue) + static_cast<U32>(*pBits);
-                        *pBits = (_b <= 255) ? _b : 255;
-                        pBits++;
-#endif
-                    }
+            job.sgMaxLexelArea = cross.len();
+        }
 
-                    curPos += sVec;
-                }
+        // the clipping only reads the shadow volume, only this part is threaded...
+        ThreadPool::get()->parallelFor(pass.sgJobs.size(), sgLightLexels, &pass, parallel);
 
-                curPos -= sRun;
-                curPos += tVec;
-            }
-        }
+        for (U32 j = 0; j < pass.sgJobs.size(); j++)
+            sgWriteLexels(pass.sgJobs[j], light);
     }
 
     Con::printf("    = interior lit in %3.3f seconds", (Platform::getRealMilliseconds() - time) / 1000.f);
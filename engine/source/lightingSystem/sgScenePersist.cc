@@ -9,7 +9,7 @@
 //------------------------------------------------------------------------------
 // Class SceneLighting::PersistInfo
 //------------------------------------------------------------------------------
-U32 PersistInfo::smFileVersion = 0x11;
+U32 PersistInfo::smFileVersion = 0x12;
 
 PersistInfo::~PersistInfo()
 {
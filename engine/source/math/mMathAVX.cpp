@@ -0,0 +1,95 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "math/mMathFn.h"
+
+// AVX/FMA versions of the hottest math kernels.  The rest of the engine is not
+// built with -mavx, so the functions are compiled for AVX individually and are
+// only installed when Processor::init() found both AVX and FMA.
+//
+// Fused multiply-adds round once instead of twice, so results may differ from
+// the C and SSE versions in the last bit.
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#  if defined(TORQUE_COMPILER_GCC)
+#     define ADD_AVX_FN
+#     define AVX_FN __attribute__((target("avx,fma")))
+#  elif defined(TORQUE_COMPILER_VISUALC) && (_MSC_VER >= 1700)
+#     define ADD_AVX_FN
+#     define AVX_FN
+#  endif
+#endif
+
+#if defined(ADD_AVX_FN)
+#include <immintrin.h>
+
+// Two result rows per iteration: the low lane of each register works on row
+// i and the high lane on row i + 1.
+AVX_FN static void AVX_MatrixF_x_MatrixF(const F32* matA, const F32* matB, F32* result)
+{
+    const __m256 b0 = _mm256_broadcast_ps((const __m128*)(matB));
+    const __m256 b1 = _mm256_broadcast_ps((const __m128*)(matB + 4));
+    const __m256 b2 = _mm256_broadcast_ps((const __m128*)(matB + 8));
+    const __m256 b3 = _mm256_broadcast_ps((const __m128*)(matB + 12));
+
+    for (U32 i = 0; i < 16; i += 8)
+    {
+        const __m256 a = _mm256_loadu_ps(matA + i);
+
+        __m256 row = _mm256_mul_ps(_mm256_permute_ps(a, 0x00), b0);
+        row = _mm256_fmadd_ps(_mm256_permute_ps(a, 0x55), b1, row);
+        row = _mm256_fmadd_ps(_mm256_permute_ps(a, 0xAA), b2, row);
+        row = _mm256_fmadd_ps(_mm256_permute_ps(a, 0xFF), b3, row);
+        _mm256_storeu_ps(result + i, row);
+    }
+}
+
+AVX_FN static void AVX_Point3F_BulkDot(const F32* refVector,
+    const F32* dotPoints,
+    const U32  numPoints,
+    const U32  pointStride,
+    F32* output)
+{
+    const __m256 rx = _mm256_set1_ps(refVector[0]);
+    const __m256 ry = _mm256_set1_ps(refVector[1]);
+    const __m256 rz = _mm256_set1_ps(refVector[2]);
+
+#define POINT(n) ((const F32*)(((const U8*)dotPoints) + (pointStride * (i + n))))
+
+    U32 i = 0;
+    for (; i + 8 <= numPoints; i += 8)
+    {
+        const F32* p0 = POINT(0);
+        const F32* p1 = POINT(1);
+        const F32* p2 = POINT(2);
+        const F32* p3 = POINT(3);
+        const F32* p4 = POINT(4);
+        const F32* p5 = POINT(5);
+        const F32* p6 = POINT(6);
+        const F32* p7 = POINT(7);
+
+        __m256 dot = _mm256_mul_ps(rx, _mm256_setr_ps(p0[0], p1[0], p2[0], p3[0], p4[0], p5[0], p6[0], p7[0]));
+        dot = _mm256_fmadd_ps(ry, _mm256_setr_ps(p0[1], p1[1], p2[1], p3[1], p4[1], p5[1], p6[1], p7[1]), dot);
+        dot = _mm256_fmadd_ps(rz, _mm256_setr_ps(p0[2], p1[2], p2[2], p3[2], p4[2], p5[2], p6[2], p7[2]), dot);
+        _mm256_storeu_ps(output + i, dot);
+    }
+
+    for (; i < numPoints; i++)
+    {
+        const F32* p = POINT(0);
+        output[i] = (refVector[0] * p[0]) + (refVector[1] * p[1]) + (refVector[2] * p[2]);
+    }
+#undef POINT
+}
+
+#endif
+
+void mInstall_Library_AVX()
+{
+#if defined(ADD_AVX_FN)
+    m_matF_x_matF = AVX_MatrixF_x_MatrixF;
+    m_point3F_bulk_dot = AVX_Point3F_BulkDot;
+#endif
+}
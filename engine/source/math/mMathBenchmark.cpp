@@ -0,0 +1,282 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "console/console.h"
+#include "math/mMathFn.h"
+#include "math/mRandom.h"
+#include "math/mPoint.h"
+
+// The C versions, so the installed kernels can be timed against them
+// without reinstalling the library (see mMath_C.cpp).
+extern void default_matF_x_matF_C(const F32* a, const F32* b, F32* mresult);
+extern void m_matF_x_box3F_C(const F32* m, F32* min, F32* max);
+extern void m_matF_affineInverse_C(F32* m);
+extern void m_point3F_bulk_dot_C(const F32* refVector, const F32* dotPoints,
+    const U32 numPoints, const U32 pointStride, F32* output);
+
+namespace
+{
+    enum
+    {
+        NumMatrices = 64,
+        NumPoints = 1024,
+    };
+
+    struct BenchData
+    {
+        F32 mats[NumMatrices][16];
+        F32 boxes[NumMatrices][6];
+        F32 points[NumPoints][3];
+        F32 out[NumMatrices][16];   ///< Also used as a second NumPoints sized dot buffer.
+        F32 dots[NumPoints];
+    };
+
+    /// Fills @a data with affine transforms, boxes and points.
+    void fillBenchData(BenchData& data)
+    {
+        MRandomLCG rand(1376312589);
+        for (U32 i = 0; i < NumMatrices; i++)
+        {
+            F32* m = data.mats[i];
+            for (U32 j = 0; j < 12; j++)
+                m[j] = rand.randF(-2.0f, 2.0f);
+            m[12] = m[13] = m[14] = 0.0f;
+            m[15] = 1.0f;
+
+            for (U32 j = 0; j < 3; j++)
+            {
+                data.boxes[i][j] = rand.randF(-10.0f, 0.0f);
+                data.boxes[i][j + 3] = rand.randF(0.0f, 10.0f);
+            }
+        }
+        for (U32 i = 0; i < NumPoints; i++)
+            for (U32 j = 0; j < 3; j++)
+                data.points[i][j] = rand.randF(-100.0f, 100.0f);
+    }
+
+    F32 maxDiff(const F32* a, const F32* b, const U32 count)
+    {
+        F32 diff = 0.0f;
+        for (U32 i = 0; i < count; i++)
+            diff = getMax(diff, mFabs(a[i] - b[i]));
+        return diff;
+    }
+
+    //--------------------------------------------------------------------------
+    // One loop per kernel, each run for the C and the installed version.
+
+    U32 timeMatFxMatF(void (*fn)(const F32*, const F32*, F32*), BenchData& data, const U32 iterations)
+    {
+        U32 start = Platform::getRealMilliseconds();
+        for (U32 i = 0; i < iterations; i++)
+            fn(data.mats[i % NumMatrices], data.mats[(i + 1) % NumMatrices], data.out[i % NumMatrices]);
+        return Platform::getRealMilliseconds() - start;
+    }
+
+    U32 timeMatFxBox3F(void (*fn)(const F32*, F32*, F32*), BenchData& data, const U32 iterations)
+    {
+        U32 start = Platform::getRealMilliseconds();
+        for (U32 i = 0; i < iterations; i++)
+        {
+            F32* box = data.out[i % NumMatrices];
+            dMemcpy(box, data.boxes[i % NumMatrices], sizeof(data.boxes[0]));
+            fn(data.mats[i % NumMatrices], box, box + 3);
+        }
+        return Platform::getRealMilliseconds() - start;
+    }
+
+    U32 timeAffineInverse(void (*fn)(F32*), BenchData& data, const U32 iterations)
+    {
+        U32 start = Platform::getRealMilliseconds();
+        for (U32 i = 0; i < iterations; i++)
+            fn(data.out[i % NumMatrices]);
+        return Platform::getRealMilliseconds() - start;
+    }
+
+    U32 timeBulkDot(void (*fn)(const F32*, const F32*, const U32, const U32, F32*), BenchData& data, const U32 iterations)
+    {
+        U32 start = Platform::getRealMilliseconds();
+        for (U32 i = 0; i < iterations; i++)
+            fn(data.mats[i % NumMatrices], data.points[0], NumPoints, sizeof(data.points[0]), data.dots);
+        return Platform::getRealMilliseconds() - start;
+    }
+
+    void printResult(const char* name, const U32 cTime, const U32 fnTime, const bool installed, const F32 diff)
+    {
+        if (!installed)
+        {
+            Con::printf("   %-24s %6d ms   (C version installed)", name, cTime);
+            return;
+        }
+
+        F32 speedup = fnTime ? F32(cTime) / F32(fnTime) : 0.0f;
+        Con::printf("   %-24s %6d ms  %6d ms  %5.2fx   max diff %g", name, cTime, fnTime, speedup, diff);
+    }
+}
+
+ConsoleFunction(mathBenchmark, void, 1, 2, "mathBenchmark( [iterations] );"
+    "Times the installed matrix/box/bulk dot kernels against the C versions and prints the results. "
+    "Use mathInit() first to pick which extensions are tested.")
+{
+    U32 iterations = argc > 1 ? dAtoi(argv[1]) : 1000000;
+    iterations = getMax(iterations, U32(NumMatrices));
+
+    BenchData* data = new BenchData;
+    fillBenchData(*data);
+
+    F32 ref[16], result[16];
+
+    Con::printf("Math benchmark: %d iterations", iterations);
+    Con::printf("   %-24s %9s  %9s  %6s", "kernel", "C", "installed", "speedup");
+
+    // m_matF_x_matF
+    {
+        U32 cTime = timeMatFxMatF(default_matF_x_matF_C, *data, iterations);
+        U32 fnTime = timeMatFxMatF(m_matF_x_matF, *data, iterations);
+
+        default_matF_x_matF_C(data->mats[0], data->mats[1], ref);
+        m_matF_x_matF(data->mats[0], data->mats[1], result);
+        printResult("m_matF_x_matF", cTime, fnTime, m_matF_x_matF != default_matF_x_matF_C, maxDiff(ref, result, 16));
+    }
+
+    // m_matF_x_box3F
+    {
+        U32 cTime = timeMatFxBox3F(m_matF_x_box3F_C, *data, iterations);
+        U32 fnTime = timeMatFxBox3F(m_matF_x_box3F, *data, iterations);
+
+        dMemcpy(ref, data->boxes[0], sizeof(data->boxes[0]));
+        dMemcpy(result, data->boxes[0], sizeof(data->boxes[0]));
+        m_matF_x_box3F_C(data->mats[0], ref, ref + 3);
+        m_matF_x_box3F(data->mats[0], result, result + 3);
+        printResult("m_matF_x_box3F", cTime, fnTime, m_matF_x_box3F != m_matF_x_box3F_C, maxDiff(ref, result, 6));
+    }
+
+    // m_matF_affineInverse
+    {
+        for (U32 i = 0; i < NumMatrices; i++)
+            dMemcpy(data->out[i], data->mats[i], sizeof(data->mats[0]));
+        U32 cTime = timeAffineInverse(m_matF_affineInverse_C, *data, iterations);
+        U32 fnTime = timeAffineInverse(m_matF_affineInverse, *data, iterations);
+
+        dMemcpy(ref, data->mats[0], sizeof(ref));
+        dMemcpy(result, data->mats[0], sizeof(result));
+        m_matF_affineInverse_C(ref);
+        m_matF_affineInverse(result);
+        printResult("m_matF_affineInverse", cTime, fnTime, m_matF_affineInverse != m_matF_affineInverse_C, maxDiff(ref, result, 16));
+    }
+
+    // m_point3F_bulk_dot, NumPoints points per call
+    {
+        U32 dotIterations = getMax(iterations / (NumPoints / 4), U32(1));
+        U32 cTime = timeBulkDot(m_point3F_bulk_dot_C, *data, dotIterations);
+        U32 fnTime = timeBulkDot(m_point3F_bulk_dot, *data, dotIterations);
+
+        F32* dots = data->out[0];
+        m_point3F_bulk_dot_C(data->mats[0], data->points[0], NumPoints, sizeof(data->points[0]), data->dots);
+        m_point3F_bulk_dot(data->mats[0], data->points[0], NumPoints, sizeof(data->points[0]), dots);
+        printResult("m_point3F_bulk_dot", cTime, fnTime, m_point3F_bulk_dot != m_point3F_bulk_dot_C, maxDiff(data->dots, dots, NumPoints));
+    }
+
+    delete data;
+}
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+    /// Random value spread over many orders of magnitude, both signs.
+    F64 randWide(MRandomLCG& rand)
+    {
+        F64 mantissa = rand.randF(-1.0f, 1.0f);
+        return mantissa * mPow(10.0, F64(rand.randI(-8, 8))) + rand.randF(-1.0f, 1.0f) / 3.0;
+    }
+
+    Point3D randPoint3D(MRandomLCG& rand)
+    {
+        return Point3D(randWide(rand), randWide(rand), randWide(rand));
+    }
+
+    bool sameBits(const void* a, const void* b, const U32 size)
+    {
+        return dMemcmp(a, b, size) == 0;
+    }
+}
+
+ConsoleFunction(mVerifyPoint3DSimd, S32, 1, 2, "mVerifyPoint3DSimd( [iterations] );"
+    "Checks the Point3D operations used by marble physics bit for bit against plain scalar code. "
+    "Prints and returns the number of mismatches, which must be 0 for recordings to stay in sync.")
+{
+    U32 iterations = argc > 1 ? dAtoi(argv[1]) : 100000;
+
+#ifdef TORQUE_POINT3D_SSE2
+    Con::printf("Point3D math: SSE2");
+#else
+    Con::printf("Point3D math: scalar (nothing to verify)");
+#endif
+
+    enum { Add, Sub, Mul, Scale, Div, Neg, AddAssign, SubAssign, Dot, Cross, Len, LenSquared, ToF, FromF, NumOps };
+    static const char* opNames[NumOps] = { "+", "-", "* Point3D", "* F64", "/ F64", "unary -", "+=", "-=",
+        "mDot", "mCross", "len", "lenSquared", "to Point3F", "from Point3F" };
+    U32 mismatches[NumOps];
+    dMemset(mismatches, 0, sizeof(mismatches));
+
+    MRandomLCG rand(94237561);
+    for (U32 i = 0; i < iterations; i++)
+    {
+        const Point3D a = randPoint3D(rand);
+        const Point3D b = randPoint3D(rand);
+        const F64 s = randWide(rand);
+        F64 ref[3];
+
+#define CHECK_POINT(op, val, rx, ry, rz) \
+        { ref[0] = rx; ref[1] = ry; ref[2] = rz; Point3D res = val; if (!sameBits(&res.x, ref, sizeof(ref))) mismatches[op]++; }
+#define CHECK_SCALAR(op, val, r) \
+        { F64 res = val; F64 rs = r; if (!sameBits(&res, &rs, sizeof(rs))) mismatches[op]++; }
+
+        CHECK_POINT(Add, a + b, a.x + b.x, a.y + b.y, a.z + b.z);
+        CHECK_POINT(Sub, a - b, a.x - b.x, a.y - b.y, a.z - b.z);
+        CHECK_POINT(Mul, a * b, a.x * b.x, a.y * b.y, a.z * b.z);
+        CHECK_POINT(Scale, a * s, a.x * s, a.y * s, a.z * s);
+        if (s != 0.0)
+        {
+            F64 inv = 1.0 / s;
+            CHECK_POINT(Div, a / s, a.x * inv, a.y * inv, a.z * inv);
+        }
+        CHECK_POINT(Neg, -a, -a.x, -a.y, -a.z);
+
+        Point3D acc = a;
+        acc += b;
+        CHECK_POINT(AddAssign, acc, a.x + b.x, a.y + b.y, a.z + b.z);
+        acc = a;
+        acc -= b;
+        CHECK_POINT(SubAssign, acc, a.x - b.x, a.y - b.y, a.z - b.z);
+
+        CHECK_SCALAR(Dot, mDot(a, b), a.x * b.x + a.y * b.y + a.z * b.z);
+        CHECK_POINT(Cross, mCross(a, b), (a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x));
+        CHECK_SCALAR(Len, a.len(), mSqrtD(a.x * a.x + a.y * a.y + a.z * a.z));
+        CHECK_SCALAR(LenSquared, a.lenSquared(), (a.x * a.x) + (a.y * a.y) + (a.z * a.z));
+
+        Point3F f = a;
+        F32 fref[3] = { F32(a.x), F32(a.y), F32(a.z) };
+        if (!sameBits(&f.x, fref, sizeof(fref)))
+            mismatches[ToF]++;
+
+        CHECK_POINT(FromF, Point3D(f), F64(f.x), F64(f.y), F64(f.z));
+
+#undef CHECK_POINT
+#undef CHECK_SCALAR
+    }
+
+    U32 total = 0;
+    for (U32 i = 0; i < NumOps; i++)
+    {
+        if (mismatches[i])
+            Con::errorf("   %-14s %d mismatches", opNames[i], mismatches[i]);
+        total += mismatches[i];
+    }
+    Con::printf("   %d iterations, %d mismatches", iterations, total);
+    return total;
+}
@@ -400,14 +400,36 @@ inline void mCross(const Point3F& a, const Point3F& b, Point3F* res)
 
 inline F64 mDot(const Point3D& p1, const Point3D& p2)
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d axy, az, bxy, bz;
+    m_point3D_load(p1, axy, az);
+    m_point3D_load(p2, bxy, bz);
+    return _mm_cvtsd_f64(m_point3D_dot(axy, az, bxy, bz));
+#else
     return (p1.x * p2.x + p1.y * p2.y + p1.z * p2.z);
+#endif
 }
 
 inline void mCross(const Point3D& a, const Point3D& b, Point3D* res)
 {
+#ifdef TORQUE_POINT3D_SSE2
+    // x and y: (a.y, a.z) * (b.z, b.x) - (a.z, a.x) * (b.y, b.z)
+    const __m128d ayz = _mm_loadu_pd(&a.y);
+    const __m128d azx = _mm_loadh_pd(_mm_load_sd(&a.z), &a.x);
+    const __m128d bzx = _mm_loadh_pd(_mm_load_sd(&b.z), &b.x);
+    const __m128d byz = _mm_loadu_pd(&b.y);
+    const __m128d xy = _mm_sub_pd(_mm_mul_pd(ayz, bzx), _mm_mul_pd(azx, byz));
+
+    // z: a.x * b.y - a.y * b.x
+    const __m128d z = _mm_sub_sd(_mm_mul_sd(_mm_load_sd(&a.x), _mm_load_sd(&b.y)),
+        _mm_mul_sd(_mm_load_sd(&a.y), _mm_load_sd(&b.x)));
+
+    m_point3D_store(*res, xy, z);
+#else
     res->x = (a.y * b.z) - (a.z * b.y);
     res->y = (a.z * b.x) - (a.x * b.z);
     res->z = (a.x * b.y) - (a.y * b.x);
+#endif
 }
 
 inline Point3F mCross(const Point3F& a, const Point3F& b)
@@ -24,6 +24,10 @@
 #include "math/mPlane.h"
 #include "math/mMatrix.h"
 
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#include <xmmintrin.h>
+#endif
+
 
 #if defined(TORQUE_SUPPORTS_VC_INLINE_X86_ASM)
 #define ADD_SSE_FN
@@ -203,173 +207,179 @@ extern "C"
     void SSE_MatrixF_x_MatrixF_Aligned(const F32* matA, const F32* matB, F32* result);
 }
 
-#elif defined( TORQUE_COMPILER_GCC ) && (defined( TORQUE_CPU_X86 ) || defined( TORQUE_CPU_X64 ))
+#elif defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
 #define ADD_SSE_FN
+// Intrinsics version for everything that can't take the VC inline asm above.
+// The old GCC inline asm addressed through 32 bit registers and so could not
+// be used on x64 builds.
+
+// Rows of the result are accumulated in the same order as the C version
+// (((a0*b0 + a1*b1) + a2*b2) + a3*b3), so both give identical results.
+// @a result may alias @a matA or @a matB.
+static inline void SSE_MatrixF_x_MatrixF_Rows(const F32* matA, const __m128 b[4], F32* result, const bool aligned)
+{
+    for (U32 i = 0; i < 4; i++)
+    {
+        const F32* a = matA + i * 4;
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a[0]), b[0]);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[1]), b[1]));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[2]), b[2]));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[3]), b[3]));
+        if (aligned)
+            _mm_store_ps(result + i * 4, row);
+        else
+            _mm_storeu_ps(result + i * 4, row);
+    }
+}
 
 void SSE_MatrixF_x_MatrixF(const F32* matA, const F32* matB, F32* result)
 {
-    asm
-    (
-        "movss      (%%edx),%%xmm0\n"
-        "movups     (%%ecx),%%xmm1\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "movss      4(%%edx),%%xmm2\n"
-        "mulps      %%xmm1,%%xmm0\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "movups     0x10(%%ecx),%%xmm3\n"
-        "movss      8(%%edx),%%xmm7\n"
-        "mulps      %%xmm3,%%xmm2\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "addps      %%xmm2,%%xmm0\n"
-        "movups     0x20(%%ecx),%%xmm4\n"
-        "movss      0x0c(%%edx),%%xmm2\n"
-        "mulps      %%xmm4,%%xmm7\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "addps      %%xmm7,%%xmm0\n"
-        "movups     0x30(%%ecx),%%xmm5\n"
-        "movss      0x10(%%edx),%%xmm6\n"
-        "mulps      %%xmm5,%%xmm2\n"
-        "movss      0x14(%%edx),%%xmm7\n"
-        "shufps     $0,%%xmm6,%%xmm6\n"
-        "addps      %%xmm2,%%xmm0\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "movlps     %%xmm0,(%%eax)\n"
-        "movhps     %%xmm0,8(%%eax)\n"
-        "mulps      %%xmm3,%%xmm7\n"
-        "movss      0x18(%%edx),%%xmm0\n"
-        "mulps      %%xmm1,%%xmm6\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "addps      %%xmm7,%%xmm6\n"
-        "mulps      %%xmm4,%%xmm0\n"
-        "movss      0x24(%%edx),%%xmm2\n"
-        "addps      %%xmm0,%%xmm6\n"
-        "movss      0x1c(%%edx),%%xmm0\n"
-        "movss      0x20(%%edx),%%xmm7\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "mulps      %%xmm5,%%xmm0\n"
-        "mulps      %%xmm1,%%xmm7\n"
-        "addps      %%xmm0,%%xmm6\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "movlps     %%xmm6,0x10(%%eax)\n"
-        "movhps     %%xmm6,0x18(%%eax)\n"
-        "mulps      %%xmm3,%%xmm2\n"
-        "movss      0x28(%%edx),%%xmm6\n"
-        "addps      %%xmm2,%%xmm7\n"
-        "shufps     $0,%%xmm6,%%xmm6\n"
-        "movss      0x2c(%%edx),%%xmm2\n"
-        "mulps      %%xmm4,%%xmm6\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "addps      %%xmm6,%%xmm7\n"
-        "mulps      %%xmm5,%%xmm2\n"
-        "movss      0x34(%%edx),%%xmm0\n"
-        "addps      %%xmm2,%%xmm7\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "movlps     %%xmm7,0x20(%%eax)\n"
-        "movss      0x30(%%edx),%%xmm2\n"
-        "movhps     %%xmm7,0x28(%%eax)\n"
-        "mulps      %%xmm3,%%xmm0\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "movss      0x38(%%edx),%%xmm6\n"
-        "mulps      %%xmm1,%%xmm2\n"
-        "shufps     $0,%%xmm6,%%xmm6\n"
-        "addps      %%xmm0,%%xmm2\n"
-        "mulps      %%xmm4,%%xmm6\n"
-        "movss      0x3c(%%edx),%%xmm7\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "addps      %%xmm6,%%xmm2\n"
-        "mulps      %%xmm5,%%xmm7\n"
-        "addps      %%xmm7,%%xmm2\n"
-        "movups     %%xmm2,0x30(%%eax)\n"
-
-        :
-    : "d" (matA),
-        "c" (matB),
-        "a" (result)
-        );
+    __m128 b[4];
+    b[0] = _mm_loadu_ps(matB);
+    b[1] = _mm_loadu_ps(matB + 4);
+    b[2] = _mm_loadu_ps(matB + 8);
+    b[3] = _mm_loadu_ps(matB + 12);
+    SSE_MatrixF_x_MatrixF_Rows(matA, b, result, false);
 }
 
 void SSE_MatrixF_x_MatrixF_Aligned(const F32* matA, const F32* matB, F32* result)
 {
-    asm
-    (
-        "movss      (%%edx),%%xmm0\n"
-        "movaps     (%%ecx),%%xmm1\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "movss      4(%%edx),%%xmm2\n"
-        "mulps      %%xmm1,%%xmm0\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "movaps     0x10(%%ecx),%%xmm3\n"
-        "movss      8(%%edx),%%xmm7\n"
-        "mulps      %%xmm3,%%xmm2\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "addps      %%xmm2,%%xmm0\n"
-        "movaps     0x20(%%ecx),%%xmm4\n"
-        "movss      0x0c(%%edx),%%xmm2\n"
-        "mulps      %%xmm4,%%xmm7\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "addps      %%xmm7,%%xmm0\n"
-        "movaps     0x30(%%ecx),%%xmm5\n"
-        "movss      0x10(%%edx),%%xmm6\n"
-        "mulps      %%xmm5,%%xmm2\n"
-        "movss      0x14(%%edx),%%xmm7\n"
-        "shufps     $0,%%xmm6,%%xmm6\n"
-        "addps      %%xmm2,%%xmm0\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "movlps     %%xmm0,(%%eax)\n"
-        "movhps     %%xmm0,8(%%eax)\n"
-        "mulps      %%xmm3,%%xmm7\n"
-        "movss      0x18(%%edx),%%xmm0\n"
-        "mulps      %%xmm1,%%xmm6\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "addps      %%xmm7,%%xmm6\n"
-        "mulps      %%xmm4,%%xmm0\n"
-        "movss      0x24(%%edx),%%xmm2\n"
-        "addps      %%xmm0,%%xmm6\n"
-        "movss      0x1c(%%edx),%%xmm0\n"
-        "movss      0x20(%%edx),%%xmm7\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "mulps      %%xmm5,%%xmm0\n"
-        "mulps      %%xmm1,%%xmm7\n"
-        "addps      %%xmm0,%%xmm6\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "movlps     %%xmm6,0x10(%%eax)\n"
-        "movhps     %%xmm6,0x18(%%eax)\n"
-        "mulps      %%xmm3,%%xmm2\n"
-        "movss      0x28(%%edx),%%xmm6\n"
-        "addps      %%xmm2,%%xmm7\n"
-        "shufps     $0,%%xmm6,%%xmm6\n"
-        "movss      0x2c(%%edx),%%xmm2\n"
-        "mulps      %%xmm4,%%xmm6\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "addps      %%xmm6,%%xmm7\n"
-        "mulps      %%xmm5,%%xmm2\n"
-        "movss      0x34(%%edx),%%xmm0\n"
-        "addps      %%xmm2,%%xmm7\n"
-        "shufps     $0,%%xmm0,%%xmm0\n"
-        "movlps     %%xmm7,0x20(%%eax)\n"
-        "movss      0x30(%%edx),%%xmm2\n"
-        "movhps     %%xmm7,0x28(%%eax)\n"
-        "mulps      %%xmm3,%%xmm0\n"
-        "shufps     $0,%%xmm2,%%xmm2\n"
-        "movss      0x38(%%edx),%%xmm6\n"
-        "mulps      %%xmm1,%%xmm2\n"
-        "shufps     $0,%%xmm6,%%xmm6\n"
-        "addps      %%xmm0,%%xmm2\n"
-        "mulps      %%xmm4,%%xmm6\n"
-        "movss      0x3c(%%edx),%%xmm7\n"
-        "shufps     $0,%%xmm7,%%xmm7\n"
-        "addps      %%xmm6,%%xmm2\n"
-        "mulps      %%xmm5,%%xmm7\n"
-        "addps      %%xmm7,%%xmm2\n"
-        "movaps     %%xmm2,0x30(%%eax)\n"
-
-        :
-    : "d" (matA),
-        "c" (matB),
-        "a" (result)
-        );
+    __m128 b[4];
+    b[0] = _mm_load_ps(matB);
+    b[1] = _mm_load_ps(matB + 4);
+    b[2] = _mm_load_ps(matB + 8);
+    b[3] = _mm_load_ps(matB + 12);
+    SSE_MatrixF_x_MatrixF_Rows(matA, b, result, true);
+}
+
+#endif
+
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#define ADD_SSE_INTRINSIC_FN
+//------------------------------------------------------------------------------
+// Kernels without an asm version.  These only need SSE1 and keep the
+// operation order of mMath_C.cpp, so they are drop-in replacements.
+
+static void SSE_MatrixF_AffineInverse(F32* m)
+{
+    __m128 r0 = _mm_loadu_ps(m);
+    __m128 r1 = _mm_loadu_ps(m + 4);
+    __m128 r2 = _mm_loadu_ps(m + 8);
+
+    // -(R^T * t), computed from the untransposed rows.
+    __m128 trans = _mm_mul_ps(r0, _mm_set1_ps(m[3]));
+    trans = _mm_add_ps(trans, _mm_mul_ps(r1, _mm_set1_ps(m[7])));
+    trans = _mm_add_ps(trans, _mm_mul_ps(r2, _mm_set1_ps(m[11])));
+    // Flip the sign bit like the C unary minus, 0 - x would turn -0 into +0.
+    trans = _mm_xor_ps(trans, _mm_set1_ps(-0.0f));
+
+    // Transposing with trans in the fourth row moves it into the translation column.
+    _MM_TRANSPOSE4_PS(r0, r1, r2, trans);
+    _mm_storeu_ps(m, r0);
+    _mm_storeu_ps(m + 4, r1);
+    _mm_storeu_ps(m + 8, r2);
+}
+
+static void SSE_MatrixF_x_Box3F(const F32* m, F32* min, F32* max)
+{
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    __m128 outMin = c3;
+    __m128 outMax = c3;
+
+#define  Do_One_Column(j, col)   {                                   \
+         __m128 a = _mm_mul_ps(col, _mm_set1_ps(min[j]));            \
+         __m128 b = _mm_mul_ps(col, _mm_set1_ps(max[j]));            \
+         outMin = _mm_add_ps(outMin, _mm_min_ps(a, b));              \
+         outMax = _mm_add_ps(outMax, _mm_max_ps(b, a));   }
+
+    Do_One_Column(0, c0);
+    Do_One_Column(1, c1);
+    Do_One_Column(2, c2);
+#undef Do_One_Column
+
+    F32 result[8];
+    _mm_storeu_ps(result, outMin);
+    _mm_storeu_ps(result + 4, outMax);
+    min[0] = result[0];
+    min[1] = result[1];
+    min[2] = result[2];
+    max[0] = result[4];
+    max[1] = result[5];
+    max[2] = result[6];
+}
+
+static void SSE_Point3F_BulkDot(const F32* refVector,
+    const F32* dotPoints,
+    const U32  numPoints,
+    const U32  pointStride,
+    F32* output)
+{
+    const __m128 rx = _mm_set1_ps(refVector[0]);
+    const __m128 ry = _mm_set1_ps(refVector[1]);
+    const __m128 rz = _mm_set1_ps(refVector[2]);
+
+#define POINT(n) ((const F32*)(((const U8*)dotPoints) + (pointStride * (i + n))))
+
+    U32 i = 0;
+    for (; i + 4 <= numPoints; i += 4)
+    {
+        const F32* p0 = POINT(0);
+        const F32* p1 = POINT(1);
+        const F32* p2 = POINT(2);
+        const F32* p3 = POINT(3);
+
+        __m128 dot = _mm_mul_ps(rx, _mm_setr_ps(p0[0], p1[0], p2[0], p3[0]));
+        dot = _mm_add_ps(dot, _mm_mul_ps(ry, _mm_setr_ps(p0[1], p1[1], p2[1], p3[1])));
+        dot = _mm_add_ps(dot, _mm_mul_ps(rz, _mm_setr_ps(p0[2], p1[2], p2[2], p3[2])));
+        _mm_storeu_ps(output + i, dot);
+    }
+
+    for (; i < numPoints; i++)
+    {
+        const F32* p = POINT(0);
+        output[i] = (refVector[0] * p[0]) + (refVector[1] * p[1]) + (refVector[2] * p[2]);
+    }
+#undef POINT
+}
+
+static void SSE_Point3F_BulkDotIndexed(const F32* refVector,
+    const F32* dotPoints,
+    const U32  numPoints,
+    const U32  pointStride,
+    const U32* pointIndices,
+    F32* output)
+{
+    const __m128 rx = _mm_set1_ps(refVector[0]);
+    const __m128 ry = _mm_set1_ps(refVector[1]);
+    const __m128 rz = _mm_set1_ps(refVector[2]);
+
+#define POINT(n) ((const F32*)(((const U8*)dotPoints) + (pointStride * pointIndices[i + n])))
+
+    U32 i = 0;
+    for (; i + 4 <= numPoints; i += 4)
+    {
+        const F32* p0 = POINT(0);
+        const F32* p1 = POINT(1);
+        const F32* p2 = POINT(2);
+        const F32* p3 = POINT(3);
+
+        __m128 dot = _mm_mul_ps(rx, _mm_setr_ps(p0[0], p1[0], p2[0], p3[0]));
+        dot = _mm_add_ps(dot, _mm_mul_ps(ry, _mm_setr_ps(p0[1], p1[1], p2[1], p3[1])));
+        dot = _mm_add_ps(dot, _mm_mul_ps(rz, _mm_setr_ps(p0[2], p1[2], p2[2], p3[2])));
+        _mm_storeu_ps(output + i, dot);
+    }
+
+    for (; i < numPoints; i++)
+    {
+        const F32* p = POINT(0);
+        output[i] = (refVector[0] * p[0]) + (refVector[1] * p[1]) + (refVector[2] * p[2]);
+    }
+#undef POINT
 }
 
 #endif
@@ -382,4 +392,10 @@ void mInstall_Library_SSE()
     // m_matF_x_point3F = Athlon_MatrixF_x_Point3F;
     // m_matF_x_vectorF = Athlon_MatrixF_x_VectorF;
 #endif
+#if defined(ADD_SSE_INTRINSIC_FN)
+    m_matF_affineInverse = SSE_MatrixF_AffineInverse;
+    m_matF_x_box3F = SSE_MatrixF_x_Box3F;
+    m_point3F_bulk_dot = SSE_Point3F_BulkDot;
+    m_point3F_bulk_dot_indexed = SSE_Point3F_BulkDotIndexed;
+#endif
 }
@@ -422,7 +422,7 @@ static void m_matF_inverse_C(F32* m)
 }
 
 //--------------------------------------
-static void m_matF_affineInverse_C(F32* m)
+void m_matF_affineInverse_C(F32* m)
 {
     // Matrix class checks to make sure this is an affine transform before calling
     //  this function, so we can proceed assuming it is...
@@ -660,7 +660,7 @@ static void m_matF_x_scale_x_planeF_C(const F32* m, const F32* s, const F32* p,
     presult[3] = resultPlane.d;
 }
 
-static void m_matF_x_box3F_C(const F32* m, F32* min, F32* max)
+void m_matF_x_box3F_C(const F32* m, F32* min, F32* max)
 {
     // Algorithm for axis aligned bounding box adapted from
     //  Graphic Gems I, pp 548-550
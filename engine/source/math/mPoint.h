@@ -15,6 +15,13 @@
 #include "platform/platform.h"
 #endif
 
+// x87 builds compute F64 math at a different precision, so the SSE2 Point3D code
+// would not match them; only use it where the compiler does scalar math in SSE2 too.
+#if defined(TORQUE_SIMD_POINT3D) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TORQUE_POINT3D_SSE2
+#include <emmintrin.h>
+#endif
+
 //------------------------------------------------------------------------------
 /// 2D integer point
 ///
@@ -424,6 +431,37 @@ public:
     Point3D operator-() const;
 };
 
+#ifdef TORQUE_POINT3D_SSE2
+/// @name Point3D SSE2 helpers
+///
+/// x and y travel together in one register, z in the low lane of a second one.
+/// Every operation is done lane by lane in the same order as the scalar code,
+/// so the results match it exactly.
+/// @{
+
+inline void m_point3D_load(const Point3D& p, __m128d& xy, __m128d& z)
+{
+    xy = _mm_loadu_pd(&p.x);
+    z = _mm_load_sd(&p.z);
+}
+
+inline void m_point3D_store(Point3D& p, const __m128d xy, const __m128d z)
+{
+    _mm_storeu_pd(&p.x, xy);
+    _mm_store_sd(&p.z, z);
+}
+
+/// Returns (a.x * b.x + a.y * b.y) + a.z * b.z in the low lane.
+inline __m128d m_point3D_dot(const __m128d axy, const __m128d az, const __m128d bxy, const __m128d bz)
+{
+    __m128d xy = _mm_mul_pd(axy, bxy);
+    __m128d sum = _mm_add_sd(xy, _mm_unpackhi_pd(xy, xy));
+    return _mm_add_sd(sum, _mm_mul_sd(az, bz));
+}
+
+/// @}
+#endif
+
 
 
 //------------------------------------------------------------------------------
@@ -1225,9 +1263,8 @@ inline Point3F::Point3F(const Point3F& _copy)
 }
 
 inline Point3F::Point3F(const Point3D& _copy)
-    : x(_copy.x), y(_copy.y), z(_copy.z)
 {
-    //
+    *this = _copy;
 }
 
 
@@ -1490,9 +1527,14 @@ inline Point3F Point3F::operator-() const
 
 inline Point3F& Point3F::operator=(const Point3D& _vec)
 {
+#ifdef TORQUE_POINT3D_SSE2
+    _mm_storel_pi(reinterpret_cast<__m64*>(&x), _mm_cvtpd_ps(_mm_loadu_pd(&_vec.x)));
+    _mm_store_ss(&z, _mm_cvtsd_ss(_mm_setzero_ps(), _mm_load_sd(&_vec.z)));
+#else
     x = _vec.x;
     y = _vec.y;
     z = _vec.z;
+#endif
     return *this;
 }
 
@@ -1520,9 +1562,15 @@ inline Point3D::Point3D(const Point3D& _copy)
 }
 
 inline Point3D::Point3D(const Point3F& _copy)
-    : x(_copy.x), y(_copy.y), z(_copy.z)
 {
-    //
+#ifdef TORQUE_POINT3D_SSE2
+    __m128 f = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&_copy.x));
+    m_point3D_store(*this, _mm_cvtps_pd(f), _mm_cvtss_sd(_mm_setzero_pd(), _mm_load_ss(&_copy.z)));
+#else
+    x = _copy.x;
+    y = _copy.y;
+    z = _copy.z;
+#endif
 }
 
 inline Point3D::Point3D(const F64 _x, const F64 _y, const F64 _z)
@@ -1592,13 +1640,26 @@ inline void Point3D::convolveInverse(const Point3D& c)
 
 inline F64 Point3D::lenSquared() const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d xy, vz;
+    m_point3D_load(*this, xy, vz);
+    return _mm_cvtsd_f64(m_point3D_dot(xy, vz, xy, vz));
+#else
     return (x * x) + (y * y) + (z * z);
+#endif
 }
 
 
 inline F64 Point3D::len() const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d xy, vz;
+    m_point3D_load(*this, xy, vz);
+    __m128d sq = m_point3D_dot(xy, vz, xy, vz);
+    return _mm_cvtsd_f64(_mm_sqrt_sd(sq, sq));
+#else
     return mSqrtD(x * x + y * y + z * z);
+#endif
 }
 
 
@@ -1626,13 +1687,31 @@ inline bool Point3D::operator!=(const Point3D& _test) const
 
 inline Point3D Point3D::operator+(const Point3D& _add) const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d axy, az, bxy, bz;
+    m_point3D_load(*this, axy, az);
+    m_point3D_load(_add, bxy, bz);
+    Point3D ret;
+    m_point3D_store(ret, _mm_add_pd(axy, bxy), _mm_add_sd(az, bz));
+    return ret;
+#else
     return Point3D(x + _add.x, y + _add.y, z + _add.z);
+#endif
 }
 
 
 inline Point3D Point3D::operator-(const Point3D& _rSub) const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d axy, az, bxy, bz;
+    m_point3D_load(*this, axy, az);
+    m_point3D_load(_rSub, bxy, bz);
+    Point3D ret;
+    m_point3D_store(ret, _mm_sub_pd(axy, bxy), _mm_sub_sd(az, bz));
+    return ret;
+#else
     return Point3D(x - _rSub.x, y - _rSub.y, z - _rSub.z);
+#endif
 }
 
 inline Point3D& Point3D::operator+=(const F64 _add)
@@ -1646,9 +1725,16 @@ inline Point3D& Point3D::operator+=(const F64 _add)
 
 inline Point3D& Point3D::operator+=(const Point3D& _add)
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d axy, az, bxy, bz;
+    m_point3D_load(*this, axy, az);
+    m_point3D_load(_add, bxy, bz);
+    m_point3D_store(*this, _mm_add_pd(axy, bxy), _mm_add_sd(az, bz));
+#else
     x += _add.x;
     y += _add.y;
     z += _add.z;
+#endif
 
     return *this;
 }
@@ -1665,9 +1751,16 @@ inline Point3D& Point3D::operator-=(const F64 _rSub)
 
 inline Point3D& Point3D::operator-=(const Point3D& _rSub)
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d axy, az, bxy, bz;
+    m_point3D_load(*this, axy, az);
+    m_point3D_load(_rSub, bxy, bz);
+    m_point3D_store(*this, _mm_sub_pd(axy, bxy), _mm_sub_sd(az, bz));
+#else
     x -= _rSub.x;
     y -= _rSub.y;
     z -= _rSub.z;
+#endif
 
     return *this;
 }
@@ -1692,12 +1785,30 @@ inline Point3D Point3D::operator-(const F64 _rSub) const
 
 inline Point3D Point3D::operator*(const F64 _mul) const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d xy, vz;
+    m_point3D_load(*this, xy, vz);
+    const __m128d mul = _mm_set1_pd(_mul);
+    Point3D ret;
+    m_point3D_store(ret, _mm_mul_pd(xy, mul), _mm_mul_sd(vz, mul));
+    return ret;
+#else
     return Point3D(x * _mul, y * _mul, z * _mul);
+#endif
 }
 
 inline Point3D Point3D::operator*(const Point3D& _vec) const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d axy, az, bxy, bz;
+    m_point3D_load(*this, axy, az);
+    m_point3D_load(_vec, bxy, bz);
+    Point3D ret;
+    m_point3D_store(ret, _mm_mul_pd(axy, bxy), _mm_mul_sd(az, bz));
+    return ret;
+#else
     return Point3D(x * _vec.x, y * _vec.y, z * _vec.z);
+#endif
 }
 
 
@@ -1707,15 +1818,22 @@ inline Point3D Point3D::operator/(const F64 _div) const
 
     F64 inv = 1.0f / _div;
 
-    return Point3D(x * inv, y * inv, z * inv);
+    return *this * inv;
 }
 
 
 inline Point3D& Point3D::operator*=(const F64 _mul)
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d xy, vz;
+    m_point3D_load(*this, xy, vz);
+    const __m128d mul = _mm_set1_pd(_mul);
+    m_point3D_store(*this, _mm_mul_pd(xy, mul), _mm_mul_sd(vz, mul));
+#else
     x *= _mul;
     y *= _mul;
     z *= _mul;
+#endif
 
     return *this;
 }
@@ -1726,22 +1844,27 @@ inline Point3D& Point3D::operator/=(const F64 _div)
     AssertFatal(_div != 0.0, "Error, div by zero attempted");
 
     F64 inv = 1.0 / _div;
-    x *= inv;
-    y *= inv;
-    z *= inv;
-
-    return *this;
+    return *this *= inv;
 }
 
 
 inline Point3D Point3D::operator-() const
 {
+#ifdef TORQUE_POINT3D_SSE2
+    __m128d xy, vz;
+    m_point3D_load(*this, xy, vz);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    Point3D ret;
+    m_point3D_store(ret, _mm_xor_pd(xy, sign), _mm_xor_pd(vz, sign));
+    return ret;
+#else
     return Point3D(-x, -y, -z);
+#endif
 }
 
 inline Point3F Point3D::toPoint3F() const
 {
-    return Point3F(x, y, z);
+    return Point3F(*this);
 }
 
 //------------------------------------------------------------------------------
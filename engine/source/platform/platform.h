@@ -260,9 +260,12 @@ enum x86Properties
     CPU_PROP_MMX = (1 << 2),     // Integer-SIMD
     CPU_PROP_3DNOW = (1 << 3),     // AMD Float-SIMD
     CPU_PROP_SSE = (1 << 4),     // PentiumIII SIMD
-    CPU_PROP_RDTSC = (1 << 5)     // Read Time Stamp Counter
- //   CPU_PROP_SSE2      = (1<<6),   // Pentium4 SIMD
+    CPU_PROP_RDTSC = (1 << 5),     // Read Time Stamp Counter
+    CPU_PROP_SSE2 = (1 << 6),     // Pentium4 SIMD
  //   CPU_PROP_MP        = (1<<7)      // Multi-processor system
+    CPU_PROP_AVX = (1 << 8),     // 256 bit Float-SIMD (CPU and OS support)
+    CPU_PROP_FMA = (1 << 9),     // Fused multiply-add (FMA3)
+    CPU_PROP_SSSE3 = (1 << 10)   // Byte shuffles
 };
 
 enum PPCProperties
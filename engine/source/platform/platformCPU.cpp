@@ -7,15 +7,121 @@
 #include "platform/platform.h"
 #include "core/stringTable.h"
 
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#  if defined(TORQUE_COMPILER_VISUALC)
+#     include <intrin.h>
+#     define TORQUE_HAS_CPUID_INTRINSICS
+#  elif defined(TORQUE_COMPILER_GCC)
+#     include <cpuid.h>
+#     define TORQUE_HAS_CPUID_INTRINSICS
+#  endif
+#endif
+
 enum CPUFlags
 {
     BIT_FPU = BIT(0),
     BIT_RDTSC = BIT(4),
     BIT_MMX = BIT(23),
     BIT_SSE = BIT(25),
+    BIT_SSE2 = BIT(26),
     BIT_3DNOW = BIT(31),
 };
 
+enum CPUExtendedFlags
+{  // cpuid leaf 1, ecx
+    BIT_SSSE3 = BIT(9),
+    BIT_FMA = BIT(12),
+    BIT_OSXSAVE = BIT(27),
+    BIT_AVX = BIT(28),
+};
+
+#if defined(TORQUE_HAS_CPUID_INTRINSICS)
+static void cpuid(U32 leaf, U32 regs[4])
+{
+#if defined(TORQUE_COMPILER_VISUALC)
+    __cpuid(reinterpret_cast<int*>(regs), leaf);
+#else
+    __cpuid(leaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/// Returns the low word of XCR0, which tells which register sets the OS saves on a context switch.
+static U32 getXCR0()
+{
+#if defined(TORQUE_COMPILER_VISUALC)
+    return U32(_xgetbv(0));
+#else
+    U32 lo, hi;
+    asm volatile("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+    return lo;
+#endif
+}
+#endif
+
+/// Fills in the same values as the detectX86CPUInfo asm routine, using the
+/// compiler's cpuid intrinsics.  Returns false if they are not available.
+bool GetX86CPUInfo(char* vendor, U32* processor, U32* properties)
+{
+#if defined(TORQUE_HAS_CPUID_INTRINSICS)
+    U32 regs[4];
+    cpuid(0, regs);
+    U32 maxLeaf = regs[0];
+    dMemcpy(vendor + 0, &regs[1], 4);   // ebx
+    dMemcpy(vendor + 4, &regs[3], 4);   // edx
+    dMemcpy(vendor + 8, &regs[2], 4);   // ecx
+    vendor[12] = 0;
+
+    *processor = 0;
+    *properties = 0;
+    if (maxLeaf >= 1)
+    {
+        cpuid(1, regs);
+        *processor = regs[0] & 0x0ff0;
+        *properties = regs[3];
+    }
+
+    cpuid(0x80000000, regs);
+    if (regs[0] > 0x80000000)
+    {
+        cpuid(0x80000001, regs);
+        *properties |= regs[3] & BIT_3DNOW;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Adds the extensions that SetProcessorInfo() does not know about (SSE2, AVX
+/// and FMA).  AVX is only reported when the OS also saves the YMM registers.
+void SetProcessorExtensions(Platform::SystemInfo_struct::Processor& pInfo)
+{
+#if defined(TORQUE_HAS_CPUID_INTRINSICS)
+    U32 regs[4];
+    cpuid(0, regs);
+    if (regs[0] < 1)
+        return;
+
+    cpuid(1, regs);
+    const U32 ecx = regs[2];
+    const U32 edx = regs[3];
+
+    if (edx & BIT_SSE)
+        pInfo.properties |= CPU_PROP_SSE;
+    if (edx & BIT_SSE2)
+        pInfo.properties |= CPU_PROP_SSE2;
+    if (ecx & BIT_SSSE3)
+        pInfo.properties |= CPU_PROP_SSSE3;
+
+    if ((ecx & BIT_AVX) && (ecx & BIT_OSXSAVE) && (getXCR0() & 0x6) == 0x6)
+    {
+        pInfo.properties |= CPU_PROP_AVX;
+        if (ecx & BIT_FMA)
+            pInfo.properties |= CPU_PROP_FMA;
+    }
+#endif
+}
+
 // fill the specified structure with information obtained from asm code
 void SetProcessorInfo(Platform::SystemInfo_struct::Processor& pInfo,
     char* vendor, U32 processor, U32 properties)
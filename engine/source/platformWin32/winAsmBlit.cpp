@@ -332,4 +332,6 @@ void PlatformBlitInit()
 #endif
     }
     //   terrMipBlit = terrMipBlit_asm;
+
+    bitmapInstall_SSE(Platform::SystemInfo.processor.properties);
 }
@@ -13,6 +13,8 @@ Platform::SystemInfo_struct Platform::SystemInfo;
 extern void PlatformBlitInit();
 extern void SetProcessorInfo(Platform::SystemInfo_struct::Processor& pInfo,
     char* vendor, U32 processor, U32 properties); // platform/platformCPU.cc
+extern bool GetX86CPUInfo(char* vendor, U32* processor, U32* properties);
+extern void SetProcessorExtensions(Platform::SystemInfo_struct::Processor& pInfo);
 
 
 #if defined(TORQUE_SUPPORTS_NASM)
@@ -101,9 +103,12 @@ void Processor::init()
     }
 #elif defined(TORQUE_SUPPORTS_NASM)
     detectX86CPUInfo(vendor, &processor, &properties);
+#else
+    GetX86CPUInfo(vendor, &processor, &properties);
 #endif
 
     SetProcessorInfo(Platform::SystemInfo.processor, vendor, processor, properties);
+    SetProcessorExtensions(Platform::SystemInfo.processor);
 
     // now calculate speed of processor...
     U16 nearmhz = 0; // nearest rounded mhz
@@ -234,6 +239,14 @@ void Processor::init()
         Con::printf("   3DNow detected");
     if (Platform::SystemInfo.processor.properties & CPU_PROP_SSE)
         Con::printf("   SSE detected");
+    if (Platform::SystemInfo.processor.properties & CPU_PROP_SSE2)
+        Con::printf("   SSE2 detected");
+    if (Platform::SystemInfo.processor.properties & CPU_PROP_SSSE3)
+        Con::printf("   SSSE3 detected");
+    if (Platform::SystemInfo.processor.properties & CPU_PROP_AVX)
+        Con::printf("   AVX detected");
+    if (Platform::SystemInfo.processor.properties & CPU_PROP_FMA)
+        Con::printf("   FMA detected");
     Con::printf(" ");
 
     PlatformBlitInit();
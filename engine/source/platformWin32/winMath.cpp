@@ -14,6 +14,7 @@ extern void mInstallLibrary_ASM();
 
 extern void mInstall_AMD_Math();
 extern void mInstall_Library_SSE();
+extern void mInstall_Library_AVX();
 
 
 //--------------------------------------
@@ -25,7 +26,8 @@ ConsoleFunction(mathInit, void, 1, 10, "( ... )"
     "    - 'FPU' Enable floating point unit routines.\n"
     "    - 'MMX' Enable MMX math routines.\n"
     "    - '3DNOW' Enable 3dNow! math routines.\n"
-    "    - 'SSE' Enable SSE math routines.\n")
+    "    - 'SSE' Enable SSE math routines.\n"
+    "    - 'AVX' Enable AVX/FMA math routines. These are never picked by 'DETECT'.\n")
 
 
 {
@@ -62,6 +64,10 @@ ConsoleFunction(mathInit, void, 1, 10, "( ... )"
             properties |= CPU_PROP_SSE;
             continue;
         }
+        if (dStricmp(*argv, "AVX") == 0) {
+            properties |= CPU_PROP_AVX | CPU_PROP_FMA;
+            continue;
+        }
         Con::printf("Error: MathInit(): ignoring unknown math extension '%s'", *argv);
     }
     Math::init(properties);
@@ -73,8 +79,9 @@ ConsoleFunction(mathInit, void, 1, 10, "( ... )"
 void Math::init(U32 properties)
 {
     if (!properties)
-        // detect what's available
-        properties = Platform::SystemInfo.processor.properties;
+        // detect what's available, the AVX/FMA kernels round differently
+        // from the C and SSE ones so they have to be asked for by name
+        properties = Platform::SystemInfo.processor.properties & ~(CPU_PROP_AVX | CPU_PROP_FMA);
     else
         // Make sure we're not asking for anything that's not supported
         properties &= Platform::SystemInfo.processor.properties;
@@ -107,6 +114,13 @@ void Math::init(U32 properties)
         mInstall_Library_SSE();
     }
 
+    // AVX kernels use FMA throughout, so only install them with both present.
+    if ((properties & CPU_PROP_AVX) && (properties & CPU_PROP_FMA))
+    {
+        Con::printf("   Installing AVX/FMA extensions");
+        mInstall_Library_AVX();
+    }
+
     Con::printf(" ");
 }
 
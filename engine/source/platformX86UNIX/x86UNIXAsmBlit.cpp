@@ -47,4 +47,6 @@ void PlatformBlitInit()
       // JMQ: haven't bothered porting mmx bitmap funcs because they don't
       // seem to offer a big performance boost right now.
    }
+
+   bitmapInstall_SSE(Platform::SystemInfo.processor.properties);
 }
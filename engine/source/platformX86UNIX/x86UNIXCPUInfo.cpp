@@ -16,6 +16,8 @@ Platform::SystemInfo_struct Platform::SystemInfo;
 extern void PlatformBlitInit();
 extern void SetProcessorInfo(Platform::SystemInfo_struct::Processor& pInfo,
    char* vendor, U32 processor, U32 properties); // platform/platformCPU.cc
+extern bool GetX86CPUInfo(char* vendor, U32* processor, U32* properties);
+extern void SetProcessorExtensions(Platform::SystemInfo_struct::Processor& pInfo);
 
 // asm cpu detection routine from platform code
 extern "C"
@@ -46,8 +48,10 @@ void Processor::init()
    dStrcpy(vendor, "");
 
    //detectX86CPUInfo(vendor, &processor, &properties);
+   GetX86CPUInfo(vendor, &processor, &properties);
    SetProcessorInfo(Platform::SystemInfo.processor,
       vendor, processor, properties);
+   SetProcessorExtensions(Platform::SystemInfo.processor);
 
    //--------------------------------------
    // if RDTSC support calculate the aproximate Mhz of the CPU
@@ -114,6 +118,14 @@ void Processor::init()
       Con::printf("   3DNow detected");
    if (Platform::SystemInfo.processor.properties & CPU_PROP_SSE)
       Con::printf("   SSE detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_SSE2)
+      Con::printf("   SSE2 detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_SSSE3)
+      Con::printf("   SSSE3 detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_AVX)
+      Con::printf("   AVX detected");
+   if (Platform::SystemInfo.processor.properties & CPU_PROP_FMA)
+      Con::printf("   FMA detected");
    Con::printf(" ");
 
    PlatformBlitInit();
@@ -16,10 +16,11 @@ extern void mInstallLibrary_ASM();
 
 extern void mInstall_AMD_Math();
 extern void mInstall_Library_SSE();
+extern void mInstall_Library_AVX();
 
 
 //--------------------------------------
-ConsoleFunction( MathInit, void, 1, 10, "(detect|C|FPU|MMX|3DNOW|SSE|...)")
+ConsoleFunction( MathInit, void, 1, 10, "(detect|C|FPU|MMX|3DNOW|SSE|AVX|...)")
 {
    U32 properties = CPU_PROP_C;  // C entensions are always used
 
@@ -54,6 +55,10 @@ ConsoleFunction( MathInit, void, 1, 10, "(detect|C|FPU|MMX|3DNOW|SSE|...)")
          properties |= CPU_PROP_SSE;
          continue;
       }
+      if (dStricmp(*argv, "AVX") == 0) {
+         properties |= CPU_PROP_AVX | CPU_PROP_FMA;
+         continue;
+      }
       Con::printf("Error: MathInit(): ignoring unknown math extension '%s'", *argv);
    }
    Math::init(properties);
@@ -65,8 +70,9 @@ ConsoleFunction( MathInit, void, 1, 10, "(detect|C|FPU|MMX|3DNOW|SSE|...)")
 void Math::init(U32 properties)
 {
    if (!properties)
-      // detect what's available
-      properties = Platform::SystemInfo.processor.properties;
+      // detect what's available, the AVX/FMA kernels round differently
+      // from the C and SSE ones so they have to be asked for by name
+      properties = Platform::SystemInfo.processor.properties & ~(CPU_PROP_AVX | CPU_PROP_FMA);
    else
       // Make sure we're not asking for anything that's not supported
       properties &= Platform::SystemInfo.processor.properties;
@@ -99,6 +105,13 @@ void Math::init(U32 properties)
       Con::printf("   Installing SSE extensions");
       mInstall_Library_SSE();
    }
+
+   // AVX kernels use FMA throughout, so only install them with both present.
+   if ((properties & CPU_PROP_AVX) && (properties & CPU_PROP_FMA))
+   {
+      Con::printf("   Installing AVX/FMA extensions");
+      mInstall_Library_AVX();
+   }
 #endif //mwerks>2.4
 
    Con::printf(" ");
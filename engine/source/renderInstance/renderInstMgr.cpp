@@ -326,10 +326,6 @@ void RenderInstManager::sort()
 //-----------------------------------------------------------------------------
 void RenderInstManager::clear()
 {
-    mRIAllocator.clear();
-    mXformAllocator.clear();
-    mPrimitiveFirstPassAllocator.clear();
-
     if (mRenderBins.size())
     {
         for (U32 i = 0; i < NumRenderBins; i++)
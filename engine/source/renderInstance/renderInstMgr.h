@@ -19,6 +19,10 @@
 
 #include "sceneGraph/lightInfo.h"
 
+#ifndef _FRAMEARENA_H_
+#include "core/frameArena.h"
+#endif
+
 class MatInstance;
 class SceneGraphData;
 class ShaderData;
@@ -161,14 +165,11 @@ private:
     //-------------------------------------
     // data
     //-------------------------------------
-    Chunker< RenderInst >      mRIAllocator;
-    Chunker< MatrixF >         mXformAllocator;
+    // RenderInsts, transforms and lighting pass flags all come from the
+    // FrameArena and go away together at the end of the frame.
     Vector< RenderElemMgr* >  mRenderBins;
     Vector<bool> mRenderRenderBin;
 
-    // for lighting passes...
-    Chunker<bool>         mPrimitiveFirstPassAllocator;
-
     bool mInitialized;
     ShaderData* mBlankShader;
     MatInstance* mWarningMat;
@@ -192,18 +193,18 @@ public:
 
     RenderInst* allocInst()
     {
-        RenderInst* inst = mRIAllocator.alloc();
+        RenderInst* inst = FrameArena::get()->alloc<RenderInst>();
         inst->clear();
         return inst;
     }
     void addInst(RenderInst* inst);
-    MatrixF* allocXform() { return mXformAllocator.alloc(); }
+    MatrixF* allocXform() { return FrameArena::get()->alloc<MatrixF>(); }
 
     // for lighting...
-    bool* allocPrimitiveFirstPass() { return mPrimitiveFirstPassAllocator.alloc(); }
+    bool* allocPrimitiveFirstPass() { return FrameArena::get()->alloc<bool>(); }
 
     void uninit();
-    void clear();  // clear instances, matrices
+    void clear();  // clear bins, instances and matrices are freed at end of frame
     void sort();
     void render();
     void renderToZBuff(GFXTarget* target);
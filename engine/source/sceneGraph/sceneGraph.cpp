@@ -150,7 +150,7 @@ void SceneGraph::renderScene(const U32 objectMask)
     GFX->getFrustum(&left, &right, &bottom, &top, &nearPlane, &farPlane);
     viewport = GFX->getViewport();
 
-    SceneState* pBaseState = new SceneState(NULL,
+    SceneState* pBaseState = new(FrameArena::get()->alloc<SceneState>()) SceneState(NULL,
         mCurrZoneEnd,
         left, right,
         bottom, top,
@@ -205,7 +205,7 @@ void SceneGraph::renderScene(const U32 objectMask)
     //PROFILE_END();
 
 
-    delete pBaseState;
+    destructInPlace(pBaseState);
     PROFILE_END();
 }
 
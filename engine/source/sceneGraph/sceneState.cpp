@@ -100,7 +100,7 @@ SceneState::~SceneState()
 {
     U32 i;
     for (i = 0; i < mSubsidiaries.size(); i++)
-        delete mSubsidiaries[i];
+        destructInPlace(mSubsidiaries[i]);
 }
 
 void SceneState::setPortal(SceneObject* owner, const U32 index)
@@ -313,7 +313,7 @@ bool SceneState::isObjectRendered(const SceneObject* obj)
 //--------------------------------------------------------------------------
 //--------------------------------------
 
-bool checkFogBandBoxVisible(F32 dist, F32 haze, F32 low, F32 high, Vector<SceneState::FogBand>& fb)
+bool checkFogBandBoxVisible(F32 dist, F32 haze, F32 low, F32 high, FrameVector<SceneState::FogBand>& fb)
 {
     // if there are no fog bands, no fog - it's visible
     if (!fb.size())
@@ -526,7 +526,7 @@ void SceneState::setupFog()
 void SceneState::getFogs(float dist, float deltaZ, ColorF* array, U32& numFogs)
 {
     numFogs = 0;
-    Vector<FogBand>* band;
+    FrameVector<FogBand>* band;
     if (deltaZ < 0)
     {
         deltaZ = -deltaZ;
@@ -562,7 +562,7 @@ void SceneState::getFogs(float dist, float deltaZ, ColorF* array, U32& numFogs)
 F32 SceneState::getFog(float dist, float deltaZ, S32 volKey)
 {
     float haze = 0;
-    Vector<FogBand>* band;
+    FrameVector<FogBand>* band;
     if (deltaZ < 0)
     {
         deltaZ = -deltaZ;
@@ -595,7 +595,7 @@ F32 SceneState::getFog(float dist, float deltaZ, S32 volKey)
 F32 SceneState::getFog(float dist, float deltaZ)
 {
     float haze = 0;
-    Vector<FogBand>* band;
+    FrameVector<FogBand>* band;
     if (deltaZ < 0)
     {
         deltaZ = -deltaZ;
@@ -636,7 +636,7 @@ F32 SceneState::getHazeAndFog(float dist, float deltaZ)
         haze = 1.0 - distFactor * distFactor;
     }
 
-    Vector<FogBand>* band;
+    FrameVector<FogBand>* band;
     if (deltaZ < 0)
     {
         deltaZ = -deltaZ;
@@ -21,6 +21,9 @@
 #ifndef _COLOR_H_
 #include "core/color.h"
 #endif
+#ifndef _FRAMEARENA_H_
+#include "core/frameArena.h"
+#endif
 
 class SceneObject;
 class InteriorInstance;
@@ -35,6 +38,9 @@ struct FogVolume;
 /// of the information that objects need to render properly with regard to the
 /// camera position, any fog information, viewing frustum, the global environment
 /// map for reflections, viewable distance and portal information.
+///
+/// SceneStates only live for the frame they are rendered in.  They, and all of
+/// their zone, portal and fog lists, are allocated from the FrameArena.
 class SceneState
 {
     friend class SceneGraph;
@@ -235,22 +241,22 @@ public:
     F32 getHaze(F32 dist);
 
 private:
-    Vector<ZoneState>         mZoneStates;             ///< Collection of ZoneStates in the scene.
+    FrameVector<ZoneState>    mZoneStates;             ///< Collection of ZoneStates in the scene.
 
     /// Builds the BSP tree of translucent images.
     void buildTranslucentBSP();
 
     bool mTerrainOverride;                             ///< If true, terrain is allowed to render inside interiors
 
-    Vector<SceneState*>       mSubsidiaries;           ///< Transform portals which have been processed by the scene traversal process
+    FrameVector<SceneState*>  mSubsidiaries;           ///< Transform portals which have been processed by the scene traversal process
                                                        ///
                                                        ///  @note Closely related.  Transform portals are turned into sorted mSubsidiaries
                                                        ///        by the traversal process...
 
-    Vector<TransformPortal>   mTransformPortals;       ///< Collection of TransformPortals
+    FrameVector<TransformPortal> mTransformPortals;      ///< Collection of TransformPortals
 
-    Vector<FogBand> mPosFogBands;                      ///< Fog bands above the world plane
-    Vector<FogBand> mNegFogBands;                      ///< Fog bands below the world plane
+    FrameVector<FogBand> mPosFogBands;                      ///< Fog bands above the world plane
+    FrameVector<FogBand> mNegFogBands;                      ///< Fog bands below the world plane
 
     ZoneState mBaseZoneState;                          ///< ZoneState of the base zone of the scene
     Point3F   mCamPosition;                            ///< Camera position in this state
@@ -273,7 +279,7 @@ private:
     U32 mNumFogVolumes;                                ///< Number of fog volumes in the scene
     FogVolume* mFogVolumes;                            ///< Pointer to the array of fog volumes in the scene
 
-    Vector< InteriorListElem > mInteriorList;
+    FrameVector< InteriorListElem > mInteriorList;
 
 
 public:
@@ -281,10 +287,10 @@ public:
     MatrixF mModelview;                                ///< Modelview matrix this scene is based off of
 
     /// Returns the fog bands above the world plane
-    Vector<FogBand>* getPosFogBands() { return &mPosFogBands; }
+    FrameVector<FogBand>* getPosFogBands() { return &mPosFogBands; }
 
     /// Returns the fog bands below the world planes
-    Vector<FogBand>* getNegFogBands() { return &mNegFogBands; }
+    FrameVector<FogBand>* getNegFogBands() { return &mNegFogBands; }
 
     void insertInterior(InteriorListElem& elem)
     {
@@ -14,8 +14,20 @@
 
 #include "interior/interiorInstance.h"
 
+#if defined(TORQUE_CPU_X86) || defined(TORQUE_CPU_X64)
+#include <xmmintrin.h>
+#define TORQUE_SCENE_CULL_SSE
+#endif
+
 namespace {
 
+    /// Gathers the objects returned by the container query and culls them in
+    /// batches of four against the view distance, fog and the view frustum.
+    ///
+    /// Candidates are kept in the order the container returned them, and the
+    /// tests are the same ones the old per-object path did (closest point
+    /// distance, SceneState::isBoxFogVisible, PlaneF::whichSideBox on the
+    /// render-transformed object box), so the resulting list is identical.
     class PotentialRenderList
     {
     public:
@@ -27,14 +39,20 @@ namespace {
         F32     viewDistSquared;
         Box3F   mBox;
 
-        Vector<SceneObject*> mList;
+        FrameVector<SceneObject*> mCandidates;
+        FrameVector<SceneObject*> mList;
 
         PlaneF viewPlanes[5];
         SceneState* mState;
 
     public:
-        void insertObject(SceneObject* obj);
+        void insertCandidate(SceneObject* obj) { mCandidates.push_back(obj); }
+        void cullCandidates();
         void setupClipPlanes(SceneState*);
+
+    private:
+        U32  cullByDistance(SceneObject** objs, const U32 count, F32* lenSquared, U32* survivors);
+        void cullByFrustum(SceneObject** objs, const U32 count);
     };
 
     // MM/JF: Added for mirrorSubObject fix.
@@ -66,66 +84,245 @@ namespace {
         sgOrientClipPlanes(&viewPlanes[0], camPos, farPosLeftUp, farPosLeftDown, farPosRightUp, farPosRightDown);
     }
 
-
-    void PotentialRenderList::insertObject(SceneObject* obj)
+    /// First pass: distance from the camera to the closest point of each world
+    /// box.  Writes the indices of the objects within view distance to
+    /// @a survivors (in order) and returns how many there are.
+    U32 PotentialRenderList::cullByDistance(SceneObject** objs, const U32 count, F32* lenSquared, U32* survivors)
     {
-        // Check to see if we need to render always.
-        if (obj->isGlobalBounds())
+        const U32 padded = (count + 3) & ~3;
+
+        // SoA copies of the world boxes.
+        FrameArena* arena = FrameArena::get();
+        F32* soa = arena->allocArray<F32>(padded * 6);
+        F32* minX = soa;
+        F32* minY = soa + padded;
+        F32* minZ = soa + padded * 2;
+        F32* maxX = soa + padded * 3;
+        F32* maxY = soa + padded * 4;
+        F32* maxZ = soa + padded * 5;
+
+        U32 i;
+        for (i = 0; i < count; i++)
         {
-            mList.push_back(obj);
-            return;
+            const Box3F& box = objs[i]->getWorldBox();
+            minX[i] = box.min.x; minY[i] = box.min.y; minZ[i] = box.min.z;
+            maxX[i] = box.max.x; maxY[i] = box.max.y; maxZ[i] = box.max.z;
+        }
+        for (; i < padded; i++)
+        {
+            minX[i] = minY[i] = minZ[i] = 0.0f;
+            maxX[i] = maxY[i] = maxZ[i] = 0.0f;
         }
 
-        const Box3F& rObjBox = obj->getObjBox();
-        const Point3F& rScale = obj->getScale();
+        U32 numSurvivors = 0;
 
-        Point3F center;
-        rObjBox.getCenter(&center);
-        center.convolve(rScale);
+#ifdef TORQUE_SCENE_CULL_SSE
+        const __m128 camX = _mm_set1_ps(camPos.x);
+        const __m128 camY = _mm_set1_ps(camPos.y);
+        const __m128 camZ = _mm_set1_ps(camPos.z);
+        const __m128 viewDist = _mm_set1_ps(viewDistSquared);
 
-        Point3F xRad((rObjBox.max.x - rObjBox.min.x) * 0.5 * rScale.x, 0, 0);
-        Point3F yRad(0, (rObjBox.max.y - rObjBox.min.y) * 0.5 * rScale.y, 0);
-        Point3F zRad(0, 0, (rObjBox.max.z - rObjBox.min.z) * 0.5 * rScale.z);
+        for (i = 0; i < padded; i += 4)
+        {
+            // Clamp the camera into the box, same as Box3F::getClosestPoint.
+            __m128 dx = _mm_sub_ps(_mm_max_ps(_mm_load_ps(minX + i), _mm_min_ps(camX, _mm_load_ps(maxX + i))), camX);
+            __m128 dy = _mm_sub_ps(_mm_max_ps(_mm_load_ps(minY + i), _mm_min_ps(camY, _mm_load_ps(maxY + i))), camY);
+            __m128 dz = _mm_sub_ps(_mm_max_ps(_mm_load_ps(minZ + i), _mm_min_ps(camZ, _mm_load_ps(maxZ + i))), camZ);
 
-        obj->getRenderTransform().mulP(center);
-        obj->getRenderTransform().mulV(xRad);
-        obj->getRenderTransform().mulV(yRad);
-        obj->getRenderTransform().mulV(zRad);
+            __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            _mm_storeu_ps(lenSquared + i, lenSq);
 
-        bool render = true;
-        for (U32 i = 0; i < 5; i++)
-        {
-            if (viewPlanes[i].whichSideBox(center, xRad, yRad, zRad, Point3F(0, 0, 0)) == PlaneF::Back)
+            U32 mask = _mm_movemask_ps(_mm_cmplt_ps(lenSq, viewDist));
+            for (U32 lane = 0; mask != 0; lane++, mask >>= 1)
             {
-                render = false;
-                break;
+                if ((mask & 1) && i + lane < count)
+                    survivors[numSurvivors++] = i + lane;
             }
         }
+#else
+        for (i = 0; i < count; i++)
+        {
+            Point3F closestPt(getMax(minX[i], getMin(camPos.x, maxX[i])),
+                getMax(minY[i], getMin(camPos.y, maxY[i])),
+                getMax(minZ[i], getMin(camPos.z, maxZ[i])));
+            lenSquared[i] = (closestPt - camPos).lenSquared();
+            if (lenSquared[i] < viewDistSquared)
+                survivors[numSurvivors++] = i;
+        }
+#endif
 
-        if (render)
-            mList.push_back(obj);
+        return numSurvivors;
     }
 
-    void prlInsertionCallback(SceneObject* obj, void* key)
+    /// Second pass: oriented object boxes against the five view planes.
+    /// Survivors are appended to mList in order.
+    void PotentialRenderList::cullByFrustum(SceneObject** objs, const U32 count)
     {
-        PotentialRenderList* prList = (PotentialRenderList*)key;
+        const U32 padded = (count + 3) & ~3;
+
+        // SoA center and half axis vectors of the render-transformed object boxes.
+        FrameArena* arena = FrameArena::get();
+        F32* soa = arena->allocArray<F32>(padded * 12);
+        F32* c[3] = { soa, soa + padded, soa + padded * 2 };
+        F32* ax[3] = { soa + padded * 3, soa + padded * 4, soa + padded * 5 };
+        F32* ay[3] = { soa + padded * 6, soa + padded * 7, soa + padded * 8 };
+        F32* az[3] = { soa + padded * 9, soa + padded * 10, soa + padded * 11 };
+
+        U32 i;
+        for (i = 0; i < padded; i++)
+        {
+            Point3F center(0, 0, 0);
+            Point3F xRad(0, 0, 0);
+            Point3F yRad(0, 0, 0);
+            Point3F zRad(0, 0, 0);
 
-        if (obj->isGlobalBounds())
+            if (i < count)
+            {
+                SceneObject* obj = objs[i];
+                const Box3F& rObjBox = obj->getObjBox();
+                const Point3F& rScale = obj->getScale();
+
+                rObjBox.getCenter(&center);
+                center.convolve(rScale);
+
+                xRad.x = (rObjBox.max.x - rObjBox.min.x) * 0.5 * rScale.x;
+                yRad.y = (rObjBox.max.y - rObjBox.min.y) * 0.5 * rScale.y;
+                zRad.z = (rObjBox.max.z - rObjBox.min.z) * 0.5 * rScale.z;
+
+                obj->getRenderTransform().mulP(center);
+                obj->getRenderTransform().mulV(xRad);
+                obj->getRenderTransform().mulV(yRad);
+                obj->getRenderTransform().mulV(zRad);
+            }
+
+            c[0][i] = center.x;  c[1][i] = center.y;  c[2][i] = center.z;
+            ax[0][i] = xRad.x;   ax[1][i] = xRad.y;   ax[2][i] = xRad.z;
+            ay[0][i] = yRad.x;   ay[1][i] = yRad.y;   ay[2][i] = yRad.z;
+            az[0][i] = zRad.x;   az[1][i] = zRad.y;   az[2][i] = zRad.z;
+        }
+
+#ifdef TORQUE_SCENE_CULL_SSE
+        const __m128 zero = _mm_setzero_ps();
+
+        for (i = 0; i < padded; i += 4)
         {
-            prList->insertObject(obj);
-            return;
+            const __m128 cx = _mm_load_ps(c[0] + i), cy = _mm_load_ps(c[1] + i), cz = _mm_load_ps(c[2] + i);
+            const __m128 xx = _mm_load_ps(ax[0] + i), xy = _mm_load_ps(ax[1] + i), xz = _mm_load_ps(ax[2] + i);
+            const __m128 yx = _mm_load_ps(ay[0] + i), yy = _mm_load_ps(ay[1] + i), yz = _mm_load_ps(ay[2] + i);
+            const __m128 zx = _mm_load_ps(az[0] + i), zy = _mm_load_ps(az[1] + i), zz = _mm_load_ps(az[2] + i);
+
+            __m128 culled = _mm_setzero_ps();
+            for (U32 p = 0; p < 5; p++)
+            {
+                const __m128 px = _mm_set1_ps(viewPlanes[p].x);
+                const __m128 py = _mm_set1_ps(viewPlanes[p].y);
+                const __m128 pz = _mm_set1_ps(viewPlanes[p].z);
+                const __m128 pd = _mm_set1_ps(viewPlanes[p].d);
+
+                // PlaneF::whichSideBox
+                __m128 baseDist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)), _mm_mul_ps(pz, cz)), pd);
+                __m128 dotX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, px), _mm_mul_ps(xy, py)), _mm_mul_ps(xz, pz));
+                __m128 dotY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(yx, px), _mm_mul_ps(yy, py)), _mm_mul_ps(yz, pz));
+                __m128 dotZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(zx, px), _mm_mul_ps(zy, py)), _mm_mul_ps(zz, pz));
+                // mFabs as max(v, -v), which only needs SSE1.
+                __m128 absX = _mm_max_ps(dotX, _mm_sub_ps(zero, dotX));
+                __m128 absY = _mm_max_ps(dotY, _mm_sub_ps(zero, dotY));
+                __m128 absZ = _mm_max_ps(dotZ, _mm_sub_ps(zero, dotZ));
+                __m128 compDist = _mm_add_ps(_mm_add_ps(absX, absY), absZ);
+
+                // Back only if not Front first, so a flat box lying on the
+                // plane (both distances 0) is kept like the scalar test keeps it.
+                __m128 back = _mm_and_ps(_mm_cmplt_ps(baseDist, compDist), _mm_cmple_ps(baseDist, _mm_sub_ps(zero, compDist)));
+                culled = _mm_or_ps(culled, back);
+            }
+
+            U32 mask = _mm_movemask_ps(culled);
+            for (U32 lane = 0; lane < 4 && i + lane < count; lane++)
+            {
+                if ((mask & (1 << lane)) == 0)
+                    mList.push_back(objs[i + lane]);
+            }
+        }
+#else
+        for (i = 0; i < count; i++)
+        {
+            Point3F center(c[0][i], c[1][i], c[2][i]);
+            Point3F xRad(ax[0][i], ax[1][i], ax[2][i]);
+            Point3F yRad(ay[0][i], ay[1][i], ay[2][i]);
+            Point3F zRad(az[0][i], az[1][i], az[2][i]);
+
+            bool render = true;
+            for (U32 p = 0; p < 5; p++)
+            {
+                if (viewPlanes[p].whichSideBox(center, xRad, yRad, zRad, Point3F(0, 0, 0)) == PlaneF::Back)
+                {
+                    render = false;
+                    break;
+                }
+            }
+
+            if (render)
+                mList.push_back(objs[i]);
         }
+#endif
+    }
 
-        Point3F closestPt = obj->getWorldBox().getClosestPoint(prList->camPos);
-        F32 lenSquared = (closestPt - prList->camPos).lenSquared();
-        if (lenSquared >= prList->viewDistSquared)
+    void PotentialRenderList::cullCandidates()
+    {
+        const U32 count = mCandidates.size();
+        if (count == 0)
             return;
 
-        F32 len = mSqrt(lenSquared);
-        F32 top = obj->getWorldBox().max.z;
-        F32 bottom = obj->getWorldBox().min.z;
-        if (prList->mState->isBoxFogVisible(len, top, bottom))
-            prList->insertObject(obj);
+        FrameArena* arena = FrameArena::get();
+        F32* lenSquared = arena->allocArray<F32>((count + 3) & ~3);
+        U32* survivors = arena->allocArray<U32>(count);
+        SceneObject** frustumList = arena->allocArray<SceneObject*>(count);
+
+        U32 numSurvivors = cullByDistance(mCandidates.address(), count, lenSquared, survivors);
+
+        // Fog bands only ever hide boxes when there are fog volumes; without
+        // them SceneState::isBoxFogVisible always passes.
+        const bool checkFog = !mState->getPosFogBands()->empty() || !mState->getNegFogBands()->empty();
+
+        // Objects with global bounds skip culling entirely.  To keep the list
+        // in container order they are flushed whenever one comes up.
+        U32 numFrustum = 0;
+        U32 s = 0;
+        for (U32 i = 0; i < count; i++)
+        {
+            SceneObject* obj = mCandidates[i];
+            bool inRange = s < numSurvivors && survivors[s] == i;
+            if (inRange)
+                s++;
+
+            if (obj->isGlobalBounds())
+            {
+                cullByFrustum(frustumList, numFrustum);
+                numFrustum = 0;
+                mList.push_back(obj);
+                continue;
+            }
+
+            if (!inRange)
+                continue;
+
+            if (checkFog)
+            {
+                const Box3F& worldBox = obj->getWorldBox();
+                if (!mState->isBoxFogVisible(mSqrt(lenSquared[i]), worldBox.max.z, worldBox.min.z))
+                    continue;
+            }
+
+            frustumList[numFrustum++] = obj;
+        }
+
+        cullByFrustum(frustumList, numFrustum);
+    }
+
+    void prlInsertionCallback(SceneObject* obj, void* key)
+    {
+        PotentialRenderList* prList = (PotentialRenderList*)key;
+        prList->insertCandidate(obj);
     }
 
 } // namespace {}
@@ -207,6 +404,7 @@ void SceneGraph::buildSceneTree(SceneState* state,
     //  container without testing, since only the client will be calling this
     //  function.  This is assured by the assert at the top...
     getCurrentClientContainer()->findObjects(prl.mBox, objectMask, prlInsertionCallback, &prl);
+    prl.cullCandidates();
 
     // Clear the object colors
     U32 i;
@@ -256,7 +454,7 @@ void SceneGraph::buildSceneTree(SceneState* state,
                 continue;
             }
 
-            SceneState* newState = new SceneState(state,
+            SceneState* newState = new(FrameArena::get()->alloc<SceneState>()) SceneState(state,
                 mCurrZoneEnd,
                 newFrustum[0],
                 newFrustum[1],
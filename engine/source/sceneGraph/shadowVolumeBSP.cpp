@@ -6,6 +6,8 @@
 #include "sceneGraph/shadowVolumeBSP.h"
 #include "math/mPlane.h"
 
+static thread_local ShadowVolumeBSP::PolyStore* sgThreadPolyStore = NULL;
+
 ShadowVolumeBSP::ShadowVolumeBSP() :
     mSVRoot(0),
     mNodeStore(0),
@@ -278,7 +280,18 @@ ShadowVolumeBSP::SVPoly* ShadowVolumeBSP::createPoly()
 {
     SVPoly* poly;
 
-    if (mPolyStore)
+    if (sgThreadPolyStore)
+    {
+        PolyStore* store = sgThreadPolyStore;
+        if (store->mFree)
+        {
+            poly = store->mFree;
+            store->mFree = store->mFree->mNext;
+        }
+        else
+            poly = store->mChunker.alloc();
+    }
+    else if (mPolyStore)
     {
         poly = mPolyStore;
         mPolyStore = mPolyStore->mNext;
@@ -303,10 +316,22 @@ void ShadowVolumeBSP::recyclePoly(SVPoly* poly)
     recyclePoly(poly->mNext);
 
     //
+    if (sgThreadPolyStore)
+    {
+        poly->mNext = sgThreadPolyStore->mFree;
+        sgThreadPolyStore->mFree = poly;
+        return;
+    }
+
     poly->mNext = mPolyStore;
     mPolyStore = poly;
 }
 
+void ShadowVolumeBSP::setThreadPolyStore(PolyStore* store)
+{
+    sgThreadPolyStore = store;
+}
+
 U32 ShadowVolumeBSP::insertPlane(const PlaneF& plane)
 {
     mPlanes.push_back(plane);
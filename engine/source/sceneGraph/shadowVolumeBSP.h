@@ -108,6 +108,18 @@ public:
     SVPoly* createPoly();
     void recyclePoly(SVPoly*);
 
+    /// Poly allocator for a single thread.  While one is set for the
+    /// calling thread, createPoly() and recyclePoly() use it instead of
+    /// mPolyChunker and mPolyStore, so several threads can clip polys
+    /// against the same tree as long as none of them modifies it.
+    struct PolyStore
+    {
+        Chunker<SVPoly>   mChunker;
+        SVPoly* mFree;
+        PolyStore() : mFree(0) {}
+    };
+    static void setThreadPolyStore(PolyStore*);
+
     U32 insertPlane(const PlaneF&);
     const PlaneF& getPlane(U32) const;
 
@@ -146,6 +146,9 @@ static U32 gPacketUpdateDelayToServer = 32;
 static U32 gPacketRateToClient = 10;
 static U32 gPacketSize = 200;
 
+/// Weight of every notified packet in the running packet loss average.
+static const F32 PacketLossAverageWeight = 1.0f / 32.0f;
+
 void NetConnection::consoleInit()
 {
     Con::addVariable("pref::Net::PacketRateToServer", TypeS32, &gPacketRateToServer);
@@ -154,9 +157,7 @@ void NetConnection::consoleInit()
     Con::addVariable("Stats::netBitsSent", TypeS32, &gNetBitsSent);
     Con::addVariable("Stats::netBitsReceived", TypeS32, &gNetBitsReceived);
     Con::addVariable("Stats::netGhostUpdates", TypeS32, &gGhostUpdates);
-#ifdef TORQUE_FAST_FILE_TRANSFER
-    fastFileTransferInit();
-#endif
+    fileTransferInit();
 }
 
 void NetConnection::checkMaxRate()
@@ -291,6 +292,7 @@ NetConnection::NetConnection()
     mCurrentFileBufferSize = 0;
     mCurrentFileBufferOffset = 0;
     mNumDownloadedFiles = 0;
+    mLastFileProgressTime = 0;
 
 #ifdef TORQUE_FAST_FILE_TRANSFER
     initFastFile();
@@ -499,6 +501,9 @@ void NetConnection::handleNotify(bool recvd)
     else
         packetDropped(note);
 
+    // Running average of packet loss
+    mPacketLoss += ((recvd ? 0.0f : 1.0f) - mPacketLoss) * PacketLossAverageWeight;
+
     delete note;
 }
 
@@ -562,15 +567,20 @@ NetConnection::PacketNotify* NetConnection::allocNotify()
 /// sends the actual packet.
 class NetDelayEvent : public SimEvent
 {
-    U8 buffer[MaxPacketDataSize];
+    U8* buffer;
     BitStream stream;
 public:
     NetDelayEvent(BitStream* inStream) : stream(NULL, 0)
     {
+        buffer = PacketBufferPool::acquire();
         dMemcpy(buffer, inStream->getBuffer(), inStream->getPosition());
         stream.setBuffer(buffer, inStream->getPosition());
         stream.setPosition(inStream->getPosition());
     }
+    ~NetDelayEvent()
+    {
+        PacketBufferPool::release(buffer);
+    }
     void process(SimObject* object)
     {
         ((NetConnection*)object)->sendPacket(&stream);
@@ -597,7 +607,8 @@ void NetConnection::checkPacketSend(bool force)
     if (windowFull())
         return;
 
-    BitStream* stream = BitStream::getPacketStream(mCurRate.packetSize);
+    PacketStream packet(mCurRate.packetSize);
+    BitStream* stream = &packet;
     buildSendPacketHeader(stream);
 
     mLastUpdateTime = curTime;
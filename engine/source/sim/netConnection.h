@@ -985,6 +985,9 @@ protected:
     /// Error storage for file transfers.
     char mLastFileErrorBuffer[256];
 
+    /// Time of the last file transfer progress callback to script.
+    U32 mLastFileProgressTime;
+
 #ifdef TORQUE_FAST_FILE_TRANSFER
 
     struct FastFileState* mFastFileState;
@@ -1004,6 +1007,9 @@ public:
     /// Start sending the specified file over the link.
     bool startSendingFile(const char* fileName);
 
+    /// Register the file transfer prefs.
+    static void fileTransferInit();
+
 #ifdef TORQUE_FAST_FILE_TRANSFER
 
     static void fastFileTransferInit();
@@ -1038,6 +1044,11 @@ public:
     /// Called when we finish downloading file data.
     virtual void fileDownloadSegmentComplete();
 
+    /// Opens a file the other side asked for, closed with
+    /// ResourceManager->closeStream().  Subclasses can serve files that only
+    /// exist in memory.
+    virtual Stream* openFileForSending(const char* fileName);
+
     /// This is part of the file transfer logic; basically, we call this
     /// every time we finish downloading new files. It attempts to load
     /// the GhostAlways objects; if they fail, it marks an error and we
@@ -13,6 +13,26 @@
 #include "console/consoleTypes.h"
 #include "sim/netInterface.h"
 
+/// Shortest time between two onFileChunkSent / onFileChunkReceived callbacks
+/// of a connection, in ms.  The first and last one of a file always go out.
+static U32 FileProgressInterval = 250;
+
+/// Returns true if a script progress callback is due and notes that it went out.
+static bool isFileProgressDue(U32& lastProgressTime, bool force)
+{
+    U32 now = Platform::getRealMilliseconds();
+    if (!force && now - lastProgressTime < FileProgressInterval)
+        return false;
+
+    lastProgressTime = now;
+    return true;
+}
+
+#ifndef TORQUE_FAST_FILE_TRANSFER
+/// FileChunkEvents a connection keeps in transit while sending a file.
+static U32 FileChunkWindow = 32;
+#endif
+
 class FileDownloadRequestEvent : public NetEvent
 {
 public:
@@ -149,11 +169,17 @@ void NetConnection::sendFileChunk()
     mCurrentDownloadingFile->read(len, buffer);
     postNetEvent(new FileChunkEvent(buffer, len));
 
-    Con::executef(this, 4, "onFileChunkSent", mCurrentFileName, Con::getIntArg(mCurrentFileBufferOffset), Con::getIntArg(mCurrentFileBufferSize));
+    if (isFileProgressDue(mLastFileProgressTime, mCurrentFileBufferOffset == mCurrentFileBufferSize))
+        Con::executef(this, 4, "onFileChunkSent", mCurrentFileName, Con::getIntArg(mCurrentFileBufferOffset), Con::getIntArg(mCurrentFileBufferSize));
 }
 
 void failedToFindFile(NetConnection* conn);
 
+Stream* NetConnection::openFileForSending(const char* fileName)
+{
+    return ResourceManager->openStream(fileName);
+}
+
 bool NetConnection::startSendingFile(const char* fileName)
 {
     if (!fileName || Con::getBoolVariable("$NetConnection::neverUploadFiles"))
@@ -162,7 +188,7 @@ bool NetConnection::startSendingFile(const char* fileName)
         return false;
     }
 
-    mCurrentDownloadingFile = ResourceManager->openStream(fileName);
+    mCurrentDownloadingFile = openFileForSending(fileName);
 
     if (!mCurrentDownloadingFile)
     {
@@ -183,6 +209,7 @@ bool NetConnection::startSendingFile(const char* fileName)
     mCurrentFileBufferSize = mCurrentDownloadingFile->getStreamSize();
     mCurrentFileBufferOffset = 0;
 
+    isFileProgressDue(mLastFileProgressTime, true);
     Con::executef(this, 4, "onFileChunkSent", fileName, Con::getIntArg(0), Con::getIntArg(mCurrentFileBufferSize));
 
 #ifdef TORQUE_FAST_FILE_TRANSFER
@@ -191,9 +218,13 @@ bool NetConnection::startSendingFile(const char* fileName)
 
 #else // TORQUE_FAST_FILE_TRANSFER
 
-    // always have 32 file chunks (64 bytes each) in transit
+    // Keep a window of file chunks (64 bytes each) in transit, every delivered
+    // chunk posts the next one.  Lossy connections get half the window.
     sendConnectionMessage(FileDownloadSizeMessage, mCurrentFileBufferSize);
-    for (U32 i = 0; i < 32; i++)
+    U32 window = getMax(FileChunkWindow, U32(1));
+    if (getPacketLoss() > 0.1f)
+        window = getMax(window / 2, U32(1));
+    for (U32 i = 0; i < window; i++)
         sendFileChunk();
 
 #endif // TORQUE_FAST_FILE_TRANSFER
@@ -223,46 +254,28 @@ void NetConnection::sendNextFileDownloadRequest()
 
 const U32 MaxFilePacketSize = 1320;
 static U32 FastFilePacketSize = 1280; // ~= 1450 UDP MTU - headers
-static U32 PacketsAtATime = 512; // Realistically not sure how high this can go before it gets bad
-
-static BitStream gFastFileStream(NULL, 0);
-static U8 gFastFileBuffer[MaxFilePacketSize];
-
-BitStream *buildFastFilePacket()
-{
-    // Header size guesstimate
-    U32 headerSize = 40;
-    gFastFileStream.setBuffer(
-        gFastFileBuffer,
-        MaxFilePacketSize + headerSize,
-        MaxFilePacketSize + headerSize
-    );
-    gFastFileStream.setPosition(0);
-
-    gFastFileStream.write(U8(NetInterface::FileTransferPacket));
-    gFastFileStream.write(U8(0));  // flags
-    gFastFileStream.write(U32(0)); // key
-
-    return &gFastFileStream;
-}
+static U32 PacketsAtATime = 512; // Most chunks a transfer may have in flight
+static U32 FastFileInitialWindow = 32; // Chunks in flight at the start of a transfer
 
-void sendFastFilePacket(const NetAddress *addr)
+/// Write the header of a fast file packet
+void buildFastFilePacket(BitStream *out)
 {
-    Net::sendto(addr, gFastFileStream.getBuffer(), gFastFileStream.getPosition());
+    out->write(U8(NetInterface::FileTransferPacket));
+    out->write(U8(0));  // flags
+    out->write(U32(0)); // key
 }
 
 // File transfer steps:
 // 1. Server sends client WriteRequest with chunk count
-
-// 2. Server sends the next X unacknowledged packets of the file
-//    Can use exponential backoff to influence value of X
-// 3. Client receives file packets until it has been Y ms since last recv
-//    Can use connection ping to influence value of Y
-// 4. If client has all packets, transfer is complete
-// 5. Client sends list of acknowledged packets to Server
-// 6. Goto 2
-
-// O(N) where N is strictly less than a small constant (11200) is basically O(1)
+// 2. Server keeps a window of unacknowledged chunks in flight, resending
+//    the ones that have not been acknowledged within ~2 RTT
+// 3. Client acknowledges about twice per RTT while chunks come in, and every
+//    RTT when they stop coming in
+// 4. Server slides the window along on every ack, and grows or shrinks it
+//    depending on how many chunks had to be resent and the packet loss of
+//    the connection
+// 5. Once the client has every chunk it sends a final ack, which stops the
+//    server, and hands the file over
 
 // Originally there were more of these and then they all gradually got replaced
 // Left in for potential future expansion
@@ -271,13 +284,19 @@ enum Opcode
     Data = 3, // Packet contains data chunk
 };
 
-struct FileChunk
+enum FastFileConstants
 {
-    U32 index;
-    U32 offset;
-    Vector<U8> bytes;
+    MinFastFileWindow = 8,      ///< Chunks a transfer may always have in flight.
+    MinAckInterval = 50,        ///< Shortest time between two acks of a receiver, ms.
+    MinResendTime = 150,        ///< Added to 2 RTT before a chunk counts as lost, ms.
+    MaxAckBits = 512,           ///< Chunks past the first missing one an ack can cover.
 };
 
+/// Resent chunks (or connection packet loss) above this shrink the window,
+/// below FastFileLowLoss the window grows.
+static const F32 FastFileHighLoss = 0.1f;
+static const F32 FastFileLowLoss = 0.02f;
+
 /// Class managing file transfer state (both sender and receiver)
 /// It's one big class defined here so we don't pollute netConnection.h
 struct FastFileState
@@ -289,8 +308,20 @@ struct FastFileState
     {
         U32 transferID;
         U32 totalSize; // bytes
-        Vector<FileChunk> fileChunks;
+        U32 chunkSize; // bytes, the last chunk may be shorter
+        U32 chunkCount;
+        bool active; // receiver knows about the transfer and still misses chunks
+        Vector<U8> fileData; // the whole file, read ahead in one go
         Vector<bool> acknowledgedChunks; // 1 per file chunk
+        Vector<U32> sendTimes; // platform real milliseconds of the last send, 0 if never sent
+        U32 firstNonAcknowledged;
+        U32 acknowledgedBytes;
+
+        // Window and rate adaptation
+        U32 window; // chunks allowed in flight
+        U32 sentSinceAdapt;
+        U32 resentSinceAdapt;
+        U32 lastAdaptTime;
 
         // Temp state for ack events
         U32 lastAckStart;
@@ -302,18 +333,42 @@ struct FastFileState
     {
         U32 transferID;
         U32 lastRecvTime; // platform real milliseconds
+        U32 lastAckTime; // platform real milliseconds
         U32 totalSize; // bytes
-        Vector<FileChunk> fileChunks;
+        Vector<U8> fileData; // chunks are stored in place as they come in
+        Vector<U32> chunkOffsets;
+        Vector<U16> chunkLengths;
         Vector<bool> acknowledgedChunks; // 1 per file chunk
+        U32 receivedCount;
+        U32 receivedSinceAck;
         U32 nextNonRecvChunk;
+        bool finished; // final ack posted
     } mRecv;
 
     FastFileState(NetConnection* connection)
     {
         mConnection = connection;
         mSend.transferID = 0;
+        mSend.chunkCount = 0;
+        mSend.active = false;
         mRecv.transferID = 0;
         mRecv.lastRecvTime = 0;
+        mRecv.lastAckTime = 0;
+        mRecv.receivedCount = 0;
+        mRecv.receivedSinceAck = 0;
+        mRecv.finished = false;
+    }
+
+    /// [Sender] Length of a chunk in bytes
+    U32 getChunkLength(U32 index) const
+    {
+        return getMin(mSend.chunkSize, mSend.totalSize - index * mSend.chunkSize);
+    }
+
+    /// [Sender] Time after which an unacknowledged chunk is resent
+    U32 getResendTime() const
+    {
+        return U32(mConnection->getRoundTripTime() * 2.0f) + MinResendTime;
     }
 
     /// [Sender] Write packet for start of transfer
@@ -323,7 +378,7 @@ struct FastFileState
         out->write(U32(mSend.transferID));
         // U16 gives us ~=87.5MB max file size
         // And means we don't have to really care about memory overflow from in case the packet is read wrong
-        out->write(U16(mSend.fileChunks.size()));
+        out->write(U16(mSend.chunkCount));
         // Just for progress indicators
         out->write(U32(mSend.totalSize));
 
@@ -333,7 +388,7 @@ struct FastFileState
             __func__,
             __LINE__,
             mSend.transferID,
-            mSend.fileChunks.size(),
+            mSend.chunkCount,
             mSend.totalSize
         );
 #endif
@@ -365,11 +420,15 @@ struct FastFileState
 
         mRecv.transferID = transferID;
         mRecv.totalSize = totalSize;
-        mRecv.fileChunks.clear();
-        mRecv.fileChunks.setSize(chunkCount);
-        mRecv.acknowledgedChunks.clear();
+        mRecv.fileData.setSize(totalSize);
+        mRecv.chunkOffsets.setSize(chunkCount);
+        mRecv.chunkLengths.setSize(chunkCount);
         mRecv.acknowledgedChunks.setSize(chunkCount);
+        mRecv.receivedCount = 0;
+        mRecv.receivedSinceAck = 0;
         mRecv.nextNonRecvChunk = 0;
+        mRecv.finished = false;
+        mRecv.lastRecvTime = mRecv.lastAckTime = Platform::getRealMilliseconds();
 
         for (U16 i = 0; i < chunkCount; i++)
         {
@@ -381,18 +440,18 @@ struct FastFileState
     /// [Sender] Write packet for data chunk
     void writeDataPacket(BitStream* out, U32 index)
     {
+        U32 offset = index * mSend.chunkSize;
+        U32 length = getChunkLength(index);
+
         // Header
         out->write(U16(Data));
         out->write(U32(mSend.transferID));
         // Packet metadata
         out->write(U32(index));
-        out->write(U32(mSend.fileChunks[index].offset));
-        out->write(U16(mSend.fileChunks[index].bytes.size()));
+        out->write(U32(offset));
+        out->write(U16(length));
         // Raw data
-        for (U32 i = 0; i < mSend.fileChunks[index].bytes.size(); i++)
-        {
-            out->write(U8(mSend.fileChunks[index].bytes[i]));
-        }
+        out->write(length, mSend.fileData.address() + offset);
 
 #if TORQUE_DEBUG
         Con::warnf(
@@ -402,8 +461,8 @@ struct FastFileState
             Data,
             mSend.transferID,
             index,
-            mSend.fileChunks[index].offset,
-            mSend.fileChunks[index].bytes.size()
+            offset,
+            length
         );
 #endif
     }
@@ -415,7 +474,6 @@ struct FastFileState
         U32 index;
         U32 offset;
         U16 size;
-        Vector<U8> bytes;
 
         stream->read(&transferID);
         stream->read(&index);
@@ -435,7 +493,7 @@ struct FastFileState
 #endif
 
         // Basic checks to make sure nothing fishy is happening
-        if (transferID == 0 || transferID != mRecv.transferID)
+        if (transferID == 0)
         {
             Con::errorf(
                 "%s @%d Bad transfer id",
@@ -445,24 +503,15 @@ struct FastFileState
             return false;
         }
 
-        // They need to have actually sent the number of bytes they claim
-        for (U32 i = 0; i < size; i++)
+        // Resends of the previous file can still be on their way when the next
+        // one starts, they are of no use anymore
+        if (transferID != mRecv.transferID)
         {
-            U8 byte;
-            if (!stream->read(&byte))
-            {
-                Con::errorf(
-                    "%s @%d EOS",
-                    __func__,
-                    __LINE__
-                );
-                return false;
-            }
-            bytes.push_back(byte);
+            return true;
         }
 
         // Prevent overflow if index is wrong
-        if (index >= mRecv.fileChunks.size())
+        if (index >= mRecv.acknowledgedChunks.size())
         {
             Con::errorf(
                 "%s @%d Index >= chunks size",
@@ -471,95 +520,160 @@ struct FastFileState
             );
             return false;
         }
+        if (offset > mRecv.totalSize || size > mRecv.totalSize - offset)
+        {
+            Con::errorf(
+                "%s @%d Chunk outside of file",
+                __func__,
+                __LINE__
+            );
+            return false;
+        }
 
-        // Store chunk in state (gets pulled out later)
-        mRecv.fileChunks[index].index = index;
-        mRecv.fileChunks[index].offset = offset;
-        mRecv.fileChunks[index].bytes = bytes;
-        mRecv.acknowledgedChunks[index] = true;
+        // Store new chunks in place (they get handed over in order later)
+        if (!mRecv.acknowledgedChunks[index])
+        {
+            // They need to have actually sent the number of bytes they claim
+            stream->read(size, mRecv.fileData.address() + offset);
+            if (!stream->isValid())
+            {
+                Con::errorf(
+                    "%s @%d EOS",
+                    __func__,
+                    __LINE__
+                );
+                return false;
+            }
+
+            mRecv.chunkOffsets[index] = offset;
+            mRecv.chunkLengths[index] = size;
+            mRecv.acknowledgedChunks[index] = true;
+            mRecv.receivedCount++;
+            mRecv.receivedSinceAck++;
+        }
 
         // Update ping timer so we know when to ack
         mRecv.lastRecvTime = Platform::getRealMilliseconds();
         return true;
     }
 
-    /// [Sender] Write data packets for the next `count` unacknowledged chunks to receiver
-    void writeNextDataPackets(U32 count)
+    /// [Sender] Fill the window: send every chunk that was never sent or not
+    /// acknowledged in time, until the window is full
+    void writeNextDataPackets()
     {
-        U32 index = 0;
-        for (U32 i = 0; i < count; i ++)
+        U32 now = Platform::getRealMilliseconds();
+        U32 resendTime = getResendTime();
+        U32 inFlight = 0;
+
+        for (U32 index = mSend.firstNonAcknowledged; index < mSend.chunkCount && inFlight < mSend.window; index++)
         {
-            // Get index of next chunk
-            for (; index < mSend.fileChunks.size(); index ++)
+            if (mSend.acknowledgedChunks[index])
+            {
+                continue;
+            }
+
+            // Still in flight, give it time
+            U32 sendTime = mSend.sendTimes[index];
+            if (sendTime && now - sendTime < resendTime)
             {
-                if (!mSend.acknowledgedChunks[index])
-                {
-                    break;
-                }
+                inFlight++;
+                continue;
             }
 
-            // EOF is handled by the receiver
-            if (index == mSend.fileChunks.size())
+            if (sendTime)
             {
-                return;
+                mSend.resentSinceAdapt++;
             }
+            mSend.sentSinceAdapt++;
+            mSend.sendTimes[index] = getMax(now, U32(1));
+            inFlight++;
+
+            // Header size guesstimate
+            PacketStream out(MaxFilePacketSize + 40);
+            buildFastFilePacket(&out);
+            writeDataPacket(&out, index);
+            out.sendTo(mConnection->getNetAddress());
+        }
+    }
+
+    /// [Sender] Grow or shrink the window, at most once per RTT
+    void adaptWindow()
+    {
+        U32 now = Platform::getRealMilliseconds();
+        if (!mSend.sentSinceAdapt || now - mSend.lastAdaptTime < getMax(U32(mConnection->getRoundTripTime()), U32(MinAckInterval)))
+        {
+            return;
+        }
 
-            // Send next unacknowledged chunk to receiver
-            BitStream *out = buildFastFilePacket();
-            writeDataPacket(out, index);
-            sendFastFilePacket(mConnection->getNetAddress());
+        // A resend means the chunk or its ack got lost (or the link is slower than we think)
+        F32 loss = F32(mSend.resentSinceAdapt) / F32(mSend.sentSinceAdapt);
+        loss = getMax(loss, mConnection->getPacketLoss());
 
-            index++;
+        U32 maxWindow = getMax(PacketsAtATime, U32(MinFastFileWindow));
+        if (loss > FastFileHighLoss)
+        {
+            mSend.window = getMax(mSend.window / 2, U32(MinFastFileWindow));
         }
+        else if (loss < FastFileLowLoss)
+        {
+            mSend.window = getMin(mSend.window + mSend.window / 4 + 1, maxWindow);
+        }
+
+        mSend.sentSinceAdapt = 0;
+        mSend.resentSinceAdapt = 0;
+        mSend.lastAdaptTime = now;
     }
 
-    /// [Receiver] Determine if it has been long enough since the last chunk packet and we should send an ack
-    /// According to the state machine above, this is when it has been more than 1RTT since the last packet
-    bool shouldSendAcknowledgement()
+    /// [Sender] Mark a chunk as received by the other side
+    void acknowledgeChunk(U32 index)
     {
-        // If it has been Ping ms since last chunk packet, send ack
-        if (mRecv.transferID != 0)
+        if (!mSend.acknowledgedChunks[index])
         {
-            // This is entirely a heuristic but it works well in practice
-            U32 now = Platform::getRealMilliseconds();
-            if (now - mRecv.lastRecvTime > mConnection->getRoundTripTime())
-            {
-                return true;
-            }
+            mSend.acknowledgedChunks[index] = true;
+            mSend.acknowledgedBytes += getChunkLength(index);
         }
-        return false;
     }
 
-    /// [Receiver] Determine if the transfer is finished
-    bool isFinished()
+    /// [Receiver] Determine if we should send an ack. While chunks come in
+    /// that is about twice per RTT so the sender can slide its window along,
+    /// when they stop coming in it is once per RTT so lost acks get replaced.
+    /// Notes the ack as sent if it is due.
+    bool shouldSendAcknowledgement()
     {
-        if (mRecv.transferID != 0)
+        if (mRecv.transferID == 0 || mRecv.finished)
         {
-            // Any unack means no
-            for (U32 index = 0; index < mRecv.acknowledgedChunks.size(); index++)
-            {
-                if (!mRecv.acknowledgedChunks[index])
-                {
-                    return false;
-                }
-            }
+            return false;
+        }
+
+        // This is entirely a heuristic but it works well in practice
+        U32 now = Platform::getRealMilliseconds();
+        U32 rtt = U32(mConnection->getRoundTripTime());
+        if ((mRecv.receivedSinceAck && now - mRecv.lastAckTime >= getMax(rtt / 2, U32(MinAckInterval)))
+            || now - mRecv.lastRecvTime > rtt)
+        {
+            mRecv.lastAckTime = now;
+            mRecv.lastRecvTime = now;
+            mRecv.receivedSinceAck = 0;
             return true;
         }
         return false;
     }
 
+    /// [Receiver] Determine if the transfer is finished
+    bool isFinished()
+    {
+        return mRecv.transferID != 0 && mRecv.receivedCount == mRecv.acknowledgedChunks.size();
+    }
+
     /// [Receiver] Write the packet telling the sender which chunks we have received
     void writeAcknowledgeEvent(BitStream* out)
     {
-        // Bump the recv time so we don't send duplicate ack events
-        mRecv.lastRecvTime = Platform::getRealMilliseconds();
-
         // Header
         out->write(mRecv.transferID);
 
         // Index of first non-acknowledged chunk, so the server can ez ignore everything before this
-        // Mostly just an optimization
-        U32 minNonAcknowledged = 0;
+        // Everything before the chunk we hand over next has been received
+        U32 minNonAcknowledged = mRecv.nextNonRecvChunk;
         for (; minNonAcknowledged < mRecv.acknowledgedChunks.size(); minNonAcknowledged++)
         {
             if (!mRecv.acknowledgedChunks[minNonAcknowledged])
@@ -569,49 +683,27 @@ struct FastFileState
         }
         out->writeInt(minNonAcknowledged, 32);
 
-        // Find index of last acknowledged chunk so we know how many bits of ack we will need to cover
-        // everything from the first non-ack to the last ack
-        U32 lastAcknowledged = 0;
-        for (U32 index = 0; index < mRecv.acknowledgedChunks.size(); index++)
-        {
-            if (mRecv.acknowledgedChunks[index])
-            {
-                lastAcknowledged = index;
-                break;
-            }
-        }
-
-        // Build debug string for the Con::warnf
-        char debugStr[512+1] = {0};
-
         // Number of chunks between first nonack and last ack. Since we tell the server the lower bound
         // we only need to send ack bits for everything between these two.
-        U32 ackCount = minNonAcknowledged - lastAcknowledged;
-
         // Upper bound for sanity and packet size limits
         // If we exceed this we will get retransmissions for the later chunks we have acked,
         // but that's probably unlike and also not that bad.
-        if (ackCount > 512)
+        U32 ackCount = getMin(mRecv.acknowledgedChunks.size() - minNonAcknowledged, U32(MaxAckBits));
+        while (ackCount && !mRecv.acknowledgedChunks[minNonAcknowledged + ackCount - 1])
         {
-            ackCount = 512;
+            ackCount--;
         }
         out->writeInt(ackCount, 16);
 
+        // Build debug string for the Con::warnf
+        char debugStr[MaxAckBits + 1] = {0};
+
         // For every chunk in the [first nonack, last ack] range, tell the server if we have it
         for (U32 i = 0; i < ackCount; i ++)
         {
             U32 index = minNonAcknowledged + i;
-            if (index >= mRecv.acknowledgedChunks.size())
-            {
-                // This probably never happens, but just in case it does, we definitely don't have it
-                out->writeFlag(false);
-                debugStr[i] = '0';
-            }
-            else
-            {
-                out->writeFlag(mRecv.acknowledgedChunks[index]);
-                debugStr[i] = mRecv.acknowledgedChunks[index] ? '1' : '0';
-            }
+            out->writeFlag(mRecv.acknowledgedChunks[index]);
+            debugStr[i] = mRecv.acknowledgedChunks[index] ? '1' : '0';
         }
         // Null terminate
         debugStr[ackCount] = 0;
@@ -637,7 +729,7 @@ struct FastFileState
         Vector<bool> acknowledged;
 
         // Build debug string for the Con::warnf
-        char debugStr[512+1] = {0};
+        char debugStr[MaxAckBits + 1] = {0};
 
         stream->read(&transferID);
         minNonAcknowledged = stream->readInt(32);
@@ -653,7 +745,7 @@ struct FastFileState
             );
             return false;
         }
-        if (ackCount > 512)
+        if (ackCount > MaxAckBits)
         {
             return false;
         }
@@ -688,25 +780,26 @@ struct FastFileState
         return true;
     }
 
-    /// [Sender] Handle the ack packet from the receiver and send it the next packets
+    /// [Sender] Handle the ack packet from the receiver and slide the window along
     bool handleAcknowledgement()
     {
-        // For everything up to the receiver's first nonack chunk, we can assume they have received it
-        for (U32 index = 0; index < mSend.lastAckStart; index++)
+        // Bounds check for sanity
+        if (mSend.lastAckStart > mSend.chunkCount)
         {
-            // Bounds check for sanity
-            if (index >= mSend.acknowledgedChunks.size())
-            {
 #if TORQUE_DEBUG
-                Con::errorf(
-                    "%s @%d Index >= ackChunks.size()",
-                    __func__,
-                    __LINE__
-                );
+            Con::errorf(
+                "%s @%d Index >= ackChunks.size()",
+                __func__,
+                __LINE__
+            );
 #endif
-                return false;
-            }
-            mSend.acknowledgedChunks[index] = true;
+            return false;
+        }
+
+        // For everything up to the receiver's first nonack chunk, we can assume they have received it
+        for (U32 index = mSend.firstNonAcknowledged; index < mSend.lastAckStart; index++)
+        {
+            acknowledgeChunk(index);
         }
         // Then all of the ack bits start at the first nonack index and go from there
         for (U32 i = 0; i < mSend.lastAckAcks.size(); i++)
@@ -714,14 +807,31 @@ struct FastFileState
             U32 index = mSend.lastAckStart + i;
             // Bounds check for sanity, but don't bother erroring on this because they might send
             // a couple past the end (todo: do they actually? this is safe even if they do, so idc)
-            if (index < mSend.acknowledgedChunks.size())
+            if (index < mSend.chunkCount && mSend.lastAckAcks[i])
             {
-                mSend.acknowledgedChunks[index] = mSend.lastAckAcks[i];
+                acknowledgeChunk(index);
             }
         }
+        while (mSend.firstNonAcknowledged < mSend.chunkCount && mSend.acknowledgedChunks[mSend.firstNonAcknowledged])
+        {
+            mSend.firstNonAcknowledged++;
+        }
 
-        // Send them the next set of packets now since we know they're waiting
-        writeNextDataPackets(PacketsAtATime);
+        // Done, drop the file
+        if (mSend.firstNonAcknowledged == mSend.chunkCount)
+        {
+            mSend.active = false;
+            mSend.fileData.clear();
+            mSend.fileData.compact();
+            return true;
+        }
+
+        // Send them the next packets now since we know they're waiting
+        adaptWindow();
+        if (mSend.active)
+        {
+            writeNextDataPackets();
+        }
         return true;
     }
 };
@@ -825,10 +935,11 @@ void NetConnection::fastFileTransferInit()
     /// (could not send packets on unruly routers with anything over than 1392)
     /// So 1380 is chosen as it should be "safe enough" for most UDP/IP stacks to accept it
     Con::addVariable("$pref::Net::FastFileChunkSize", TypeS32, &FastFilePacketSize);
-    /// Number of packets to send in each burst of data
-    /// Really not sure what the upper bound on this is, as increasing it will just increase loss
-    /// but you were going to get loss anyway.
+    /// Most chunks a transfer may have in flight. The window grows towards this
+    /// while the link keeps up and halves when chunks get lost.
     Con::addVariable("$pref::Net::FastFilePacketsAtATime", TypeS32, &PacketsAtATime);
+    /// Chunks in flight at the start of every file.
+    Con::addVariable("$pref::Net::FastFileInitialWindow", TypeS32, &FastFileInitialWindow);
 }
 
 /// Init connection state (NetConnection::NetConnection())
@@ -847,39 +958,37 @@ void NetConnection::destroyFastFile()
 /// using a FileDownloadRequestEvent from above
 void NetConnection::sendFastFile()
 {
-    // Init sender state
-    mFastFileState->mSend.transferID ++;
-    mFastFileState->mSend.totalSize = mCurrentFileBufferSize;
-    mFastFileState->mSend.fileChunks.clear();
-    mFastFileState->mSend.acknowledgedChunks.clear();
-
     if (FastFilePacketSize > 1280)
         FastFilePacketSize = 1280;
+    if (FastFilePacketSize == 0)
+        FastFilePacketSize = 1;
 
-    // Load all chunks of file to send
-    U32 index = 0;
-    for (U32 offset = 0; offset < mCurrentFileBufferSize; offset += FastFilePacketSize)
+    // Init sender state
+    mFastFileState->mSend.transferID ++;
+    mFastFileState->mSend.totalSize = mCurrentFileBufferSize;
+    mFastFileState->mSend.chunkSize = FastFilePacketSize;
+    mFastFileState->mSend.chunkCount = (mCurrentFileBufferSize + FastFilePacketSize - 1) / FastFilePacketSize;
+    mFastFileState->mSend.active = false;
+    mFastFileState->mSend.firstNonAcknowledged = 0;
+    mFastFileState->mSend.acknowledgedBytes = 0;
+    mFastFileState->mSend.window = getMin(getMax(FastFileInitialWindow, U32(MinFastFileWindow)), getMax(PacketsAtATime, U32(MinFastFileWindow)));
+    mFastFileState->mSend.sentSinceAdapt = 0;
+    mFastFileState->mSend.resentSinceAdapt = 0;
+    mFastFileState->mSend.lastAdaptTime = Platform::getRealMilliseconds();
+
+    // Read the whole file ahead so we don't have try seeking when resending chunks
+    mFastFileState->mSend.fileData.setSize(mCurrentFileBufferSize);
+    mCurrentDownloadingFile->read(mCurrentFileBufferSize, mFastFileState->mSend.fileData.address());
+    ResourceManager->closeStream(mCurrentDownloadingFile);
+    mCurrentDownloadingFile = NULL;
+
+    U32 chunkCount = mFastFileState->mSend.chunkCount;
+    mFastFileState->mSend.acknowledgedChunks.setSize(chunkCount);
+    mFastFileState->mSend.sendTimes.setSize(chunkCount);
+    for (U32 index = 0; index < chunkCount; index++)
     {
-        U32 length = FastFilePacketSize;
-        // Last packet may not be full size
-        if (offset + length > mCurrentFileBufferSize)
-        {
-            length = mCurrentFileBufferSize - offset;
-        }
-        Vector<U8> bytes(length);
-        bytes.setSize(length);
-        mCurrentDownloadingFile->read(length, bytes.address());
-
-        // Queue up the packets in our state so we don't have try seeking when reading the file
-        FileChunk chunk;
-        chunk.index = index;
-        chunk.offset = offset;
-        chunk.bytes = bytes;
-
-        mFastFileState->mSend.fileChunks.push_back(chunk);
-        mFastFileState->mSend.acknowledgedChunks.push_back(false);
-
-        index ++;
+        mFastFileState->mSend.acknowledgedChunks[index] = false;
+        mFastFileState->mSend.sendTimes[index] = 0;
     }
 
     // And tell the receiver we're going to be sending it
@@ -887,33 +996,52 @@ void NetConnection::sendFastFile()
     postNetEvent(new FastFileRequestEvent());
 }
 
-/// Every frame when receiving a file, check to see if we're done or if we need to ack the packets
+/// Every packet, keep the window of the file we send full, and check to see if
+/// the file we receive is done or if we need to ack the packets
 void NetConnection::checkFastFile()
 {
+    // Sender: top up the window and resend what was not acknowledged in time
+    if (mFastFileState->mSend.active)
+    {
+        mFastFileState->writeNextDataPackets();
+    }
+
+    if (mFastFileState->mRecv.transferID == 0 || mFastFileState->mRecv.finished)
+    {
+        return;
+    }
+
+    // Once we have everything, tell the sender before the file is handed over,
+    // so this reaches it ahead of the request for the next file
+    bool finished = mFastFileState->isFinished();
+    if (finished)
+    {
+        mFastFileState->mRecv.finished = true;
+        postNetEvent(new FastFileAcknowledgeEvent());
+    }
+
     // Process all the chunks we have
-    for (U32 index = mFastFileState->mRecv.nextNonRecvChunk;
-        index < mFastFileState->mRecv.fileChunks.size();
-        index++)
+    // When we reach one we don't, stop so the stream output is contiguous
+    while (mFastFileState->mRecv.nextNonRecvChunk < mFastFileState->mRecv.acknowledgedChunks.size()
+        && mFastFileState->mRecv.acknowledgedChunks[mFastFileState->mRecv.nextNonRecvChunk])
     {
-        // When we reach one we don't, stop so the stream output is contiguous
-        if (!mFastFileState->mRecv.acknowledgedChunks[index])
-        {
-            mFastFileState->mRecv.nextNonRecvChunk = index;
-            break;
-        }
+        U32 index = mFastFileState->mRecv.nextNonRecvChunk++;
+
         // Conventional torque file download output function
         chunkReceived(
-            mFastFileState->mRecv.fileChunks[index].bytes.address(),
-            mFastFileState->mRecv.fileChunks[index].bytes.size()
+            mFastFileState->mRecv.fileData.address() + mFastFileState->mRecv.chunkOffsets[index],
+            mFastFileState->mRecv.chunkLengths[index]
         );
     }
     // If we're done, chunkReceived will have finished the transfer. So just exit
-    if (mFastFileState->isFinished())
+    if (finished)
     {
+        mFastFileState->mRecv.fileData.clear();
+        mFastFileState->mRecv.fileData.compact();
         return;
     }
 
-    // If it has been Ping ms since last packet, send ack
+    // If it has been long enough since the last ack, send one
     if (mFastFileState->shouldSendAcknowledgement())
     {
         // Send ack event
@@ -974,13 +1102,17 @@ void NetConnection::handleFastFileRequest(BitStream *stream)
     mCurrentFileBufferSize = mFastFileState->mRecv.totalSize;
     mCurrentFileBuffer = dRealloc(mCurrentFileBuffer, mCurrentFileBufferSize);
     mCurrentFileBufferOffset = 0;
+    isFileProgressDue(mLastFileProgressTime, true);
     Con::executef(4, "onFileChunkReceived", mMissingFileList[0], Con::getIntArg(0), Con::getIntArg(mCurrentFileBufferSize));
 }
 
 /// [Sender] After sending packet for starting a file transfer, start sending data
 void NetConnection::processFastFileRequest()
 {
-    mFastFileState->writeNextDataPackets(PacketsAtATime);
+    // Nothing to send if the file was not found, the previous transfer is done
+    mFastFileState->mSend.active = mFastFileState->mSend.firstNonAcknowledged < mFastFileState->mSend.chunkCount;
+    if (mFastFileState->mSend.active)
+        mFastFileState->writeNextDataPackets();
 }
 
 /// [Receiver] Write the packet to acknowledge sent chunks
@@ -1002,29 +1134,34 @@ void NetConnection::handleFastFileAcknowledgement(BitStream *stream)
 /// [Sender] After reading the packet acknowledging sent chunks, update state
 void NetConnection::processFastFileAcknowledgement()
 {
+    bool wasActive = mFastFileState->mSend.active;
     if (!mFastFileState->handleAcknowledgement())
     {
         setLastError("Bad fast file packet.");
         return;
     }
 
-    // Calculate size and progress for reporting to script
-    U32 totalSent = 0;
-    for (U32 index = 0; index < mFastFileState->mSend.acknowledgedChunks.size(); index++)
-    {
-        // Lazy: Don't bother checking unacked chunks after the first one
-        // We haven't actually written that to disk yet either
-        if (!mFastFileState->mSend.acknowledgedChunks[index])
-        {
-            break;
-        }
-        totalSent += mFastFileState->mSend.fileChunks[index].bytes.size();
-    }
-    Con::executef(this, 4, "onFileChunkSent", mCurrentFileName, Con::getIntArg(totalSent), Con::getIntArg(mCurrentFileBufferSize));
+    // Report progress to script, the last one always goes out
+    bool done = wasActive && !mFastFileState->mSend.active;
+    if (isFileProgressDue(mLastFileProgressTime, done))
+        Con::executef(this, 4, "onFileChunkSent", mCurrentFileName, Con::getIntArg(mFastFileState->mSend.acknowledgedBytes), Con::getIntArg(mCurrentFileBufferSize));
 }
 
 #endif // TORQUE_FAST_FILE_TRANSFER
 
+/// Init console variables for file transfers
+void NetConnection::fileTransferInit()
+{
+    /// Shortest time between two progress callbacks to script, in ms.
+    Con::addVariable("$pref::Net::FileProgressInterval", TypeS32, &FileProgressInterval);
+#ifdef TORQUE_FAST_FILE_TRANSFER
+    fastFileTransferInit();
+#else
+    /// FileChunkEvents kept in transit while sending a file.
+    Con::addVariable("$pref::Net::FileChunkWindow", TypeS32, &FileChunkWindow);
+#endif
+}
+
 void NetConnection::chunkReceived(U8* chunkData, U32 chunkLen)
 {
     if (chunkLen == 0)
@@ -1065,7 +1202,7 @@ void NetConnection::chunkReceived(U8* chunkData, U32 chunkLen)
         mCurrentFileBuffer = NULL;
         sendNextFileDownloadRequest();
     }
-    else
+    else if (isFileProgressDue(mLastFileProgressTime, false))
     {
         Con::executef(4, "onFileChunkReceived", mMissingFileList[0], Con::getIntArg(mCurrentFileBufferOffset), Con::getIntArg(mCurrentFileBufferSize));
     }
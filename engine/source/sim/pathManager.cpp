@@ -213,6 +213,8 @@ void PathManager::updatePath(const U32              id,
     rEntry.msToNext = times;
     rEntry.smoothingType = smoothingTypes;
 
+    rEntry.positionCache.clear();
+
     rEntry.totalTime = 0;
 #ifdef MBG_MOVING_PLATFORM_TIMING
     for (S32 i = 0; i < S32(rEntry.msToNext.size() - 1); i++)
@@ -282,52 +284,94 @@ void PathManager::getPathPosition(const U32 id,
     QuatF* rotation)
 {
     AssertFatal(isValidPath(id), "Error, this is not a valid path!");
+    PathEntry& rEntry = *mPaths[id];
+
+    // Whole millisecond positions come straight out of the cache.
+    if (rotation == NULL && msPosition >= 0.0 && msPosition <= rEntry.totalTime && mFloor(msPosition) == msPosition)
+    {
+        if (rEntry.positionCache.empty())
+            buildPathCache(id);
+
+        if (!rEntry.positionCache.empty())
+        {
+            rPosition = rEntry.positionCache[U32(msPosition)];
+            return;
+        }
+    }
+
     PROFILE_START(PathManGetPos);
+    evaluatePathPosition(rEntry, msPosition, rPosition, rotation);
+    PROFILE_END();
+}
 
+void PathManager::evaluatePathPosition(const PathEntry& entry,
+    const F64 msPosition,
+    Point3F& rPosition,
+    QuatF* rotation) const
+{
     // Ok, query holds our path information...
     F64 ms = msPosition;
-    if (ms > mPaths[id]->totalTime)
-        ms = mPaths[id]->totalTime;
+    if (ms > entry.totalTime)
+        ms = entry.totalTime;
 
     S32 startNode = 0;
-    while (ms > mPaths[id]->msToNext[startNode]) {
-        ms -= mPaths[id]->msToNext[startNode];
+    while (ms > entry.msToNext[startNode]) {
+        ms -= entry.msToNext[startNode];
         startNode++;
     }
-    S32 endNode = (startNode + 1) % mPaths[id]->positions.size();
+    S32 endNode = (startNode + 1) % entry.positions.size();
 
-    Point3F& rStart = mPaths[id]->positions[startNode];
-    Point3F& rEnd = mPaths[id]->positions[endNode];
+    const Point3F& rStart = entry.positions[startNode];
+    const Point3F& rEnd = entry.positions[endNode];
 
-    F64 interp = ms / F32(mPaths[id]->msToNext[startNode]);
-    if (mPaths[id]->smoothingType[startNode] == Marker::SmoothingTypeLinear)
+    F64 interp = ms / F32(entry.msToNext[startNode]);
+    if (entry.smoothingType[startNode] == Marker::SmoothingTypeLinear)
     {
         rPosition = (rStart * (1.0 - interp)) + (rEnd * interp);
     }
-    else if (mPaths[id]->smoothingType[startNode] == Marker::SmoothingTypeAccelerate)
+    else if (entry.smoothingType[startNode] == Marker::SmoothingTypeAccelerate)
     {
         interp = mSin(interp * M_PI - (M_PI / 2)) * 0.5 + 0.5;
         rPosition = (rStart * (1.0 - interp)) + (rEnd * interp);
     }
-    else if (mPaths[id]->smoothingType[startNode] == Marker::SmoothingTypeSpline)
+    else if (entry.smoothingType[startNode] == Marker::SmoothingTypeSpline)
     {
         S32 preStart = startNode - 1;
         S32 postEnd = endNode + 1;
-        if (postEnd >= mPaths[id]->positions.size())
+        if (postEnd >= entry.positions.size())
             postEnd = 0;
         if (preStart < 0)
-            preStart = mPaths[id]->positions.size() - 1;
-        Point3F p0 = mPaths[id]->positions[preStart];
+            preStart = entry.positions.size() - 1;
+        Point3F p0 = entry.positions[preStart];
         Point3F p1 = rStart;
         Point3F p2 = rEnd;
-        Point3F p3 = mPaths[id]->positions[postEnd];
+        Point3F p3 = entry.positions[postEnd];
         rPosition.x = mCatmullrom(interp, p0.x, p1.x, p2.x, p3.x);
         rPosition.y = mCatmullrom(interp, p0.y, p1.y, p2.y, p3.y);
         rPosition.z = mCatmullrom(interp, p0.z, p1.z, p2.z, p3.z);
     }
 
     if (rotation)
-        rotation->interpolate(mPaths[id]->rotations[startNode], mPaths[id]->rotations[endNode], interp);
+        rotation->interpolate(entry.rotations[startNode], entry.rotations[endNode], interp);
+}
+
+void PathManager::buildPathCache(const U32 id)
+{
+    AssertFatal(isValidPath(id), "Error, this is not a valid path!");
+    PathEntry& rEntry = *mPaths[id];
+
+    if (!rEntry.positionCache.empty() || rEntry.totalTime > PathCacheMaxTime)
+        return;
+
+    // Paths read back through readState() carry no smoothing info.
+    if (rEntry.smoothingType.size() != rEntry.positions.size())
+        return;
+
+    PROFILE_START(PathManBuildCache);
+
+    rEntry.positionCache.setSize(rEntry.totalTime + 1);
+    for (U32 ms = 0; ms <= rEntry.totalTime; ms++)
+        evaluatePathPosition(rEntry, F64(ms), rEntry.positionCache[ms], NULL);
 
     PROFILE_END();
 }
@@ -39,22 +39,47 @@ private:
         Vector<U32>     smoothingType;
         Vector<U32>     msToNext;
 
+        /// Path positions sampled at every whole millisecond from 0 to totalTime,
+        /// built on demand by buildPathCache().  Empty if not built (yet) or if
+        /// the path is longer than PathCacheMaxTime.
+        Vector<Point3F> positionCache;
+
         PathEntry() {
             VECTOR_SET_ASSOCIATION(positions);
             VECTOR_SET_ASSOCIATION(rotations);
             VECTOR_SET_ASSOCIATION(smoothingType);
             VECTOR_SET_ASSOCIATION(msToNext);
+            VECTOR_SET_ASSOCIATION(positionCache);
+        }
+
+        /// Copies the path data only; the position cache is rebuilt on demand
+        /// so it never goes stale and is never carried around in events.
+        PathEntry& operator=(const PathEntry& other)
+        {
+            totalTime = other.totalTime;
+            positions = other.positions;
+            rotations = other.rotations;
+            smoothingType = other.smoothingType;
+            msToNext = other.msToNext;
+            positionCache.clear();
+            return *this;
         }
     };
 
     Vector<PathEntry*> mPaths;
 
+    void evaluatePathPosition(const PathEntry& entry, const F64 msPosition, Point3F& rPosition, QuatF* rotation) const;
+
 public:
     enum PathType {
         BackAndForth,
         Looping
     };
 
+    enum {
+        PathCacheMaxTime = 120000,  ///< Longest path (in ms) that gets a position cache.
+    };
+
 public:
     PathManager(const bool isServer);
     ~PathManager();
@@ -71,6 +96,11 @@ public:
     U32  getPathNumWaypoints(const U32 id) const;
     U32  getWaypointTime(const U32 id, const U32 wayPoint) const;
 
+    /// Samples the path once per millisecond so that getPathPosition() on whole
+    /// millisecond positions (which is all PathedInterior ever asks for) is a
+    /// table lookup returning exactly what evaluating the path would.
+    void buildPathCache(const U32 id);
+
     U32 getPathTimeBits(const U32 id);
     U32 getPathWaypointBits(const U32 id);
 
@@ -15,6 +15,7 @@
 #include "game/gameProcess.h"
 #include "math/mathUtils.h"
 #include "game/tickCache.h"
+#include "collision/polyListArena.h"
 
 //----------------------------------------------------------------------------
 
@@ -522,6 +523,9 @@ void ProcessList::advanceObjects()
                 con->clearMoves(1);
             }
         }
+
+        // latch the poly list counters for getPolyListArenaStats()
+        PolyListArena::endTick();
     } else if (!GameConnection::getConnectionToServer()->getControlObject())
     {
         GameConnection::getConnectionToServer()->clearMoves(1);
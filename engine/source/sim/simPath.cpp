@@ -211,6 +211,7 @@ void Path::onRemove()
 void Path::sortMarkers()
 {
     dQsort(objectList.address(), objectList.size(), sizeof(SimObject*), cmpPathObject);
+    invalidateIndex();
 }
 
 void Path::updatePath()
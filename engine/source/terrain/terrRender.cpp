@@ -363,8 +363,8 @@ void TerrainRender::processBlock(SceneState*, EdgeParent* topEdge, EdgeParent* r
     stack[0].texAllocated = false;
 
     // St up fog...
-    Vector<SceneState::FogBand>* posFog = mSceneState->getPosFogBands();
-    Vector<SceneState::FogBand>* negFog = mSceneState->getNegFogBands();
+    FrameVector<SceneState::FogBand>* posFog = mSceneState->getPosFogBands();
+    FrameVector<SceneState::FogBand>* negFog = mSceneState->getNegFogBands();
     bool clipAbove = posFog->size() > 0 && (*posFog)[0].isFog == false;
     bool clipBelow = negFog->size() > 0 && (*negFog)[0].isFog == false;
     bool clipOn = posFog->size() > 0 && (*posFog)[0].isFog == true;
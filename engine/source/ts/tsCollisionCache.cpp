@@ -0,0 +1,473 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#include "ts/tsCollisionCache.h"
+#include "ts/tsShape.h"
+#include "ts/tsMesh.h"
+#include "core/resManager.h"
+#include "core/stream.h"
+#include "core/crc.h"
+#include "console/console.h"
+#include "platform/profiler.h"
+
+bool TSCollisionCache::smOpen = false;
+bool TSCollisionCache::smDirty = false;
+char TSCollisionCache::smFileName[1024];
+
+U8* TSCollisionCache::smFileData = NULL;
+const TSCollisionCache::Entry* TSCollisionCache::smEntries = NULL;
+const U32* TSCollisionCache::smWords = NULL;
+const U8* TSCollisionCache::smBytes = NULL;
+U32 TSCollisionCache::smNumEntries = 0;
+HashTable<U64, U32> TSCollisionCache::smIndex;
+
+Vector<TSCollisionCache::Entry> TSCollisionCache::smNewEntries(__FILE__, __LINE__);
+Vector<U32> TSCollisionCache::smNewWords(__FILE__, __LINE__);
+Vector<U8> TSCollisionCache::smNewBytes(__FILE__, __LINE__);
+HashTable<U64, U32> TSCollisionCache::smNewIndex;
+
+HashTable<TSShape*, U32> TSCollisionCache::smShapeCRCs;
+U32 TSCollisionCache::smHits = 0;
+U32 TSCollisionCache::smMisses = 0;
+
+static inline U32 getFloatWord(F32 f)
+{
+    U32 word;
+    dMemcpy(&word, &f, sizeof(word));
+    return word;
+}
+
+static inline F32 getWordFloat(U32 word)
+{
+    F32 f;
+    dMemcpy(&f, &word, sizeof(f));
+    return f;
+}
+
+/// Length of an accelerator emit string: vertices, edges and faces, each
+/// preceded by its count.
+static U32 getEmitStringLength(const U8* emitString)
+{
+    U32 pos = 1 + emitString[0];
+    pos += 1 + emitString[pos] * 2;
+    pos += 1 + emitString[pos] * 4;
+    return pos;
+}
+
+//-----------------------------------------------------------------------------
+
+bool TSCollisionCache::open(const char* fileName)
+{
+    if (smOpen)
+        close();
+
+    // '<file>.mcc' next to the mission or script...
+    dStrncpy(smFileName, fileName, sizeof(smFileName) - 5);
+    smFileName[sizeof(smFileName) - 5] = '\0';
+    char* ext = dStrrchr(smFileName, '.');
+    if (ext && !dStrchr(ext, '/'))
+        *ext = '\0';
+    dStrcat(smFileName, ".mcc");
+
+    smOpen = true;
+    smDirty = false;
+    smHits = 0;
+    smMisses = 0;
+
+    return load(smFileName);
+}
+
+void TSCollisionCache::close()
+{
+    if (!smOpen)
+        return;
+
+    smOpen = false;
+
+    // write it out if a detail was cooked or one is no longer used...
+    if (smMisses || smNewEntries.size() != smNumEntries)
+        smDirty = true;
+
+    if (smHits || smMisses)
+        Con::printf("Collision cache: restored %d of %d shape collision details", smHits, smHits + smMisses);
+
+    if (smDirty && smNewEntries.size() && !save(smFileName))
+        Con::warnf(ConsoleLogEntry::General, "TSCollisionCache: unable to write %s", smFileName);
+
+    delete[] smFileData;
+    smFileData = NULL;
+    smEntries = NULL;
+    smWords = NULL;
+    smBytes = NULL;
+    smNumEntries = 0;
+    smIndex.clear();
+
+    smNewEntries.clear();
+    smNewWords.clear();
+    smNewBytes.clear();
+    smNewIndex.clear();
+
+    smShapeCRCs.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+U32 TSCollisionCache::getShapeCRC(TSShape* shape)
+{
+    HashTable<TSShape*, U32>::Iterator itr = smShapeCRCs.find(shape);
+    if (itr != smShapeCRCs.end())
+        return itr->value;
+
+    // Use the crc taken on load if there is one, else take it the same way
+    // from the file.  Shapes built in code have no file and are not cached.
+    U32 crc = InvalidCRC;
+    ResourceObject* obj = shape->mSourceResource;
+    if (obj)
+    {
+        if (obj->crc != InvalidCRC)
+            crc = obj->crc;
+        else
+        {
+            Stream* stream = ResourceManager->openStream(obj);
+            if (stream)
+            {
+                crc = calculateCRCStream(stream, InvalidCRC);
+                ResourceManager->closeStream(stream);
+            }
+        }
+    }
+
+    smShapeCRCs.insertUnique(shape, crc);
+    return crc;
+}
+
+//-----------------------------------------------------------------------------
+
+bool TSCollisionCache::load(const char* fileName)
+{
+    Stream* stream = ResourceManager->openStream(fileName);
+    if (!stream)
+        return false;
+
+    U32 size = stream->getStreamSize();
+    if (size < HeaderWords * sizeof(U32) || (size & 3))
+    {
+        ResourceManager->closeStream(stream);
+        return false;
+    }
+
+    // the whole file in one read...
+    U8* data = new U8[size];
+    bool ok = stream->read(size, data);
+    ResourceManager->closeStream(stream);
+
+    U32* header = (U32*)data;
+    for (U32 i = 0; i < HeaderWords; i++)
+        header[i] = convertLEndianToHost(header[i]);
+
+    U32 numEntries = header[2];
+    U32 numWords = header[3];
+    U32 numBytes = header[4];
+    U64 fileSize = (HeaderWords + U64(numEntries) * EntryWords + numWords) * sizeof(U32) + numBytes;
+
+    if (!ok || header[0] != FileTag || header[1] != FileVersion || fileSize != size)
+    {
+        delete[] data;
+        return false;
+    }
+
+    U32 tableWords = HeaderWords + numEntries * EntryWords;
+    for (U32 i = HeaderWords; i < tableWords + numWords; i++)
+        header[i] = convertLEndianToHost(header[i]);
+
+    const Entry* entries = (const Entry*)(header + HeaderWords);
+    const U32* words = header + tableWords;
+    const U8* bytes = data + (tableWords + numWords) * sizeof(U32);
+
+    // check every range up front so restoring can trust the data...
+    for (U32 i = 0; i < numEntries; i++)
+    {
+        const Entry& entry = entries[i];
+        ok = U64(entry.vertexStart) + U64(entry.numVerts) * 3 <= numWords &&
+            U64(entry.normalStart) + U64(entry.numFaces) * 3 <= numWords &&
+            U64(entry.emitStart) + entry.emitSize <= numBytes;
+
+        // each emit string is three counted runs, check every count is in
+        // range before it is used to find the next one...
+        U32 pos = entry.emitStart;
+        U32 emitEnd = entry.emitStart + entry.emitSize;
+        for (U32 j = 0; ok && j < entry.numVerts; j++)
+        {
+            ok = pos + 3 <= emitEnd && pos + 3 + bytes[pos] <= emitEnd;
+            if (ok)
+            {
+                U32 edges = pos + 1 + bytes[pos];
+                ok = edges + 2 + bytes[edges] * 2 <= emitEnd;
+                if (ok)
+                {
+                    U32 faces = edges + 1 + bytes[edges] * 2;
+                    pos = faces + 1 + bytes[faces] * 4;
+                    ok = pos <= emitEnd;
+                }
+            }
+        }
+
+        U64 meshPos = entry.meshStart;
+        for (U32 j = 0; ok && j < entry.numMeshes; j++)
+        {
+            ok = meshPos + 3 <= numWords;
+            if (ok)
+            {
+                meshPos += 3 + U64(words[meshPos + 1]) * 4 + words[meshPos + 2];
+                ok = meshPos <= numWords;
+            }
+        }
+
+        if (ok)
+            ok = smIndex.insertUnique(getKey(entry.shapeCRC, entry.detail), i) != smIndex.end();
+
+        if (!ok)
+        {
+            Con::warnf(ConsoleLogEntry::General, "TSCollisionCache: %s is damaged, ignoring it", fileName);
+            smIndex.clear();
+            delete[] data;
+            return false;
+        }
+    }
+
+    smFileData = data;
+    smEntries = entries;
+    smWords = words;
+    smBytes = bytes;
+    smNumEntries = numEntries;
+    return true;
+}
+
+bool TSCollisionCache::save(const char* fileName)
+{
+    Stream* stream;
+    if (!ResourceManager->openFileForWrite(stream, fileName))
+        return false;
+
+    stream->write(U32(FileTag));
+    stream->write(U32(FileVersion));
+    stream->write(U32(smNewEntries.size()));
+    stream->write(U32(smNewWords.size()));
+    stream->write(U32(smNewBytes.size()));
+
+    for (U32 i = 0; i < smNewEntries.size(); i++)
+    {
+        const U32* entry = (const U32*)&smNewEntries[i];
+        for (U32 j = 0; j < EntryWords; j++)
+            stream->write(entry[j]);
+    }
+
+    for (U32 i = 0; i < smNewWords.size(); i++)
+        stream->write(smNewWords[i]);
+    stream->write(smNewBytes.size(), smNewBytes.address());
+
+    bool ok = stream->getStatus() == Stream::Ok;
+    delete stream;
+
+    // open/close the stream to get the fileSize calculated on the resource object
+    ResourceManager->closeStream(ResourceManager->openStream(fileName));
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+
+bool TSCollisionCache::restoreDetail(TSShape* shape, S32 dl)
+{
+    if (!smOpen || dl < 0)
+        return false;
+
+    PROFILE_START(TSCollisionCache_restoreDetail);
+
+    U32 crc = getShapeCRC(shape);
+    HashTable<U64, U32>::Iterator itr = smIndex.find(getKey(crc, dl));
+
+    const TSShape::Detail& detail = shape->details[dl];
+    S32 start = shape->subShapeFirstObject[detail.subShapeNum];
+    S32 end = shape->subShapeNumObjects[detail.subShapeNum] + start;
+    if (crc == InvalidCRC || itr == smIndex.end() || smEntries[itr->value].numMeshes != U32(end - start))
+    {
+        smMisses++;
+        PROFILE_END();
+        return false;
+    }
+
+    const Entry& entry = smEntries[itr->value];
+    U32 i;
+
+    TSShape::ConvexHullAccelerator* accel = new TSShape::ConvexHullAccelerator;
+    accel->numVerts = entry.numVerts;
+    accel->vertexList = new Point3F[entry.numVerts];
+    const U32* words = smWords + entry.vertexStart;
+    for (i = 0; i < entry.numVerts; i++, words += 3)
+        accel->vertexList[i].set(getWordFloat(words[0]), getWordFloat(words[1]), getWordFloat(words[2]));
+
+    // same layout TSShape::computeAccelerator() leaves behind...
+    accel->normalList = new PlaneF[entry.numFaces];
+    words = smWords + entry.normalStart;
+    for (i = 0; i < entry.numFaces; i++, words += 3)
+        accel->normalList[i].set(getWordFloat(words[0]), getWordFloat(words[1]), getWordFloat(words[2]));
+
+    accel->emitStrings = new U8 * [entry.numVerts];
+    const U8* emitString = smBytes + entry.emitStart;
+    for (i = 0; i < entry.numVerts; i++)
+    {
+        U32 len = getEmitStringLength(emitString);
+        accel->emitStrings[i] = new U8[len];
+        dMemcpy(accel->emitStrings[i], emitString, len);
+        emitString += len;
+    }
+
+    shape->detailCollisionAccelerators[dl] = accel;
+
+    // and the hull planes of the detail meshes, unless they are built already
+    words = smWords + entry.meshStart;
+    for (S32 obj = start; obj < end; obj++)
+    {
+        U32 planesPerFrame = words[0];
+        U32 numPlanes = words[1];
+        U32 numMaterials = words[2];
+        words += 3;
+
+        const TSShape::Object& object = shape->objects[obj];
+        TSMesh* mesh = (detail.objectDetailNum < object.numMeshes) ? shape->meshes[object.startMeshIndex + detail.objectDetailNum] : NULL;
+        if (mesh && numPlanes && mesh->planeNormals.empty())
+        {
+            mesh->planesPerFrame = planesPerFrame;
+            mesh->planeNormals.setSize(numPlanes);
+            mesh->planeConstants.setSize(numPlanes);
+            mesh->planeMaterials.setSize(numMaterials);
+            for (i = 0; i < numPlanes; i++)
+                mesh->planeNormals[i].set(getWordFloat(words[i * 3 + 0]), getWordFloat(words[i * 3 + 1]), getWordFloat(words[i * 3 + 2]));
+            for (i = 0; i < numPlanes; i++)
+                mesh->planeConstants[i] = getWordFloat(words[numPlanes * 3 + i]);
+            dMemcpy(mesh->planeMaterials.address(), words + numPlanes * 4, numMaterials * sizeof(U32));
+        }
+        words += numPlanes * 4 + numMaterials;
+    }
+
+    smHits++;
+    PROFILE_END();
+    return true;
+}
+
+void TSCollisionCache::noteDetail(TSShape* shape, S32 dl)
+{
+    if (!smOpen || dl < 0)
+        return;
+
+    U32 crc = getShapeCRC(shape);
+    if (crc == InvalidCRC || smNewIndex.find(getKey(crc, dl)) != smNewIndex.end())
+        return;
+
+    TSShape::ConvexHullAccelerator* accel = shape->detailCollisionAccelerators[dl];
+    AssertFatal(accel != NULL, "TSCollisionCache::noteDetail - detail has no accelerator.");
+
+    PROFILE_START(TSCollisionCache_noteDetail);
+
+    smNewIndex.insertUnique(getKey(crc, dl), smNewEntries.size());
+    smNewEntries.increment();
+    Entry& entry = smNewEntries.last();
+    entry.shapeCRC = crc;
+    entry.detail = dl;
+    entry.numVerts = accel->numVerts;
+
+    S32 i;
+    entry.vertexStart = smNewWords.size();
+    for (i = 0; i < accel->numVerts; i++)
+    {
+        smNewWords.push_back(getFloatWord(accel->vertexList[i].x));
+        smNewWords.push_back(getFloatWord(accel->vertexList[i].y));
+        smNewWords.push_back(getFloatWord(accel->vertexList[i].z));
+    }
+
+    // The accelerator does not keep its face count, but only the faces named
+    // by the emit strings are ever looked at.
+    entry.emitStart = smNewBytes.size();
+    entry.numFaces = 0;
+    for (i = 0; i < accel->numVerts; i++)
+    {
+        const U8* emitString = accel->emitStrings[i];
+        U32 len = getEmitStringLength(emitString);
+        U32 faces = 1 + emitString[0] + 1 + emitString[1 + emitString[0]] * 2;
+        for (U32 j = 0; j < emitString[faces]; j++)
+            entry.numFaces = getMax(entry.numFaces, U32(emitString[faces + 1 + j * 4]) + 1);
+
+        U32 pos = smNewBytes.size();
+        smNewBytes.setSize(pos + len);
+        dMemcpy(smNewBytes.address() + pos, emitString, len);
+    }
+    entry.emitSize = smNewBytes.size() - entry.emitStart;
+
+    entry.normalStart = smNewWords.size();
+    for (i = 0; i < entry.numFaces; i++)
+    {
+        smNewWords.push_back(getFloatWord(accel->normalList[i].x));
+        smNewWords.push_back(getFloatWord(accel->normalList[i].y));
+        smNewWords.push_back(getFloatWord(accel->normalList[i].z));
+    }
+
+    // Hull planes of the detail meshes.  These are otherwise built on the
+    // first ray cast against the mesh, build them now so they get cached.
+    const TSShape::Detail& detail = shape->details[dl];
+    S32 start = shape->subShapeFirstObject[detail.subShapeNum];
+    S32 end = shape->subShapeNumObjects[detail.subShapeNum] + start;
+    entry.numMeshes = end - start;
+    entry.meshStart = smNewWords.size();
+    for (S32 obj = start; obj < end; obj++)
+    {
+        const TSShape::Object& object = shape->objects[obj];
+        TSMesh* mesh = (detail.objectDetailNum < object.numMeshes) ? shape->meshes[object.startMeshIndex + detail.objectDetailNum] : NULL;
+        if (!mesh)
+        {
+            smNewWords.push_back(0);
+            smNewWords.push_back(0);
+            smNewWords.push_back(0);
+            continue;
+        }
+
+        mesh->buildConvexHull();
+
+        smNewWords.push_back(mesh->planesPerFrame);
+        smNewWords.push_back(mesh->planeNormals.size());
+        smNewWords.push_back(mesh->planeMaterials.size());
+        for (i = 0; i < mesh->planeNormals.size(); i++)
+        {
+            smNewWords.push_back(getFloatWord(mesh->planeNormals[i].x));
+            smNewWords.push_back(getFloatWord(mesh->planeNormals[i].y));
+            smNewWords.push_back(getFloatWord(mesh->planeNormals[i].z));
+        }
+        for (i = 0; i < mesh->planeConstants.size(); i++)
+            smNewWords.push_back(getFloatWord(mesh->planeConstants[i]));
+        for (i = 0; i < mesh->planeMaterials.size(); i++)
+            smNewWords.push_back(mesh->planeMaterials[i]);
+    }
+
+    PROFILE_END();
+}
+
+//-----------------------------------------------------------------------------
+
+ConsoleFunction(beginCollisionCache, bool, 2, 2, "(string file)"
+    "Restores cooked shape collision data from the '.mcc' cache file next to a mission or script file "
+    "and starts recording the collision details used while it loads. Returns true if a cache file was loaded.")
+{
+    argc;
+    if (!Con::getBoolVariable("$pref::Server::collisionCache", true))
+        return false;
+
+    return TSCollisionCache::open(argv[1]);
+}
+
+ConsoleFunction(endCollisionCache, void, 1, 1, "()"
+    "Writes out the collision cache started with beginCollisionCache, if it changed.")
+{
+    argc; argv;
+    TSCollisionCache::close();
+}
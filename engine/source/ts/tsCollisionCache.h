@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+// Torque Shader Engine
+// Copyright (C) GarageGames.com, Inc.
+//-----------------------------------------------------------------------------
+
+#ifndef _TSCOLLISIONCACHE_H_
+#define _TSCOLLISIONCACHE_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+#ifndef _TVECTOR_H_
+#include "core/tVector.h"
+#endif
+#ifndef _TDICTIONARY_H_
+#include "core/tDictionary.h"
+#endif
+
+class TSShape;
+
+/// Mission level cache of cooked shape collision data.
+///
+/// Building the convex hull accelerator of a collision detail and the hull
+/// planes of its meshes is the bulk of the collision work done while a mission
+/// loads.  The results only depend on the shape file, so they are stored in a
+/// '.mcc' file next to the mission, or next to the server scripts for the
+/// datablock shapes, keyed by the CRC of the shape resource and the detail
+/// number, and restored on the next load.
+///
+/// The file is read with a single read.  Every offset in it is relative to its
+/// own section, so the sections are used in place once loaded and the file can
+/// be mapped as it is on little endian machines.
+///
+/// The cache is only open while the server datablocks are preloaded, for the
+/// shapes of items, gems, powerups and the other ShapeBase datablocks, and while
+/// the mission objects are created, for TSStatic shapes.  See
+/// beginCollisionCache() and endCollisionCache() in execServerScripts() and
+/// missionLoad.cs.  Only the details used while it was open are written back out.
+class TSCollisionCache
+{
+public:
+    enum Constants
+    {
+        FileTag = 0x3143434D,   ///< 'MCC1'
+        FileVersion = 1
+    };
+
+    /// Loads the '.mcc' cache file next to a mission or script and starts
+    /// recording.
+    static bool open(const char* fileName);
+
+    /// Writes the cache back out if anything changed and releases it.
+    static void close();
+
+    static bool isOpen() { return smOpen; }
+
+    /// Restores the accelerator and mesh hulls of a shape detail from the
+    /// cache.  Returns false if the detail is not in the cache.
+    static bool restoreDetail(TSShape* shape, S32 dl);
+
+    /// Records a shape detail with a computed accelerator for writing out.
+    static void noteDetail(TSShape* shape, S32 dl);
+
+private:
+    /// One cooked collision detail.  Word offsets index the word section,
+    /// the emit strings live in the byte section.
+    struct Entry
+    {
+        U32 shapeCRC;
+        U32 detail;
+        U32 numVerts;       ///< Accelerator vertices, then one emit string per vertex.
+        U32 numFaces;       ///< Accelerator face normals.
+        U32 vertexStart;    ///< numVerts * 3 words.
+        U32 normalStart;    ///< numFaces * 3 words.
+        U32 emitStart;      ///< Byte offset of the emit strings.
+        U32 emitSize;
+        U32 numMeshes;      ///< Meshes in the detail, in object order.
+        U32 meshStart;      ///< Per mesh: planesPerFrame, numPlanes, numMaterials, normals, constants, materials.
+    };
+
+    enum
+    {
+        HeaderWords = 5,
+        EntryWords = sizeof(Entry) / sizeof(U32)
+    };
+
+    static U32 getShapeCRC(TSShape* shape);
+    static U64 getKey(U32 crc, S32 dl) { return (U64(crc) << 32) | U32(dl); }
+    static bool load(const char* fileName);
+    static bool save(const char* fileName);
+
+    static bool smOpen;
+    static bool smDirty;
+    static char smFileName[1024];
+
+    /// The loaded file and its sections.
+    static U8* smFileData;
+    static const Entry* smEntries;
+    static const U32* smWords;
+    static const U8* smBytes;
+    static U32 smNumEntries;
+    static HashTable<U64, U32> smIndex;
+
+    /// What gets written out.
+    static Vector<Entry> smNewEntries;
+    static Vector<U32> smNewWords;
+    static Vector<U8> smNewBytes;
+    static HashTable<U64, U32> smNewIndex;
+
+    static HashTable<TSShape*, U32> smShapeCRCs;
+    static U32 smHits;
+    static U32 smMisses;
+};
+
+#endif // _TSCOLLISIONCACHE_H_
@@ -360,7 +360,7 @@ void TSMesh::render(S32 frame, S32 matFrame, TSMaterialList* materials)
     LightInfoList baselights;
     lm->sgGetBestLights(baselights);
 
-    Vector<bool*> primfirstpass;
+    FrameVector<bool*> primfirstpass;
     for (S32 i = 0; i < primitives.size(); i++)
     {
         primfirstpass.push_back(gRenderInstManager.allocPrimitiveFirstPass());
@@ -5,6 +5,7 @@
 
 #include "ts/tsShape.h"
 #include "ts/tsLastDetail.h"
+#include "ts/tsCollisionCache.h"
 #include "core/stringTable.h"
 #include "console/console.h"
 #include "ts/tsShapeInstance.h"
@@ -1611,10 +1612,14 @@ TSShape::ConvexHullAccelerator* TSShape::getAccelerator(S32 dl)
     if (dl == -1)
         return NULL;
 
-    if (detailCollisionAccelerators[dl] == NULL)
+    if (detailCollisionAccelerators[dl] == NULL && !TSCollisionCache::restoreDetail(this, dl))
         computeAccelerator(dl);
 
     AssertFatal(detailCollisionAccelerators[dl] != NULL, "This should be non-null after computing it!");
+
+    // keep it for the next time this mission loads
+    if (TSCollisionCache::isOpen())
+        TSCollisionCache::noteDetail(this, dl);
     return detailCollisionAccelerators[dl];
 }
 
@@ -74,8 +74,13 @@ function loadMissionStage2()
    // to caching mission lighting.
    $missionCRC = getFileCRC( %file );
 
-   // Exec the mission, objects are added to the ServerGroup
+   // Exec the mission, objects are added to the ServerGroup.  Shape collision
+   // data cooked while the objects are created is cached next to the mission.
+   // This only covers shapes the mission objects load themselves, like
+   // TSStatics; datablock shapes were preloaded with the server scripts.
+   beginCollisionCache( %file );
    exec(%file);
+   endCollisionCache();
    
    // If there was a problem with the load, let's try another mission
    if( !isObject(MissionGroup) ) {
@@ -685,7 +685,7 @@ function EditorMenuBar::onEditMenuItemSelect(%this, %itemId, %item)
       ModelImporterSettingsDlg.onWake();
       Canvas.pushDialog(ModelImporterSettingsDlg, 99);
    } else if(%item $= "Relight Scene")
-      lightScene("", forceAlways);
+      lightScene("", forceStale);
    else if(EWorldEditor.isVisible())
    {
       // edit commands for world editor...
@@ -770,7 +770,7 @@ function EditorGui::toggleSGTools(%this, %item)
       case $sgEditorItemNames::sgMenuItem[2]:
          sgLightEditor.filteredRelight();
       case $sgEditorItemNames::sgMenuItem[3]:
-         lightScene("", forceAlways);
+         lightScene("", forceStale);
    }
 }
 
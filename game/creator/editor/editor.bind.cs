@@ -13,7 +13,7 @@ EditorMap.bindCmd(keyboard, "f4", "editor.setEditor(Terraformer);", "");
 EditorMap.bindCmd(keyboard, "f5", "editor.setEditor(AIEditor);", "");   
 
 EditorMap.bindCmd(keyboard, "alt s", "Canvas.pushDialog(EditorSaveMissionDlg);", "");
-EditorMap.bindCmd(keyboard, "alt r", "lightScene(\"\", forceAlways);", "");
+EditorMap.bindCmd(keyboard, "alt r", "lightScene(\"\", forceStale);", "");
 EditorMap.bindCmd(keyboard, "escape", "editor.close();", "");
 
 // alt-#: set bookmark
@@ -541,6 +541,14 @@ function continueStartup()
    // does not modify the list.
    nextToken($userMods, currentMod, ";");
 
+   // Compile the scripts of every mod up front on all cores.  The index
+   // keeps their CRCs and code, so later runs only compile what changed.
+   echo("--------- Compiling Scripts ---------");
+   loadCompiledScripts("scriptIndex.dat");
+   if (precompileScripts("*.cs") + precompileScripts("*.gui") > 0)
+      saveCompiledScripts("scriptIndex.dat");
+   echo("");
+
    echo("--------- Loading MODS ---------");
    loadMods($userMods);
    echo("");
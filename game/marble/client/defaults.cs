@@ -12,6 +12,7 @@ $pref::Player::Name = "Alex";
 $pref::Player::defaultFov = 90;
 $pref::Player::zoomSpeed = 0;
 $pref::Net::LagThreshold = 400;
+$pref::Net::DataBlockCachePath = "marble/client/cache";
 $pref::shadows = "2";
 $pref::HudMessageLogSize = 40;
 $pref::ChatHudLength = 1;
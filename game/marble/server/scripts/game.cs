@@ -50,6 +50,10 @@ function execServerScripts()
    // game commands (lobby, ready status, and stuff)
    exec("./gameCommands.cs");
    
+   // Shape datablocks cook their collision details when they are preloaded,
+   // so cache them here, the mission load only sees the mission objects.
+   beginCollisionCache(expandFilename("./datablocks"));
+
    // Load up all datablocks, objects etc.  
    exec("./audioProfiles.cs");
    exec("./camera.cs");
@@ -79,6 +83,8 @@ function execServerScripts()
    // Easter Eggs
    exec("./easter.cs");
 
+   endCollisionCache();
+
   // Tim Particles & Environment
   //exec("./particle_effects.cs");
   //exec("./environment.cs");